@@ -114,6 +114,26 @@ macro(import_imgui)
     endif()
 endmacro()
 
+# Macro to import stb (header-only; stb_image for texture decoding)
+macro(import_stb)
+    if(NOT TARGET stb)
+        message(STATUS "Importing stb...")
+        # stb has no release tags; pinned to a master commit (stb_image 2.28).
+        # Not shallow: a shallow clone cannot check out an arbitrary commit.
+        FetchContent_Declare(
+            stb
+            GIT_REPOSITORY https://github.com/nothings/stb.git
+            GIT_TAG 5736b15f7ea0ffb08dd38af21067c314d6a3aae9
+        )
+        FetchContent_Populate(stb)
+
+        add_library(stb INTERFACE)
+        target_include_directories(stb INTERFACE ${stb_SOURCE_DIR})
+
+        message(STATUS "stb imported successfully")
+    endif()
+endmacro()
+
 # Main function to import all dependencies
 function(importDependencies)
     message(STATUS "=== Importing Dependencies ===")
@@ -123,6 +143,7 @@ function(importDependencies)
     import_glm() 
     import_glew()
     import_imgui()
+    import_stb()
     
     message(STATUS "=== All Dependencies Imported ===")
 endfunction()
\ No newline at end of file
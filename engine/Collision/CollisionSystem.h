@@ -17,6 +17,7 @@ namespace Framework {
     void Initialize() override;
     void Update(float dt) override;
     void SendEngineMessage(Message* message) override;
+    const char* GetName() const override { return "Collision"; }
 
     void SetInput(InputSystem* input) { m_input = input; }
   private:
@@ -3,9 +3,12 @@
 
 #include "DebugComponents/PerfViewer.h"
 #include "DebugComponents/Trace.h"
+#include "DebugComponents/HwCounters.h"
 #include "DebugComponents/Perf.h"
 #include "DebugComponents/Log.h"
 #include "DebugComponents/CrashLogger.h"
+#include "DebugComponents/Telemetry.h"
+#include "DebugComponents/Watchdog.h"
 
 namespace Framework
 {
@@ -93,19 +96,18 @@ namespace Framework
             float dt = (currenttime - LastTime) / 1000.0f;
             LastTime = currenttime;
 
+            // --- hang detection: this frame started ---
+            eng::debug::Watchdog::heartbeat();
+
             // --- begin perf frame ---
             eng::debug::PerfViewer::begin_frame();
 
             // --- per-system updates with scoped timers ---
+            // Each system is attributed to the category registered for it in AddSystem().
+            // DBG_SCOPE_HW also samples hardware counters when HwCounters are enabled.
             for (unsigned i = 0; i < Systems.size(); ++i)
             {
-                // Tag systems (adjust to your actual system types/order)
-                eng::debug::Subsystem tag =
-                    (i == 0) ? eng::debug::Subsystem::Graphics :
-                    (i == 1) ? eng::debug::Subsystem::Gameplay :
-                    eng::debug::Subsystem::Other;
-
-                DBG_SCOPE_SYS("SystemUpdate", tag);
+                DBG_SCOPE_HW("SystemUpdate", SystemCategories[i]);
                 Systems[i]->Update(dt);
             }
 
@@ -114,6 +116,7 @@ namespace Framework
 
             // --- FPS (uses your dt directly; logs once/sec) ---
             fps.tick_with_dt(static_cast<double>(dt));
+            eng::debug::Telemetry::set_fps(fps.smoothed_fps());
 
             // --- CSV export when F2 is pressed (edge-triggered) ---
             // 0x0001 bit = key transitioned from up to down since last call.
@@ -127,6 +130,9 @@ namespace Framework
             }
 
         }
+
+        // Shutdown is allowed to take as long as it takes.
+        eng::debug::Watchdog::suspend();
     }
 
     void CoreEngine::BroadcastMessage(Message* message)
@@ -143,6 +149,9 @@ namespace Framework
     void CoreEngine::AddSystem(InterfaceSystem* system)
     {
         Systems.push_back(system);
+
+        // Register the system's own name as its profiling category
+        SystemCategories.push_back(eng::debug::PerfViewer::register_category(system->GetName()));
     }
 
     void CoreEngine::DestroySystems()
@@ -153,5 +162,6 @@ namespace Framework
             delete Systems[Systems.size() - i - 1];
         }
         Systems.clear();
+        SystemCategories.clear();
     }
 }
\ No newline at end of file
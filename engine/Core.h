@@ -2,6 +2,7 @@
 #include "Precompiled.h"
 #include "Interface.h"
 #include "Message.h"
+#include "DebugComponents/Trace.h"
 
 namespace Framework
 {
@@ -26,6 +27,9 @@ namespace Framework
         // Systems collection
         std::vector<InterfaceSystem*> Systems;
 
+        // Profiling category of each system (parallel to Systems)
+        std::vector<eng::debug::CategoryId> SystemCategories;
+
         // Timing
         unsigned LastTime;
 
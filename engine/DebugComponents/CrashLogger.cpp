@@ -1,5 +1,7 @@
 #include "DebugComponents/CrashLogger.h"
+#include "DebugComponents/CrashSnapshot.h"
 #include "DebugComponents/Log.h"
+#include "DebugComponents/Sinks.h"
 
 #include <cstdio>
 #include <exception>
@@ -13,6 +15,22 @@
 #include <windows.h>
 #include <dbghelp.h>
 #pragma comment(lib, "dbghelp.lib") // link dbghelp automatically
+#else
+#include <atomic>
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <ctime>
+#include <fcntl.h>
+#include <pthread.h>
+#include <ucontext.h>
+#include <unistd.h>
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ENG_HAS_BACKTRACE 1
+#else
+#define ENG_HAS_BACKTRACE 0
+#endif
 #endif
 
 
@@ -29,6 +47,8 @@
    - When a crash occurs:
        * Build a filename crash_YYYYMMDD_HHMMSS.txt in exe directory.
        * Write details (title, reason, optional stack trace).
+       * Append the last N lines of the log ring (RingFileSink), if any.
+       * Write crash_YYYYMMDD_HHMMSS.snap beside it (CrashSnapshot).
        * Mirror one concise log line ("Crash report written: <path>").
    - force_crash_for_test() deliberately crashes so developers can test the
      logging behavior.
@@ -36,7 +56,19 @@
  Platform notes:
    - On Windows we use DbgHelp APIs (SymFromAddr, SymGetLineFromAddr64)
      to resolve addresses to function names and file:line if symbols are loaded.
-   - On other platforms only very basic info is available.
+   - On POSIX, fatal signals (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT) are
+     caught with sigaction on an alternate stack (sigaltstack), so even a
+     stack overflow can be reported. The handler only uses async-signal-safe
+     calls (open/read/write/close) and a report buffer reserved up front; no
+     malloc, stdio or locks. It records raw return addresses (backtrace(),
+     warmed up at install time) plus /proc/self/maps, and
+     tools/crash_symbolize turns those into function + file:line offline.
+     Signal reports are named with UTC time (localtime is not signal-safe).
+     One report per process: a thread that faults while another writes it
+     blocks until that one re-raises and ends the process.
+   - The alternate stack is installed for the thread that calls
+     install_handlers() (the main thread). Faults on other threads are still
+     reported, but a stack overflow there cannot be.
 
  Safety:
    - Functions are noexcept where practical to ensure that even during a crash,
@@ -46,6 +78,9 @@
 
 namespace eng::debug {
 
+    // Number of ring lines appended to a report (see set_log_tail_lines).
+    static std::size_t s_tailLines_ = 50;
+
     // Helper: return directory of the running executable.
     static std::string exe_dir_() {
     #if defined(_WIN32)
@@ -55,7 +90,22 @@ namespace eng::debug {
         const size_t pos = s.find_last_of("\\/");
         return (pos == std::string::npos) ? std::string(".") : s.substr(0, pos);
     #else
-        return ".";
+        char path[PATH_MAX]{};
+        const ssize_t n = ::readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if (n <= 0) return ".";
+        std::string s(path, static_cast<size_t>(n));
+        const size_t pos = s.find_last_of('/');
+        return (pos == std::string::npos) ? std::string(".") : s.substr(0, pos);
+    #endif
+    }
+
+    // fopen_s is MSVC-only; plain fopen elsewhere.
+    static std::FILE* open_report_(const std::string& path) {
+    #if defined(_WIN32)
+        std::FILE* fp = nullptr;
+        return (fopen_s(&fp, path.c_str(), "w") == 0) ? fp : nullptr;
+    #else
+        return std::fopen(path.c_str(), "w");
     #endif
     }
 
@@ -135,6 +185,247 @@ namespace eng::debug {
     }
     #endif // _WIN32
 
+    #if !defined(_WIN32)
+    // -------------------------------------------------------------------------
+    // POSIX fatal-signal path. Everything here may run inside a signal
+    // handler, so it only touches memory reserved at install time and only
+    // calls async-signal-safe functions.
+    // -------------------------------------------------------------------------
+    namespace {
+
+        // Fixed buffer the report is assembled in before one write().
+        struct SafeReport {
+            static constexpr size_t kCapacity = 128 * 1024;
+            char   data[kCapacity];
+            size_t len = 0;
+
+            void put(const char* s, size_t n) {
+                for (size_t i = 0; i < n && len < kCapacity; ++i) data[len++] = s[i];
+            }
+            void put(const char* s) { while (s && *s && len < kCapacity) data[len++] = *s++; }
+            void dec(long long v) {
+                char tmp[24];
+                int i = 0;
+                const bool neg = v < 0;
+                unsigned long long u = neg ? 0ull - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v);
+                do { tmp[i++] = static_cast<char>('0' + u % 10); u /= 10; } while (u);
+                if (neg) tmp[i++] = '-';
+                while (i) put(&tmp[--i], 1);
+            }
+            void hex(std::uintptr_t v) {
+                static constexpr char kHex[] = "0123456789abcdef";
+                char tmp[2 * sizeof(v)];
+                int i = 0;
+                do { tmp[i++] = kHex[v & 0xF]; v >>= 4; } while (v);
+                put("0x");
+                while (i) put(&tmp[--i], 1);
+            }
+        };
+
+        SafeReport        s_report;
+        char              s_reportDir[PATH_MAX] = ".";
+        std::atomic<int>  s_inCrash{ 0 };   // set once a report was written
+        std::atomic<pthread_t> s_crashThread{};   // thread writing that report
+        alignas(16) char  s_altStack[64 * 1024];
+
+        const char* signal_name(int sig) {
+            switch (sig) {
+            case SIGSEGV: return "SIGSEGV";
+            case SIGBUS:  return "SIGBUS";
+            case SIGFPE:  return "SIGFPE";
+            case SIGILL:  return "SIGILL";
+            case SIGABRT: return "SIGABRT";
+            default:      return "SIGNAL";
+            }
+        }
+
+        // "YYYYMMDD_HHMMSS" (UTC) from clock_gettime; days-to-date is the
+        // usual civil-from-days conversion, since gmtime is not signal-safe.
+        void utc_stamp(char out[16]) {
+            timespec ts{};
+            ::clock_gettime(CLOCK_REALTIME, &ts);
+            long long secs = ts.tv_sec;
+            const long long days = secs / 86400;
+            long long rem = secs % 86400;
+
+            long long z = days + 719468;
+            const long long era = z / 146097;
+            const long long doe = z - era * 146097;
+            const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const long long mp = (5 * doy + 2) / 153;
+            const int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+            const int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+            const int y = static_cast<int>(yoe + era * 400 + (m <= 2));
+
+            const int parts[6] = { y, m, d, static_cast<int>(rem / 3600), static_cast<int>(rem / 60 % 60), static_cast<int>(rem % 60) };
+            const int widths[6] = { 4, 2, 2, 2, 2, 2 };
+            int o = 0;
+            for (int p = 0; p < 6; ++p) {
+                if (p == 3) out[o++] = '_';
+                for (int w = widths[p] - 1, v = parts[p]; w >= 0; --w, v /= 10) out[o + w] = static_cast<char>('0' + v % 10);
+                o += widths[p];
+            }
+            out[o] = '\0';
+        }
+
+        // Program counter at the time of the fault, from the signal context.
+        std::uintptr_t context_pc(void* uctx) {
+            if (!uctx) return 0;
+            const ucontext_t* uc = static_cast<const ucontext_t*>(uctx);
+        #if defined(__linux__) && defined(__x86_64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+        #elif defined(__linux__) && defined(__aarch64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+        #elif defined(__APPLE__) && defined(__x86_64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__rip);
+        #elif defined(__APPLE__) && defined(__aarch64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__pc);
+        #else
+            (void)uc;
+            return 0;
+        #endif
+        }
+
+        // "  [i] 0x..." per frame: the format tools/crash_symbolize reads.
+        void append_raw_stack(SafeReport& r, int skip) {
+            r.put("Stack (raw):\n");
+        #if ENG_HAS_BACKTRACE
+            void* frames[64];
+            const int n = ::backtrace(frames, 64);
+            for (int i = skip; i < n; ++i) {
+                r.put("  [");
+                r.dec(i - skip);
+                r.put("] ");
+                r.hex(reinterpret_cast<std::uintptr_t>(frames[i]));
+                r.put("\n");
+            }
+        #else
+            (void)skip;
+            r.put("  (backtrace not available on this platform)\n");
+        #endif
+        }
+
+        // Load addresses of every module, needed to symbolize offline.
+        void append_maps(SafeReport& r) {
+            r.put("\nMemory map:\n");
+            const int fd = ::open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+            if (fd < 0) { r.put("  (unavailable)\n"); return; }
+            char chunk[4096];
+            ssize_t n;
+            while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) r.put(chunk, static_cast<size_t>(n));
+            ::close(fd);
+        }
+
+        void append_log_tail(SafeReport& r) {
+            const RingFileSink* ring = RingFileSink::current();
+            if (!ring || s_tailLines_ == 0) return;
+            static char tail[32 * 1024];
+            r.put("\nLast log lines (up to ");
+            r.dec(static_cast<long long>(s_tailLines_));
+            r.put("):\n--------------------------------------------------\n");
+            r.put(tail, ring->copy_tail(tail, sizeof(tail), s_tailLines_));
+        }
+
+        void write_all(int fd, const char* p, size_t n) {
+            while (n > 0) {
+                const ssize_t w = ::write(fd, p, n);
+                if (w <= 0) return;
+                p += w;
+                n -= static_cast<size_t>(w);
+            }
+        }
+
+        // Signal handler for fatal signals (runs on s_altStack).
+        void on_fatal_signal(int sig, siginfo_t* si, void* uctx) {
+            if (s_inCrash.exchange(1) != 0) {
+                // A second fault while reporting, or abort() after the
+                // terminate handler already wrote a report: just die with
+                // the default action.
+                if (pthread_equal(s_crashThread.load(), pthread_self())) {
+                    ::signal(sig, SIG_DFL);
+                    ::raise(sig);
+                    return;
+                }
+                // Another thread is reporting; dying here would cut its
+                // report short. It ends the process once it is done.
+                for (;;) ::pause();
+            }
+            s_crashThread.store(pthread_self());
+
+            SafeReport& r = s_report;
+            r.len = 0;
+            r.put("Fatal signal\n--------------------------------------------------\n");
+            r.put("Signal: ");
+            r.put(signal_name(sig));
+            r.put(" (");
+            r.dec(sig);
+            r.put("), code ");
+            r.dec(si ? si->si_code : 0);
+            r.put("\n");
+            if (si && sig != SIGABRT) {
+                r.put("Fault address: ");
+                r.hex(reinterpret_cast<std::uintptr_t>(si->si_addr));
+                r.put("\n");
+            }
+            if (const std::uintptr_t pc = context_pc(uctx)) {
+                r.put("PC: ");
+                r.hex(pc);
+                r.put("\n");
+            }
+            append_raw_stack(r, 1);   // skip this handler's own frame
+            append_log_tail(r);
+            append_maps(r);
+
+            // crash_<UTC stamp>.txt next to the executable.
+            char stamp[16];
+            utc_stamp(stamp);
+            char path[PATH_MAX + 32];
+            size_t plen = 0;
+            for (const char* part : { static_cast<const char*>(s_reportDir), "/crash_", static_cast<const char*>(stamp), ".txt" }) {
+                while (*part && plen + 1 < sizeof(path)) path[plen++] = *part++;
+            }
+            path[plen] = '\0';
+
+            const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd >= 0) {
+                write_all(fd, r.data, r.len);
+                ::close(fd);
+            }
+            static const char kMsg[] = "[CRASH] Fatal signal, report written: ";
+            write_all(STDERR_FILENO, kMsg, sizeof(kMsg) - 1);
+            write_all(STDERR_FILENO, path, plen);
+            write_all(STDERR_FILENO, "\n", 1);
+
+            // Same name with .snap: binary snapshot (registers, stack, perf).
+            if (plen >= 4 && plen + 2 < sizeof(path)) {
+                path[plen - 3] = 's'; path[plen - 2] = 'n'; path[plen - 1] = 'a'; path[plen] = 'p'; path[plen + 1] = '\0';
+                CrashContext ctx;
+                ctx.reason = signal_name(sig);
+                ctx.signal = sig;
+                ctx.code = si ? static_cast<std::uint64_t>(si->si_code) : 0;
+                ctx.faultAddr = (si && sig != SIGABRT) ? reinterpret_cast<std::uintptr_t>(si->si_addr) : 0;
+                ctx.platformContext = uctx;
+                CrashSnapshot::write(path, ctx);
+            }
+
+            // Back to the default action and re-raise, so the exit status
+            // (and core dump, if enabled) look like a normal crash.
+            ::signal(sig, SIG_DFL);
+            ::raise(sig);
+        }
+
+    } // namespace
+
+    // Raw stack for the terminate path (normal context, so allocation is
+    // fine). Borrows the signal report buffer; no signal report is running yet.
+    static std::string capture_stack_raw_() {
+        s_report.len = 0;
+        append_raw_stack(s_report, 1);
+        return std::string(s_report.data, s_report.len);
+    }
+    #endif // !_WIN32
+
     // -------------------------------------------------------------------------
     // CrashLogger API
     // -------------------------------------------------------------------------
@@ -147,30 +438,83 @@ namespace eng::debug {
 
         // Register our SEH filter.
         SetUnhandledExceptionFilter(reinterpret_cast<LPTOP_LEVEL_EXCEPTION_FILTER>(seh_filter_));
+    #else
+        // Resolve everything that is not signal-safe now, while we still can.
+        const std::string dir = exe_dir_();
+        std::snprintf(s_reportDir, sizeof(s_reportDir), "%s", dir.c_str());
+    #if ENG_HAS_BACKTRACE
+        void* warm[4];
+        ::backtrace(warm, 4);   // first call loads the unwinder (may allocate)
+    #endif
+
+        // Alternate stack, so a stack overflow can still run the handler.
+        stack_t ss{};
+        ss.ss_sp = s_altStack;
+        ss.ss_size = sizeof(s_altStack);
+        ss.ss_flags = 0;
+        ::sigaltstack(&ss, nullptr);
+
+        struct sigaction sa {};
+        sa.sa_sigaction = on_fatal_signal;
+        sigemptyset(&sa.sa_mask);
+        // No SA_RESETHAND: a fault on another thread while the report is
+        // being written must reach the handler (and wait), not kill the
+        // process with the default action
+        sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        for (const int sig : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT }) ::sigaction(sig, &sa, nullptr);
     #endif
         // Register terminate handler for unhandled C++ exceptions.
         std::set_terminate(terminate_handler_);
         Log::write(LogLevel::Info, "CRASH", "", 0, "CrashLogger installed.");
     }
 
+    void CrashLogger::set_log_tail_lines(std::size_t lines) { s_tailLines_ = lines; }
+
     void CrashLogger::force_crash_for_test() {
         int* p = nullptr;
         *p = 42;
 
     }
 
-    // Deliberately write to a null pointer to trigger access violation.
-    void CrashLogger::write_report_(const char* title, const char* detail) {
-        const std::string filename = std::string("crash_") + timestamp_() + ".txt";
-        const std::string fullpath = exe_dir_() + "/" + filename;
+    std::string CrashLogger::report_path(const char* kind) {
+        return exe_dir_() + "/" + kind + "_" + timestamp_() + ".txt";
+    }
+
+    void CrashLogger::append_report_tail(std::FILE* fp) {
+        // Recent log lines straight from the mapped ring: no Log mutex,
+        // no allocation, and nothing lost to file buffering.
+        const RingFileSink* ring = RingFileSink::current();
+        if (ring && s_tailLines_ > 0) {
+            static char tail[32 * 1024];
+            const std::size_t n = ring->copy_tail(tail, sizeof(tail), s_tailLines_);
+            std::fprintf(fp, "\nLast log lines (up to %zu):\n", s_tailLines_);
+            std::fprintf(fp, "--------------------------------------------------\n");
+            std::fwrite(tail, 1, n, fp);
+        }
+    #if !defined(_WIN32)
+        // Module load addresses for tools/crash_symbolize.
+        if (std::FILE* maps = std::fopen("/proc/self/maps", "r")) {
+            std::fprintf(fp, "\nMemory map:\n");
+            char chunk[4096];
+            size_t n;
+            while ((n = std::fread(chunk, 1, sizeof(chunk), maps)) > 0) std::fwrite(chunk, 1, n, fp);
+            std::fclose(maps);
+        }
+    #endif
+    }
+
+    void CrashLogger::write_report_(const char* title, const char* detail, const CrashContext& ctx) {
+        const std::string fullpath = report_path("crash");
 
-        if (std::FILE* fp = nullptr; fopen_s(&fp, fullpath.c_str(), "w") == 0 && fp) {
+        if (std::FILE* fp = open_report_(fullpath)) {
             std::fprintf(fp, "%s\n", title ? title : "Crash");
             std::fprintf(fp, "--------------------------------------------------\n");
             std::fprintf(fp, "%s\n", detail ? detail : "(no details)");
+            append_report_tail(fp);
             std::fclose(fp);
         }
-
+        const std::string snapPath = fullpath.substr(0, fullpath.size() - 4) + ".snap";
+        CrashSnapshot::write(snapPath.c_str(), ctx);
 
         // Mirror one concise line into our logging system.
         Log::write(LogLevel::Error, "CRASH", "", 0, std::string("Crash report written: ") + fullpath);
@@ -194,14 +538,22 @@ namespace eng::debug {
 
     #if defined(_WIN32)
         d << "Stack:\n" << capture_stack_(0);
+    #else
+        d << capture_stack_raw_();
     #endif
 
-        write_report_("C++ terminate", d.str().c_str());
+        CrashContext ctx;
+        ctx.reason = "C++ terminate";
+        write_report_("C++ terminate", d.str().c_str(), ctx);
+    #if !defined(_WIN32)
+        // The SIGABRT from abort() must not write a second report
+        if (s_inCrash.exchange(1) == 0) s_crashThread.store(pthread_self());
+    #endif
         std::abort();
     }
 
+    #if defined(_WIN32)
     long __stdcall CrashLogger::seh_filter_(_EXCEPTION_POINTERS* info) {
-#if defined(_WIN32)
         unsigned long code = info && info->ExceptionRecord ? info->ExceptionRecord->ExceptionCode : 0UL;
         void* faultAddr = info && info->ExceptionRecord ? info->ExceptionRecord->ExceptionAddress : nullptr;
 
@@ -216,13 +568,15 @@ namespace eng::debug {
 
         d << "Stack:\n" << capture_stack_(0);
 
-        write_report_("SEH Exception", d.str().c_str());
+        CrashContext ctx;
+        ctx.reason = "SEH exception";
+        ctx.code = code;
+        ctx.faultAddr = reinterpret_cast<std::uintptr_t>(faultAddr);
+        ctx.platformContext = info ? info->ContextRecord : nullptr;
+        write_report_("SEH Exception", d.str().c_str(), ctx);
         return EXCEPTION_EXECUTE_HANDLER;
-    #else
-        write_report_("SEH Exception", "SEH not supported on this platform.");
-        return 1;
-    #endif
     }
+    #endif
 
     std::string CrashLogger::seh_code_to_string_(unsigned long code) {
     #if defined(_WIN32)
@@ -233,6 +587,7 @@ namespace eng::debug {
         default: return "UNKNOWN_EXCEPTION";
         }
     #else
+        (void)code;
         return "UNKNOWN_EXCEPTION";
     #endif
     }
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdio>
 #include <string>
 
 /*
@@ -6,10 +8,12 @@
  CrashLogger.h
  ------------------------------------------------------------------------------
  Purpose
-   Provides a global crash logging facility for Windows (and partially portable).
+   Provides a global crash logging facility for Windows and POSIX (Linux).
    It installs handlers for:
 	 - std::terminate (C++ unhandled exceptions)
 	 - SEH (Structured Exception Handling, e.g. access violations on Windows)
+	 - fatal signals on POSIX (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT),
+	   handled on an alternate stack with async-signal-safe code only
 
    When a crash occurs, it writes a text report to:
 	   crash_YYYYMMDD_HHMMSS.txt
@@ -26,21 +30,46 @@
  Key features:
    - Reports crash reason and code (if SEH).
    - Captures a call stack (with file:line info if PDB symbols are available).
+	 On POSIX the report holds raw addresses plus the memory map; run
+	   crash_symbolize crash_YYYYMMDD_HHMMSS.txt
+	 to get function names and file:line (uses addr2line).
    - Guarantees a file is written before process termination.
+   - Appends the last log lines from the memory-mapped log ring
+	 (RingFileSink), so the report shows what led up to the crash even when
+	 the normal log file was still buffered.
+   - Writes a binary snapshot crash_YYYYMMDD_HHMMSS.snap next to the report
+	 (recent perf frames, log tail, registers and stack; see CrashSnapshot.h).
 ===============================================================================
 */
 
 namespace eng::debug {
+	struct CrashContext;
+
 	class CrashLogger {
 	public:
-		// Install the terminate handler and SEH filter (Windows only).
+		// Install the terminate handler, plus the SEH filter (Windows) or the
+		// fatal signal handlers and alternate stack (POSIX). Call from the
+		// main thread after Log::init().
 		static void install_handlers();
 
 		// Force a crash for testing (currently writes through a null pointer).
 		static void force_crash_for_test();
+
+		// How many of the most recent log lines go into a report (default 50,
+		// 0 = none). Lines come from RingFileSink::current(), if one exists.
+		static void set_log_tail_lines(std::size_t lines);
+
+		// "<exe dir>/<kind>_YYYYMMDD_HHMMSS.txt": where crash (and hang, see
+		// Watchdog) reports go. Not signal-safe.
+		static std::string report_path(const char* kind);
+
+		// Append the last log lines (up to set_log_tail_lines) and, on POSIX,
+		// the memory map to an open report, in the layout crash_symbolize reads.
+		static void append_report_tail(std::FILE* fp);
 	private:
-		// Internal helper: write a crash report file and mirror a log line.
-		static void write_report_(const char* title, const char* detail);
+		// Internal helper: write a crash report file plus its .snap snapshot
+		// (see CrashSnapshot.h) and mirror a log line.
+		static void write_report_(const char* title, const char* detail, const CrashContext& ctx);
 
 		// Build a timestamp string: "YYYYMMDD_HHMMSS".
 		static std::string timestamp_();
@@ -49,8 +78,10 @@ namespace eng::debug {
 		// unhandled exceptions or failed noexcept.
 		static void terminate_handler_();
 
+	#if defined(_WIN32)
 		// Windows SEH filter: catches access violations, divide-by-zero, etc.
 		static long __stdcall seh_filter_(struct _EXCEPTION_POINTERS* info);
+	#endif
 
 		// Translate common SEH exception codes to a short string.
 		static std::string seh_code_to_string_(unsigned long code);
@@ -0,0 +1,422 @@
+#include "DebugComponents/CrashSnapshot.h"
+#include "DebugComponents/PerfViewer.h"
+#include "DebugComponents/Sinks.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <tlhelp32.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <ucontext.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+/*
+===============================================================================
+ CrashSnapshot.cpp
+ ------------------------------------------------------------------------------
+ Implementation of CrashSnapshot (format described in CrashSnapshot.h).
+
+ Every record is written as: header with a placeholder size, payload
+ streamed straight to the file, then the real size patched in with a seek.
+ That way variable-length data (stack, /proc files) never needs a buffer
+ large enough to hold all of it. Buffers that are needed are static, so
+ nothing is allocated while the process is crashing.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+    namespace {
+
+        constexpr std::size_t kMaxCategories = 64;
+
+        // Scratch space, reserved up front (signal handlers cannot allocate).
+        TscClock::ticks s_perfRows[CrashSnapshot::kPerfFrames * (kMaxCategories + 1)];
+        char            s_logTail[64 * 1024];
+        char            s_text[4096];
+
+        // ---------------------------------------------------------------------
+        // Raw file access: write/lseek or WriteFile/SetFilePointerEx.
+        // ---------------------------------------------------------------------
+    #if defined(_WIN32)
+        using FileHandle = HANDLE;
+        const FileHandle kNoFile = INVALID_HANDLE_VALUE;
+
+        FileHandle file_create(const char* path) {
+            return ::CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        }
+        bool file_write(FileHandle f, const void* p, std::size_t n) {
+            DWORD w = 0;
+            return ::WriteFile(f, p, static_cast<DWORD>(n), &w, nullptr) && w == n;
+        }
+        std::uint64_t file_tell(FileHandle f) {
+            LARGE_INTEGER zero{}, pos{};
+            ::SetFilePointerEx(f, zero, &pos, FILE_CURRENT);
+            return static_cast<std::uint64_t>(pos.QuadPart);
+        }
+        void file_seek(FileHandle f, std::uint64_t at) {
+            LARGE_INTEGER pos{};
+            pos.QuadPart = static_cast<LONGLONG>(at);
+            ::SetFilePointerEx(f, pos, nullptr, FILE_BEGIN);
+        }
+        void file_close(FileHandle f) { ::CloseHandle(f); }
+    #else
+        using FileHandle = int;
+        constexpr FileHandle kNoFile = -1;
+
+        FileHandle file_create(const char* path) {
+            return ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        }
+        bool file_write(FileHandle f, const void* p, std::size_t n) {
+            const char* c = static_cast<const char*>(p);
+            while (n > 0) {
+                const ssize_t w = ::write(f, c, n);
+                if (w <= 0) return false;
+                c += w;
+                n -= static_cast<std::size_t>(w);
+            }
+            return true;
+        }
+        std::uint64_t file_tell(FileHandle f) { return static_cast<std::uint64_t>(::lseek(f, 0, SEEK_CUR)); }
+        void file_seek(FileHandle f, std::uint64_t at) { ::lseek(f, static_cast<off_t>(at), SEEK_SET); }
+        void file_close(FileHandle f) { ::close(f); }
+    #endif
+
+        // Streams records into the snapshot file.
+        struct SnapWriter {
+            FileHandle    file = kNoFile;
+            std::uint64_t recordAt = 0;     // offset of the open record's header
+            std::uint32_t bytes = 0;        // payload written to the open record
+
+            void begin(SnapRecord type) {
+                recordAt = file_tell(file);
+                bytes = 0;
+                const SnapRecordHeader h{ static_cast<std::uint32_t>(type), 0 };
+                file_write(file, &h, sizeof(h));
+            }
+            void put(const void* p, std::size_t n) {
+                if (n && file_write(file, p, n)) bytes += static_cast<std::uint32_t>(n);
+            }
+            void put_str(const char* s) { put(s, std::strlen(s)); }
+            void put_u64(std::uint64_t v) {
+                // Decimal text, for the text records.
+                char tmp[24];
+                int i = 0;
+                do { tmp[i++] = static_cast<char>('0' + v % 10); v /= 10; } while (v);
+                char out[24];
+                for (int k = 0; k < i; ++k) out[k] = tmp[i - 1 - k];
+                put(out, static_cast<std::size_t>(i));
+            }
+            void end() {
+                static const char kZero[8] = {};
+                const std::uint64_t endAt = file_tell(file);
+                file_seek(file, recordAt + offsetof(SnapRecordHeader, bytes));
+                file_write(file, &bytes, sizeof(bytes));
+                file_seek(file, endAt);
+                file_write(file, kZero, (8 - bytes % 8) % 8);
+            }
+        };
+
+        // ---------------------------------------------------------------------
+        // Platform details: thread id, registers, stack copy, thread/module list.
+        // ---------------------------------------------------------------------
+        std::uint64_t current_tid() {
+        #if defined(_WIN32)
+            return ::GetCurrentThreadId();
+        #elif defined(__linux__)
+            return static_cast<std::uint64_t>(::syscall(SYS_gettid));
+        #else
+            return 0;
+        #endif
+        }
+
+        constexpr SnapArch build_arch() {
+        #if defined(__x86_64__) || defined(_M_X64)
+            return SnapArch::X86_64;
+        #elif defined(__aarch64__) || defined(_M_ARM64)
+            return SnapArch::Arm64;
+        #else
+            return SnapArch::Unknown;
+        #endif
+        }
+
+        // Canonical register order (see SnapArch); returns the count, 0 if the
+        // context is unavailable or the platform is not handled.
+        std::uint32_t read_registers(void* ctx, std::uint64_t regs[40], std::uint64_t& sp) {
+            if (!ctx) return 0;
+        #if defined(_WIN32) && defined(_M_X64)
+            const CONTEXT* c = static_cast<const CONTEXT*>(ctx);
+            const DWORD64 r[] = { c->Rax, c->Rbx, c->Rcx, c->Rdx, c->Rsi, c->Rdi, c->Rbp, c->Rsp,
+                c->R8, c->R9, c->R10, c->R11, c->R12, c->R13, c->R14, c->R15, c->Rip, c->EFlags };
+            for (std::size_t i = 0; i < std::size(r); ++i) regs[i] = r[i];
+            sp = c->Rsp;
+            return static_cast<std::uint32_t>(std::size(r));
+        #elif defined(__linux__) && defined(__x86_64__)
+            const auto& g = static_cast<const ucontext_t*>(ctx)->uc_mcontext.gregs;
+            const int order[] = { REG_RAX, REG_RBX, REG_RCX, REG_RDX, REG_RSI, REG_RDI, REG_RBP, REG_RSP,
+                REG_R8, REG_R9, REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15, REG_RIP, REG_EFL };
+            for (std::size_t i = 0; i < std::size(order); ++i) regs[i] = static_cast<std::uint64_t>(g[order[i]]);
+            sp = static_cast<std::uint64_t>(g[REG_RSP]);
+            return static_cast<std::uint32_t>(std::size(order));
+        #elif defined(__linux__) && defined(__aarch64__)
+            const auto& m = static_cast<const ucontext_t*>(ctx)->uc_mcontext;
+            for (int i = 0; i < 31; ++i) regs[i] = m.regs[i];
+            regs[31] = m.sp;
+            regs[32] = m.pc;
+            regs[33] = m.pstate;
+            sp = m.sp;
+            return 34;
+        #else
+            (void)regs;
+            (void)sp;
+            return 0;
+        #endif
+        }
+
+        // Copy up to 'max' bytes of stack starting at 'sp', stopping at the
+        // first unreadable page. Never touches the memory directly.
+        void put_stack(SnapWriter& w, std::uint64_t sp, std::size_t max) {
+        #if defined(_WIN32)
+            static char chunk[4096];
+            std::uint64_t at = sp;
+            while (at < sp + max) {
+                const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(sizeof(chunk) - at % sizeof(chunk), sp + max - at));
+                SIZE_T got = 0;
+                if (!::ReadProcessMemory(::GetCurrentProcess(), reinterpret_cast<const void*>(at), chunk, n, &got) || got == 0) break;
+                w.put(chunk, got);
+                at += got;
+            }
+        #else
+            // write() reports EFAULT for an unmapped source instead of faulting.
+            const long page = 4096;
+            std::uint64_t at = sp;
+            while (at < sp + max) {
+                const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(page - at % page, sp + max - at));
+                const ssize_t got = ::write(w.file, reinterpret_cast<const void*>(at), n);
+                if (got <= 0) break;
+                w.bytes += static_cast<std::uint32_t>(got);
+                at += static_cast<std::uint64_t>(got);
+            }
+        #endif
+        }
+
+        // Stream a small /proc file into the open record.
+        void put_file(SnapWriter& w, const char* path) {
+        #if !defined(_WIN32)
+            const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return;
+            ssize_t n;
+            while ((n = ::read(fd, s_text, sizeof(s_text))) > 0) w.put(s_text, static_cast<std::size_t>(n));
+            ::close(fd);
+        #else
+            (void)w;
+            (void)path;
+        #endif
+        }
+
+        // "tid name state" per thread.
+        void put_thread_list(SnapWriter& w) {
+        #if defined(__linux__)
+            const int dir = ::open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dir < 0) return;
+            alignas(8) static char ents[4096];
+            long n;
+            while ((n = ::syscall(SYS_getdents64, dir, ents, sizeof(ents))) > 0) {
+                for (long off = 0; off < n;) {
+                    // struct linux_dirent64: u64 ino, s64 off, u16 reclen, u8 type, char name[]
+                    const char* e = ents + off;
+                    unsigned short reclen;
+                    std::memcpy(&reclen, e + 16, sizeof(reclen));
+                    const char* name = e + 19;
+                    off += reclen;
+                    if (name[0] < '0' || name[0] > '9') continue;
+
+                    // /proc/self/task/<tid>/stat: "tid (comm) S ..."
+                    char path[64] = "/proc/self/task/";
+                    std::size_t len = std::strlen(path);
+                    for (const char* p = name; *p && len + 6 < sizeof(path); ++p) path[len++] = *p;
+                    std::memcpy(path + len, "/stat", 6);
+                    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+                    if (fd < 0) continue;
+                    const ssize_t got = ::read(fd, s_text, 128);
+                    ::close(fd);
+                    if (got <= 0) continue;
+
+                    const char* open = static_cast<const char*>(std::memchr(s_text, '(', static_cast<std::size_t>(got)));
+                    const char* close = nullptr;
+                    for (ssize_t i = got - 1; i >= 0; --i) if (s_text[i] == ')') { close = s_text + i; break; }
+                    w.put_str(name);
+                    w.put(" ", 1);
+                    if (open && close && close > open) {
+                        for (const char* p = open + 1; p < close; ++p) w.put(*p == ' ' ? "_" : p, 1);   // keep one token
+                        if (close + 2 < s_text + got) { w.put(" ", 1); w.put(close + 2, 1); }
+                    }
+                    w.put("\n", 1);
+                }
+            }
+            ::close(dir);
+        #elif defined(_WIN32)
+            const HANDLE snap = ::CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+            if (snap == INVALID_HANDLE_VALUE) return;
+            THREADENTRY32 te{};
+            te.dwSize = sizeof(te);
+            const DWORD pid = ::GetCurrentProcessId();
+            for (BOOL ok = ::Thread32First(snap, &te); ok; ok = ::Thread32Next(snap, &te)) {
+                if (te.th32OwnerProcessID != pid) continue;
+                w.put_u64(te.th32ThreadID);
+                w.put_str(" ? ?\n");
+            }
+            ::CloseHandle(snap);
+        #else
+            (void)w;
+        #endif
+        }
+
+        // Module map: /proc/self/maps, or "base-end path" lines on Windows.
+        void put_modules(SnapWriter& w) {
+        #if defined(_WIN32)
+            const HANDLE snap = ::CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, 0);
+            if (snap == INVALID_HANDLE_VALUE) return;
+            MODULEENTRY32 me{};
+            me.dwSize = sizeof(me);
+            for (BOOL ok = ::Module32First(snap, &me); ok; ok = ::Module32Next(snap, &me)) {
+                const auto base = reinterpret_cast<std::uintptr_t>(me.modBaseAddr);
+                const int n = std::snprintf(s_text, sizeof(s_text), "%llx-%llx %s\n",
+                    static_cast<unsigned long long>(base), static_cast<unsigned long long>(base + me.modBaseSize), me.szExePath);
+                if (n > 0) w.put(s_text, std::min<std::size_t>(static_cast<std::size_t>(n), sizeof(s_text) - 1));
+            }
+            ::CloseHandle(snap);
+        #else
+            put_file(w, "/proc/self/maps");
+        #endif
+        }
+
+        std::uint64_t unix_time() {
+        #if defined(_WIN32)
+            FILETIME ft{};
+            ::GetSystemTimeAsFileTime(&ft);
+            const std::uint64_t t = (static_cast<std::uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+            return t / 10000000ull - 11644473600ull;   // 100 ns since 1601 -> s since 1970
+        #else
+            timespec ts{};
+            ::clock_gettime(CLOCK_REALTIME, &ts);
+            return static_cast<std::uint64_t>(ts.tv_sec);
+        #endif
+        }
+
+        std::uint64_t process_id() {
+        #if defined(_WIN32)
+            return ::GetCurrentProcessId();
+        #else
+            return static_cast<std::uint64_t>(::getpid());
+        #endif
+        }
+
+    } // namespace
+
+    bool CrashSnapshot::write(const char* path, const CrashContext& ctx) noexcept {
+        SnapWriter w;
+        w.file = file_create(path);
+        if (w.file == kNoFile) return false;
+
+        SnapFileHeader fh{};
+        std::memcpy(fh.magic, kSnapMagic, sizeof(fh.magic));
+        fh.version = kSnapVersion;
+        file_write(w.file, &fh, sizeof(fh));
+
+        // Info
+        SnapInfo info{};
+        info.unixTime = unix_time();
+        info.pid = process_id();
+        info.tid = current_tid();
+        info.frameIndex = PerfViewer::frame_index();
+        info.code = ctx.code;
+        info.faultAddr = ctx.faultAddr;
+        info.signal = ctx.signal;
+        info.arch = static_cast<std::uint32_t>(build_arch());
+        std::strncpy(info.reason, ctx.reason ? ctx.reason : "", sizeof(info.reason) - 1);
+        w.begin(SnapRecord::Info);
+        w.put(&info, sizeof(info));
+        w.end();
+
+        // Perf history. Skipped before the first completed frame: the category
+        // table may not exist yet, and creating it would allocate.
+        if (PerfViewer::frame_index() > 0) {
+            const std::size_t cats = std::min(PerfViewer::category_count(), kMaxCategories);
+            w.begin(SnapRecord::Categories);
+            const std::uint32_t count = static_cast<std::uint32_t>(cats);
+            w.put(&count, sizeof(count));
+            for (std::size_t c = 0; c < cats; ++c) {
+                const std::string& name = PerfViewer::category_name(static_cast<CategoryId>(c));
+                const std::uint16_t len = static_cast<std::uint16_t>(std::min<std::size_t>(name.size(), 0xFFFF));
+                w.put(&len, sizeof(len));
+                w.put(name.data(), len);
+            }
+            w.end();
+
+            bool partial = false;
+            const std::size_t frames = PerfViewer::copy_recent_frames(s_perfRows, kPerfFrames, cats, partial);
+            SnapPerfHeader ph{};
+            ph.secondsPerTick = TscClock::seconds_per_tick();
+            ph.categories = count;
+            ph.frames = static_cast<std::uint32_t>(frames);
+            ph.lastIsPartial = partial ? 1 : 0;
+            w.begin(SnapRecord::PerfFrames);
+            w.put(&ph, sizeof(ph));
+            w.put(s_perfRows, frames * (cats + 1) * sizeof(TscClock::ticks));
+            w.end();
+        }
+
+        // Log tail
+        if (const RingFileSink* ring = RingFileSink::current()) {
+            w.begin(SnapRecord::LogTail);
+            w.put(s_logTail, ring->copy_tail(s_logTail, sizeof(s_logTail), kLogLines));
+            w.end();
+        }
+
+        // Crashing thread: registers + stack. Without a context (terminate),
+        // the stack is taken from this frame upwards.
+        {
+            std::uint64_t regs[40] = {};
+            std::uint64_t sp = 0;
+            SnapThreadHeader th{};
+            th.tid = info.tid;
+            th.arch = info.arch;
+            th.regCount = read_registers(ctx.platformContext, regs, sp);
+            if (!sp) {
+                volatile char here = 0;
+                sp = reinterpret_cast<std::uintptr_t>(&here) & ~std::uint64_t(15);
+            }
+            th.sp = sp;
+            w.begin(SnapRecord::Thread);
+            w.put(&th, sizeof(th));
+            w.put(regs, th.regCount * sizeof(std::uint64_t));
+            put_stack(w, sp, kStackBytes);
+            w.end();
+        }
+
+        w.begin(SnapRecord::ThreadList);
+        put_thread_list(w);
+        w.end();
+
+        w.begin(SnapRecord::Modules);
+        put_modules(w);
+        w.end();
+
+        file_close(w.file);
+        return true;
+    }
+
+} // namespace eng::debug
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+===============================================================================
+ CrashSnapshot.h
+ ------------------------------------------------------------------------------
+ Purpose
+   Compact binary "minidump" written next to every crash report
+   (crash_YYYYMMDD_HHMMSS.snap). The text report says what crashed; the
+   snapshot adds what led up to it:
+	 - the current frame number and crash reason,
+	 - the last kPerfFrames PerfViewer frames (frame time + every category),
+	   so a frame time that was climbing before the crash is visible,
+	 - the last kLogLines log lines (from the log ring, see RingFileSink),
+	 - registers and the top kStackBytes of the stack of the crashing thread,
+	 - the list of all threads (Linux: id, name, state) and the module map.
+
+ How it works
+   - CrashLogger calls CrashSnapshot::write() from its fatal signal handler,
+	 SEH filter and terminate handler. write() only uses memory reserved up
+	 front and raw file I/O (open/write/lseek or CreateFile/WriteFile), so it
+	 is safe inside a signal handler.
+   - Stack memory is copied without dereferencing it ourselves: on POSIX it is
+	 passed straight to write(), which fails with EFAULT on an unmapped page
+	 instead of faulting; on Windows ReadProcessMemory does the same job.
+   - Read it with:   crash_snapshot_view crash_YYYYMMDD_HHMMSS.snap
+
+ File format (little-endian, written and read on the same kind of machine)
+   SnapFileHeader, then records until end of file:
+	 SnapRecordHeader { type, bytes } + 'bytes' payload, padded to 8 bytes.
+   Payloads:
+	 Info        SnapInfo
+	 Categories  u32 count, then count x (u16 length, name bytes)
+	 PerfFrames  SnapPerfHeader, then frames x (1 + categories) u64 ticks
+	 LogTail     text, oldest line first
+	 Thread      SnapThreadHeader, regCount x u64, then stack bytes from SP up
+	 ThreadList  text, one "tid name state" per line
+	 Modules     text, /proc/self/maps format
+   Unknown record types are skipped by readers, so new ones can be added.
+
+ Notes
+   - Only the crashing thread's registers/stack are captured. Stopping the
+	 other threads to read theirs is not something we want to do from a
+	 crashing process; they are listed by name and state instead.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	inline constexpr char          kSnapMagic[8] = { 'E', 'N', 'G', 'S', 'N', 'A', 'P', '1' };
+	inline constexpr std::uint32_t kSnapVersion = 1;
+
+	enum class SnapRecord : std::uint32_t {
+		Info = 1,
+		Categories = 2,
+		PerfFrames = 3,
+		LogTail = 4,
+		Thread = 5,
+		ThreadList = 6,
+		Modules = 7,
+	};
+
+	// Register set layout of a Thread record.
+	enum class SnapArch : std::uint32_t {
+		Unknown = 0,
+		X86_64 = 1,     // rax rbx rcx rdx rsi rdi rbp rsp r8..r15 rip rflags
+		Arm64 = 2,      // x0..x30 sp pc pstate
+	};
+
+	struct SnapFileHeader {
+		char          magic[8];        // kSnapMagic
+		std::uint32_t version;         // kSnapVersion
+		std::uint32_t reserved;
+	};
+
+	struct SnapRecordHeader {
+		std::uint32_t type;            // SnapRecord
+		std::uint32_t bytes;           // payload size (without padding)
+	};
+
+	struct SnapInfo {
+		std::uint64_t unixTime;        // seconds
+		std::uint64_t pid;
+		std::uint64_t tid;             // crashing thread
+		std::uint64_t frameIndex;      // PerfViewer::frame_index() at the crash
+		std::uint64_t code;            // signal code / SEH exception code
+		std::uint64_t faultAddr;
+		std::int32_t  signal;          // 0 for SEH / terminate
+		std::uint32_t arch;            // SnapArch of this build
+		char          reason[64];      // "SIGSEGV", "C++ terminate", ...
+	};
+
+	struct SnapPerfHeader {
+		double        secondsPerTick;  // TscClock::seconds_per_tick()
+		std::uint32_t categories;      // ticks per frame after the frame total
+		std::uint32_t frames;          // oldest first
+		std::uint32_t lastIsPartial;   // 1 if the last frame was still running
+		std::uint32_t reserved;
+	};
+
+	struct SnapThreadHeader {
+		std::uint64_t tid;
+		std::uint64_t sp;              // address of the first stack byte stored
+		std::uint32_t arch;            // SnapArch
+		std::uint32_t regCount;
+	};
+
+	// What the crash handler knows about the crash.
+	struct CrashContext {
+		const char*    reason = "";        // short text, e.g. "SIGSEGV"
+		int            signal = 0;
+		std::uint64_t  code = 0;
+		std::uintptr_t faultAddr = 0;
+		void*          platformContext = nullptr; // ucontext_t* (POSIX) / CONTEXT* (Windows), may be null
+	};
+
+	class CrashSnapshot {
+	public:
+		static constexpr std::size_t kPerfFrames = 240;        // ~4 s at 60 FPS
+		static constexpr std::size_t kLogLines = 200;
+		static constexpr std::size_t kStackBytes = 32 * 1024;
+
+		// Write a snapshot to 'path'. Async-signal-safe. Returns false if the
+		// file could not be created.
+		static bool write(const char* path, const CrashContext& ctx) noexcept;
+	};
+
+} // namespace eng::debug
@@ -0,0 +1,246 @@
+#include "HwCounters.h"
+#include "PerfViewer.h"
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+===============================================================================
+ HwCounters.cpp
+ ------------------------------------------------------------------------------
+ Linux perf_event_open implementation of HwCounters.
+
+ Key ideas
+   - One counter GROUP per thread: the first event is the group leader, the
+	 rest are attached to it. The kernel schedules a group as a unit, so all
+	 five values describe exactly the same stretch of execution.
+   - read_format = PERF_FORMAT_GROUP lets one read() on the leader return all
+	 values at once. With TOTAL_TIME_ENABLED / RUNNING the layout is
+	 { u64 nr; u64 time_enabled; u64 time_running; u64 values[nr]; }; the two
+	 times are the group's, so one ratio scales all values of a scope.
+   - enable() reads the group kCalibrationPairs times back to back and keeps
+	 the smallest delta per event as the read overhead. The minimum never
+	 exceeds what a real scope pays, so subtracting it cannot go negative
+	 (and is clamped at 0 anyway).
+   - We count user space only (exclude_kernel / exclude_hv), which is what we
+	 control and usually what the default perf_event_paranoid level allows.
+   - Events that fail to open (common in VMs for cache events) are skipped;
+	 their slot stays 0.
+
+ Other platforms
+   - enable() logs once and returns false; everything else is a no-op.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	namespace {
+
+		std::atomic<bool> g_everEnabled{ false };
+
+	#if defined(__linux__)
+		// Per-thread counter group.
+		struct ThreadCounters {
+			int  leaderFd = -1;                              // group leader fd
+			int  fds[(size_t)HwEvent::COUNT];                // fd per event, -1 if missing
+			int  slotOf[(size_t)HwEvent::COUNT];             // read index per event, -1 if missing
+			int  opened = 0;                                 // number of events in the group
+			HwCounterValues overhead;                        // counts of an empty scope
+		};
+		thread_local ThreadCounters t_counters;
+
+		// (type, config) for each HwEvent, in enum order.
+		struct EventDesc { std::uint32_t type; std::uint64_t config; };
+		constexpr EventDesc kEvents[(size_t)HwEvent::COUNT] = {
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+			{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+				| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },   // last-level cache
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		};
+
+		int open_event_(const EventDesc& e, int groupFd) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = e.type;
+			attr.config = e.config;
+			attr.disabled = (groupFd == -1) ? 1 : 0;  // leader starts disabled
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP
+				| PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			// pid = 0 (this thread), cpu = -1 (any CPU)
+			return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+		}
+
+		constexpr int kCalibrationPairs = 64;
+
+		// What an HwScope with nothing inside counts: the end of the first
+		// read() and the start of the second.
+		HwCounterValues measure_overhead_() noexcept {
+			HwCounterValues best;
+			best.v.fill(UINT64_MAX);
+			for (int i = 0; i < kCalibrationPairs; ++i) {
+				HwCounterValues a, b;
+				if (!HwCounters::read(a) || !HwCounters::read(b)) return HwCounterValues{};
+				for (size_t e = 0; e < best.v.size(); ++e) {
+					best.v[e] = std::min(best.v[e], b.v[e] - a.v[e]);
+				}
+			}
+			return best;
+		}
+	#endif
+
+	} // namespace
+
+	bool HwCounters::enable() {
+	#if defined(__linux__)
+		auto& tc = t_counters;
+		if (tc.leaderFd != -1) return true;
+
+		for (auto& s : tc.slotOf) s = -1;
+		for (auto& f : tc.fds) f = -1;
+		tc.opened = 0;
+
+		for (size_t i = 0; i < (size_t)HwEvent::COUNT; ++i) {
+			const int fd = open_event_(kEvents[i], tc.leaderFd);
+			if (fd == -1) {
+				// A missing leader means no group at all; keep trying the next
+				// event as leader. A missing member just leaves its slot at 0.
+				continue;
+			}
+			if (tc.leaderFd == -1) tc.leaderFd = fd;
+			tc.fds[i] = fd;
+			tc.slotOf[i] = tc.opened++;
+		}
+
+		if (tc.leaderFd == -1) {
+			Log::writef(LogLevel::Warn, "PERF", "", 0,
+				"HwCounters: perf_event_open failed (check /proc/sys/kernel/perf_event_paranoid)");
+			return false;
+		}
+
+		ioctl(tc.leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(tc.leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		g_everEnabled.store(true, std::memory_order_relaxed);
+		tc.overhead = measure_overhead_();
+
+		Log::writef(LogLevel::Info, "PERF", "", 0,
+			"HwCounters enabled (%d of %d events, read overhead %llu instr / %llu cycles)", tc.opened,
+			(int)HwEvent::COUNT, (unsigned long long)tc.overhead[HwEvent::Instructions],
+			(unsigned long long)tc.overhead[HwEvent::Cycles]);
+		return true;
+	#else
+		Log::write(LogLevel::Info, "PERF", "", 0, "HwCounters: not supported on this platform.");
+		return false;
+	#endif
+	}
+
+	void HwCounters::disable() noexcept {
+	#if defined(__linux__)
+		auto& tc = t_counters;
+		if (tc.leaderFd == -1) return;
+
+		ioctl(tc.leaderFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+		// Close members and leader (the leader is also stored in fds[]).
+		for (auto& f : tc.fds) {
+			if (f != -1) close(f);
+			f = -1;
+		}
+		tc.leaderFd = -1;
+		tc.opened = 0;
+		tc.overhead = HwCounterValues{};
+	#endif
+	}
+
+	bool HwCounters::active() noexcept {
+	#if defined(__linux__)
+		return t_counters.leaderFd != -1;
+	#else
+		return false;
+	#endif
+	}
+
+	bool HwCounters::read(HwCounterValues& out) noexcept {
+	#if defined(__linux__)
+		const auto& tc = t_counters;
+		if (tc.leaderFd == -1) return false;
+
+		// Layout: { nr, time_enabled, time_running, values[nr] }
+		std::uint64_t buf[3 + (size_t)HwEvent::COUNT];
+		const ssize_t n = ::read(tc.leaderFd, buf, sizeof(buf));
+		if (n < (ssize_t)(3 * sizeof(std::uint64_t))) return false;
+
+		const std::uint64_t nr = buf[0];
+		out.time_enabled = buf[1];
+		out.time_running = buf[2];
+		for (size_t i = 0; i < (size_t)HwEvent::COUNT; ++i) {
+			const int slot = tc.slotOf[i];
+			out.v[i] = (slot >= 0 && (std::uint64_t)slot < nr) ? buf[3 + slot] : 0;
+		}
+		return true;
+	#else
+		(void)out;
+		return false;
+	#endif
+	}
+
+	HwCounterValues HwCounters::read_overhead() noexcept {
+	#if defined(__linux__)
+		return t_counters.overhead;
+	#else
+		return HwCounterValues{};
+	#endif
+	}
+
+	bool HwCounters::ever_enabled() noexcept {
+		return g_everEnabled.load(std::memory_order_relaxed);
+	}
+
+	const char* HwCounters::event_name(HwEvent e) noexcept {
+		switch (e) {
+		case HwEvent::Instructions: return "instr";
+		case HwEvent::Cycles:       return "cycles";
+		case HwEvent::L1DMisses:    return "l1_miss";
+		case HwEvent::LLCMisses:    return "llc_miss";
+		case HwEvent::BranchMisses: return "br_miss";
+		default:                    return "unknown";
+		}
+	}
+
+	HwScope::~HwScope() noexcept {
+		if (!m_ok) return;
+
+		HwCounterValues end;
+		if (!HwCounters::read(end)) return;
+
+		HwCounterValues delta;
+		delta.time_enabled = end.time_enabled - m_start.time_enabled;
+		delta.time_running = end.time_running - m_start.time_running;
+		if (delta.time_running == 0) return;   // never on the PMU during the scope
+
+		// Scale up for multiplexing, then take off the reads' own counts
+		const double scale = (delta.time_running < delta.time_enabled)
+			? (double)delta.time_enabled / (double)delta.time_running : 1.0;
+		const HwCounterValues overhead = HwCounters::read_overhead();
+		for (size_t i = 0; i < delta.v.size(); ++i) {
+			const std::uint64_t raw = end.v[i] - m_start.v[i];
+			const std::uint64_t scaled = (scale == 1.0) ? raw : (std::uint64_t)((double)raw * scale + 0.5);
+			delta.v[i] = (scaled > overhead.v[i]) ? scaled - overhead.v[i] : 0;
+		}
+		PerfViewer::record_counters(m_cat, delta);
+	}
+
+} // namespace eng::debug
@@ -0,0 +1,135 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Trace.h"
+
+/*
+===============================================================================
+ HwCounters.h
+ ------------------------------------------------------------------------------
+ Purpose
+   Optional hardware performance counters for selected profiler scopes.
+   Wall time tells us THAT a scope is slow; these counters tell us WHY:
+	 - Instructions, Cycles   -> IPC (instructions per cycle)
+	 - L1D read misses        -> data-layout / access-pattern problems
+	 - LLC misses             -> working set does not fit in cache
+	 - Branch misses          -> unpredictable control flow
+
+ How it works
+   - On Linux, HwCounters::enable() opens one perf_event_open group for the
+	 calling thread (all five events are scheduled together, so the numbers
+	 are consistent with each other).
+   - HwScope (via DBG_SCOPE_HW) reads the group at construction and at
+	 destruction and reports the delta to PerfViewer::record_counters().
+	 The delta is corrected twice:
+	   - multiplexing: when the kernel had to time-share the PMU, the group
+		 only counted for part of the scope; values are scaled by
+		 time enabled / time running (as perf stat does),
+	   - read overhead: part of both reads falls inside the interval. enable()
+		 measures what an empty scope counts and every scope subtracts it.
+   - PerfViewer shows the counters next to the time percentages and adds
+	 per-category counter columns to the CSV export.
+
+ Usage
+   // Once, at startup (main thread):
+   eng::debug::HwCounters::enable();
+
+   void Physics::Update(float dt) {
+	 DBG_SCOPE_HW("Physics", kPhysicsCategory);   // time + counters
+	 ...
+   }
+
+ Notes
+   - Counters are per thread. A scope on a thread that did not call enable()
+	 records time only.
+   - Each read is one read() syscall on the group (~1 us), so use DBG_SCOPE_HW
+	 for coarse scopes (per system), and DBG_SCOPE_SYS for dense ones.
+   - On other platforms, or when the kernel refuses access
+	 (/proc/sys/kernel/perf_event_paranoid), enable() returns false and
+	 DBG_SCOPE_HW behaves exactly like DBG_SCOPE_SYS.
+   - Events the CPU/VM does not expose are reported as 0.
+   - A scope during which the group never got onto the PMU reports nothing
+	 (there is nothing to scale).
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	// Counted events, in the order they are stored in HwCounterValues.
+	enum class HwEvent : unsigned char {
+		Instructions = 0,
+		Cycles,
+		L1DMisses,
+		LLCMisses,
+		BranchMisses,
+		COUNT
+	};
+
+	// One reading (or delta) of all events.
+	struct HwCounterValues {
+		std::array<std::uint64_t, (size_t)HwEvent::COUNT> v{};
+		std::uint64_t time_enabled = 0;   // ns the group was enabled
+		std::uint64_t time_running = 0;   // ns it was actually counting (less when multiplexed)
+
+		std::uint64_t operator[](HwEvent e) const noexcept { return v[(size_t)e]; }
+	};
+
+	class HwCounters {
+	public:
+		// Open and start the counter group for the calling thread.
+		// Returns false if unsupported on this platform or denied by the kernel.
+		static bool enable();
+
+		// Stop and close the calling thread's counter group.
+		static void disable() noexcept;
+
+		// True if the calling thread has an active counter group.
+		static bool active() noexcept;
+
+		// Read the current (monotonic, unscaled) counter values for the
+		// calling thread. Returns false if not active or the read failed.
+		static bool read(HwCounterValues& out) noexcept;
+
+		// Counts of an empty HwScope on the calling thread (measured by
+		// enable()); HwScope subtracts it. Zero when not active.
+		static HwCounterValues read_overhead() noexcept;
+
+		// True if any thread ever enabled counters (controls CSV columns).
+		static bool ever_enabled() noexcept;
+
+		// Short column/display name, e.g. "instr", "l1_miss".
+		static const char* event_name(HwEvent e) noexcept;
+	};
+
+	// HwScope
+	// -------------------------------------------------------------------------
+	// RAII helper that reports the counter delta of its scope to PerfViewer.
+	// Does nothing when counters are not active on this thread.
+	class HwScope {
+	public:
+		explicit HwScope(CategoryId cat) noexcept : m_cat(cat) {
+			m_ok = HwCounters::active() && HwCounters::read(m_start);
+		}
+		explicit HwScope(Subsystem sys) noexcept : HwScope(static_cast<CategoryId>(sys)) {}
+		~HwScope() noexcept;
+
+		HwScope(const HwScope&) = delete;
+		HwScope& operator=(const HwScope&) = delete;
+
+	private:
+		HwCounterValues m_start;
+		CategoryId      m_cat;
+		bool            m_ok = false;
+	};
+
+	// Helper macro
+	// -------------------------------------------------------------------------
+	// Same as DBG_SCOPE_SYS, plus hardware counters for the scope.
+#if ENG_PROFILING
+#define DBG_SCOPE_HW(NAME, SUBSYS) \
+	DBG_SCOPE_SYS(NAME, SUBSYS); ::eng::debug::HwScope DBG_CONCAT_(_dbg_hw_, __LINE__){SUBSYS}
+#else
+#define DBG_SCOPE_HW(NAME, SUBSYS) ((void)0)
+#endif
+
+} // namespace eng::debug
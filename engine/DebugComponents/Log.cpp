@@ -2,10 +2,14 @@
 #include "Sinks.h"
 
 #include <chrono>
+#include <charconv>
 #include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
 #include <mutex>
-#include <sstream>
-#include <iomanip>
+#include <unordered_map>
 //
 // ============================================================================================
 //  Simple logging API for the engine (implementation)
@@ -14,9 +18,25 @@
 //     We keep a single global LogState (level + list of sinks).
 //     All public methods are static and thread-safe where needed.
 //     We format the final line once (with timestamp/level/tag/message)
-//      then broadcast it to each sink via dispatch_().
+//      then broadcast it to each sink via dispatch_() as a string_view.
 //     The "(file:line)" appendix is controlled by state().showSource.
 //
+//  Formatting path (no heap allocation):
+//     Every thread owns one LineBuffer (thread_local). A line is built by
+//      appending straight into it: cached "HH:MM:SS" + ".mmm", level, tag,
+//      then vsnprintf writes the message body in place.
+//     The "HH:MM:SS" part only changes once per second, so localtime is
+//      called at most once per second per thread instead of once per line.
+//     Lines longer than LineBuffer::kCapacity are truncated.
+//     Structured fields (write_kv) are rendered with to_chars, and the
+//      record keeps the typed values for sinks like JsonLinesSink.
+//
+//  Tags and levels:
+//     Tags are interned into LogState::tagNames; the id indexes two flat
+//      arrays (name pointer, level override), so enabled() is lock-free.
+//     'maxLevel' is the most verbose of the global level and every override.
+//      The const char* entry points use it to reject lines before interning.
+//
 //  Thread-safety:
 //     A single mutex protects the sink list and dispatch.
 //     If you need extremely high throughput, you can later swap the sinks
@@ -27,55 +47,229 @@ namespace eng::debug {
 
     namespace {
 
+        // Level override value meaning "use the global level".
+        constexpr std::uint8_t kNoOverride = 0xFF;
+
         // Global logging state. This lives for the process lifetime.
         struct LogState {
-            LogLevel level = LogLevel::Info;                // minimum level that gets printed
+            std::atomic<std::uint8_t> level{ static_cast<std::uint8_t>(LogLevel::Info) }; // global minimum level
+            std::atomic<std::uint8_t> maxLevel{ static_cast<std::uint8_t>(LogLevel::Info) }; // most verbose of level + overrides
+            std::atomic<std::uint32_t> overrides{ 0 };      // number of tags with a level override
             std::vector<std::unique_ptr<ILogSink>> sinks;   // all active destinations
             std::mutex mtx;                                 // protects 'sinks' and dispatch
             bool showSource = false;                        // append "(file:line)" to lines if true
+            std::atomic<std::uint64_t> suppressed{ 0 };     // lines dropped by rate limits
+
+            // Tag interning (tagMtx guards the map, names and tagCount).
+            std::mutex tagMtx;
+            std::unordered_map<std::string, std::uint16_t> tagIds;
+            std::deque<std::string> tagNames;               // deque: stable c_str() pointers
+            std::size_t tagCount = 0;
+            std::atomic<const char*> tagNamePtr[Log::kMaxTags]{};
+            std::atomic<std::uint8_t> tagLevel[Log::kMaxTags];
+
+            LogState() {
+                for (auto& l : tagLevel) l.store(kNoOverride, std::memory_order_relaxed);
+                tagNames.emplace_back("LOG");               // id 0: fallback tag
+                tagIds.emplace("LOG", 0);
+                tagNamePtr[0].store(tagNames.back().c_str());
+                tagCount = 1;
+            }
         };
 
         // Singleton accessor (initialized on first use).
         static LogState& state() { static LogState S; return S; }
 
-        // Return "HH:MM:SS.mmm" (local time). We avoid i/o heavy calls here.
-        static std::string time_now_str() {
-            using namespace std::chrono;
-            auto now = system_clock::now();
-            auto t = system_clock::to_time_t(now);
-            auto ms = duration_cast<milliseconds>(now.time_since_epoch()).count() % 1000;
-            std::tm tm{};
-        #if defined(_WIN32)
-            localtime_s(&tm, &t);   // Windows thread-safe variant
-        #else   
-            localtime_r(&t, &tm);   // POSIX thread-safe variant
-        #endif
-            std::ostringstream oss;
-            oss << std::setfill('0')
-                << std::setw(2) << tm.tm_hour << ":"
-                << std::setw(2) << tm.tm_min << ":"
-                << std::setw(2) << tm.tm_sec << "."
-                << std::setw(3) << ms;
-            return oss.str();
+        // Recompute LogState::maxLevel/overrides after the global level or an override
+        // changed. Caller holds tagMtx.
+        static void update_max_level(LogState& S) {
+            std::uint8_t m = S.level.load(std::memory_order_relaxed);
+            std::uint32_t n = 0;
+            for (std::size_t i = 0; i < S.tagCount; ++i) {
+                const std::uint8_t t = S.tagLevel[i].load(std::memory_order_relaxed);
+                if (t == kNoOverride) continue;
+                ++n;
+                if (t > m) m = t;
+            }
+            S.maxLevel.store(m, std::memory_order_relaxed);
+            S.overrides.store(n, std::memory_order_relaxed);
+        }
+
+        // "debug" / "Debug" / "DEBUG" -> LogLevel. Returns false if unknown.
+        static bool parse_level(std::string_view text, LogLevel& out) {
+            static constexpr std::string_view kNames[] = { "error", "warn", "info", "debug" };
+            for (std::size_t i = 0; i < 4; ++i) {
+                const std::string_view n = kNames[i];
+                if (text.size() != n.size()) continue;
+                bool same = true;
+                for (std::size_t c = 0; c < n.size() && same; ++c) {
+                    const char ch = (text[c] >= 'A' && text[c] <= 'Z') ? static_cast<char>(text[c] - 'A' + 'a') : text[c];
+                    same = (ch == n[c]);
+                }
+                if (same) { out = static_cast<LogLevel>(i); return true; }
+            }
+            return false;
+        }
+
+        static std::string_view trim(std::string_view v) {
+            while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+            while (!v.empty() && (v.back() == ' ' || v.back() == '\t')) v.remove_suffix(1);
+            return v;
         }
 
         // Convert enum to short uppercase string.
-        static std::string level_to_cstr(LogLevel l) {
+        static std::string_view level_to_sv(LogLevel l) {
             switch (l) {
             case LogLevel::Error: return "ERROR";
-            case LogLevel::Warn: return "WARN";
-            case LogLevel::Info: return "INFO";
+            case LogLevel::Warn:  return "WARN";
+            case LogLevel::Info:  return "INFO";
             default:              return "DEBUG";
             }
         }
+
+        // Per-thread line under construction. Appends never overflow: they
+        // clip at kCapacity and the line is simply truncated.
+        struct LineBuffer {
+            static constexpr size_t kCapacity = 2048;
+            char   data[kCapacity + 1];   // +1 keeps room for a terminating NUL
+            size_t len = 0;
+            size_t bodyStart = 0;         // message body starts here (after the prefix)
+            std::int64_t unixMs = 0;      // timestamp of the line
+
+            size_t room() const { return kCapacity - len; }
+
+            void append(std::string_view sv) {
+                const size_t n = (sv.size() < room()) ? sv.size() : room();
+                std::memcpy(data + len, sv.data(), n);
+                len += n;
+            }
+            void append(char c) { if (len < kCapacity) data[len++] = c; }
+
+            void append_int(long long v) {
+                auto r = std::to_chars(data + len, data + kCapacity, v);
+                if (r.ec == std::errc()) len = static_cast<size_t>(r.ptr - data);
+            }
+            void append_uint(unsigned long long v) {
+                auto r = std::to_chars(data + len, data + kCapacity, v);
+                if (r.ec == std::errc()) len = static_cast<size_t>(r.ptr - data);
+            }
+            // Like %g: 6 significant digits, which is what people read in a log.
+            void append_double(double v) {
+                auto r = std::to_chars(data + len, data + kCapacity, v, std::chars_format::general, 6);
+                if (r.ec == std::errc()) len = static_cast<size_t>(r.ptr - data);
+            }
+
+            // vsnprintf straight into the buffer.
+            void append_vformat(const char* fmt, va_list ap) {
+                if (room() == 0) return;
+                const int n = std::vsnprintf(data + len, room() + 1, fmt, ap);
+                if (n > 0) len += (static_cast<size_t>(n) < room()) ? static_cast<size_t>(n) : room();
+            }
+
+            std::string_view view() { data[len] = '\0'; return { data, len }; }
+        };
+
+        // Cached "HH:MM:SS" for the current second (per thread, so no lock).
+        struct TimeCache {
+            long long sec = -1;
+            char      hms[8];
+        };
+
+        static thread_local LineBuffer t_line;
+        static thread_local TimeCache  t_time;
+
+        // Append "HH:MM:SS.mmm" (local time). localtime only runs when the
+        // second changes; the milliseconds are two divisions.
+        static void append_time(LineBuffer& b) {
+            using namespace std::chrono;
+            const auto msSinceEpoch = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+            b.unixMs = static_cast<std::int64_t>(msSinceEpoch);
+            const long long sec = msSinceEpoch / 1000;
+            const int ms = static_cast<int>(msSinceEpoch % 1000);
+
+            if (sec != t_time.sec) {
+                const std::time_t t = static_cast<std::time_t>(sec);
+                std::tm tm{};
+            #if defined(_WIN32)
+                localtime_s(&tm, &t);   // Windows thread-safe variant
+            #else
+                localtime_r(&t, &tm);   // POSIX thread-safe variant
+            #endif
+                const int parts[3] = { tm.tm_hour, tm.tm_min, tm.tm_sec };
+                for (int i = 0; i < 3; ++i) {
+                    t_time.hms[i * 3 + 0] = static_cast<char>('0' + parts[i] / 10);
+                    t_time.hms[i * 3 + 1] = static_cast<char>('0' + parts[i] % 10);
+                    if (i < 2) t_time.hms[i * 3 + 2] = ':';
+                }
+                t_time.sec = sec;
+            }
+
+            b.append(std::string_view(t_time.hms, 8));
+            b.append('.');
+            b.append(static_cast<char>('0' + ms / 100));
+            b.append(static_cast<char>('0' + (ms / 10) % 10));
+            b.append(static_cast<char>('0' + ms % 10));
+        }
+
+        // Start a line: "[HH:MM:SS.mmm][LEVEL][TAG] "
+        static LineBuffer& begin_line(LogLevel lvl, const char* tag) {
+            LineBuffer& b = t_line;
+            b.len = 0;
+            b.append('[');
+            append_time(b);
+            b.append("][");
+            b.append(level_to_sv(lvl));
+            b.append("][");
+            b.append(tag);
+            b.append("] ");
+            b.bodyStart = b.len;
+            return b;
+        }
+
+        // Text form of structured fields: " key=value key2=\"text\"".
+        static void append_fields(LineBuffer& b, std::initializer_list<LogField> fields) {
+            for (const LogField& f : fields) {
+                b.append(' ');
+                b.append(f.key ? f.key : "?");
+                b.append('=');
+                switch (f.type) {
+                case LogField::Type::Int:    b.append_int(f.i); break;
+                case LogField::Type::UInt:   b.append_uint(f.u); break;
+                case LogField::Type::Float:  b.append_double(f.f); break;
+                case LogField::Type::Bool:   b.append(f.b ? "true" : "false"); break;
+                case LogField::Type::String: b.append('"'); b.append(f.s); b.append('"'); break;
+                }
+            }
+        }
+
+        // Package the finished line as a record for the sinks.
+        static LogRecord make_record(LogLevel lvl, const char* tag, const char* file, int line,
+            LineBuffer& b, size_t bodyEnd, const LogField* fields, size_t fieldCount) {
+            const std::string_view text = b.view();
+            return LogRecord{ lvl, tag, b.unixMs, text.substr(b.bodyStart, bodyEnd - b.bodyStart),
+                fields, fieldCount, (state().showSource && file) ? file : "", line, text };
+        }
+
+        // Optional " (file:line)" appendix.
+        static void end_line(LineBuffer& b, const char* file, int line) {
+            if (state().showSource) {
+                b.append(" (");
+                b.append(file ? file : "");
+                b.append(':');
+                b.append_int(line);
+                b.append(')');
+            }
+        }
     } // namespace
 
     // Initialize sinks and state from a config.
     void Log::init(const LogConfig& cfg) {
         auto& S = state();
+        set_level(cfg.level);
+        if (!cfg.tagLevels.empty()) set_tag_levels(cfg.tagLevels);
+
         std::scoped_lock lk(S.mtx);
 
-        S.level = cfg.level;
         S.showSource = cfg.showSourceInfo;
 
         // Drop existing sinks (if any) so re-initialization is safe.
@@ -83,7 +277,15 @@ namespace eng::debug {
 
         // Add built-in sinks according to the config.
         if (cfg.useConsole)       S.sinks.emplace_back(std::make_unique<ConsoleSink>(cfg.usePlatformOutput));
-        if (cfg.useFile)          S.sinks.emplace_back(std::make_unique<FileSink>(cfg.filePath));
+        if (cfg.useFile) {
+            if (cfg.rotation.enabled) S.sinks.emplace_back(std::make_unique<RotatingFileSink>(cfg.filePath, cfg.rotation));
+            else                      S.sinks.emplace_back(std::make_unique<FileSink>(cfg.filePath));
+        }
+        if (cfg.useJson)          S.sinks.emplace_back(std::make_unique<JsonLinesSink>(cfg.jsonPath));
+        if (cfg.useRing) {
+            auto ring = std::make_unique<RingFileSink>(cfg.ringPath, cfg.ringBytes);
+            if (ring->is_open()) S.sinks.emplace_back(std::move(ring));
+        }
     }
 
     // Remove sinks and free resources.
@@ -94,8 +296,95 @@ namespace eng::debug {
     }
 
     // Runtime control of threshold (useful to toggle verbose output).
-    void Log::set_level(LogLevel lvl) { state().level = lvl; }
-    LogLevel Log::get_level() { return state().level; }
+    void Log::set_level(LogLevel lvl) {
+        auto& S = state();
+        std::scoped_lock lk(S.tagMtx);
+        S.level.store(static_cast<std::uint8_t>(lvl), std::memory_order_relaxed);
+        update_max_level(S);
+    }
+    LogLevel Log::get_level() { return static_cast<LogLevel>(state().level.load(std::memory_order_relaxed)); }
+
+    // Intern a tag. Unknown tags beyond kMaxTags all map to id 0.
+    LogTagId Log::tag_id(const char* tag) {
+        if (!tag || !*tag) return LogTagId{ 0 };
+        auto& S = state();
+        std::scoped_lock lk(S.tagMtx);
+        if (auto it = S.tagIds.find(tag); it != S.tagIds.end()) return LogTagId{ it->second };
+        if (S.tagCount >= kMaxTags) return LogTagId{ 0 };
+
+        const auto id = static_cast<std::uint16_t>(S.tagCount);
+        S.tagNames.emplace_back(tag);
+        S.tagIds.emplace(S.tagNames.back(), id);
+        S.tagNamePtr[id].store(S.tagNames.back().c_str(), std::memory_order_release);
+        ++S.tagCount;
+        return LogTagId{ id };
+    }
+
+    const char* Log::tag_name(LogTagId id) noexcept {
+        const auto i = static_cast<std::size_t>(id);
+        const char* n = (i < kMaxTags) ? state().tagNamePtr[i].load(std::memory_order_acquire) : nullptr;
+        return n ? n : "LOG";
+    }
+
+    void Log::set_tag_level(const char* tag, LogLevel lvl) {
+        const auto id = static_cast<std::size_t>(tag_id(tag));
+        auto& S = state();
+        std::scoped_lock lk(S.tagMtx);
+        S.tagLevel[id].store(static_cast<std::uint8_t>(lvl), std::memory_order_relaxed);
+        update_max_level(S);
+    }
+
+    void Log::clear_tag_level(const char* tag) {
+        const auto id = static_cast<std::size_t>(tag_id(tag));
+        auto& S = state();
+        std::scoped_lock lk(S.tagMtx);
+        S.tagLevel[id].store(kNoOverride, std::memory_order_relaxed);
+        update_max_level(S);
+    }
+
+    bool Log::set_tag_levels(std::string_view spec) {
+        bool ok = true;
+        while (!spec.empty()) {
+            const size_t comma = spec.find(',');
+            const std::string_view item = trim(spec.substr(0, comma));
+            spec = (comma == std::string_view::npos) ? std::string_view{} : spec.substr(comma + 1);
+            if (item.empty()) continue;
+
+            const size_t eq = item.find('=');
+            LogLevel lvl{};
+            if (eq == std::string_view::npos || !parse_level(trim(item.substr(eq + 1)), lvl)) { ok = false; continue; }
+            const std::string tag(trim(item.substr(0, eq)));
+            if (tag.empty()) { ok = false; continue; }
+            set_tag_level(tag.c_str(), lvl);
+        }
+        return ok;
+    }
+
+    // Hot check used by every LOG_* macro: two relaxed loads, no lock.
+    bool Log::enabled(LogLevel lvl, LogTagId tag) noexcept {
+        const auto& S = state();
+        const auto i = static_cast<std::size_t>(tag);
+        const std::uint8_t t = (i < kMaxTags) ? S.tagLevel[i].load(std::memory_order_relaxed) : kNoOverride;
+        const std::uint8_t limit = (t == kNoOverride) ? S.level.load(std::memory_order_relaxed) : t;
+        return static_cast<std::uint8_t>(lvl) <= limit;
+    }
+
+    std::uint64_t Log::suppressed_count() noexcept { return state().suppressed.load(std::memory_order_relaxed); }
+    void Log::add_suppressed_(std::uint32_t n) noexcept { state().suppressed.fetch_add(n, std::memory_order_relaxed); }
+
+    // One-second windows on the steady clock. Two threads racing at a window
+    // edge may let a line or two extra through, which is fine for logging.
+    bool LogRateLimiter::allow(std::uint32_t perSecond) noexcept {
+        using namespace std::chrono;
+        const std::int64_t now = duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+        std::int64_t start = windowStartMs.load(std::memory_order_relaxed);
+        if (now - start >= 1000 && windowStartMs.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            inWindow.store(0, std::memory_order_relaxed);
+        }
+        if (inWindow.fetch_add(1, std::memory_order_relaxed) < perSecond) return true;
+        Log::add_suppressed_(1);
+        return false;
+    }
 
     // Add a custom sink at runtime (e.g., network sink). Ownership transfers here.
     void Log::add_sink(std::unique_ptr<ILogSink> sink) {
@@ -107,60 +396,102 @@ namespace eng::debug {
     // Toggle "(file:line)" appendix for normal logs.
     void Log::set_show_source_info(bool enabled) { state().showSource = enabled; }
 
-    // printf-style logging. We build a single fully formatted line and broadcast it.
+    // Level check for the const char* entry points. Without any per-tag
+    // override this is one atomic load; otherwise the tag gets interned.
+    static bool enabled_by_name(LogLevel lvl, const char* tag) {
+        const auto& S = state();
+        if (static_cast<std::uint8_t>(lvl) > S.maxLevel.load(std::memory_order_relaxed)) return false;
+        if (S.overrides.load(std::memory_order_relaxed) == 0) return true;
+        return Log::enabled(lvl, Log::tag_id(tag));
+    }
+
+    // printf-style logging. We build a single fully formatted line in the
+    // calling thread's LineBuffer and broadcast it.
     void Log::writef(LogLevel lvl, const char* tag, const char* file, int line, const char* fmt, ...) noexcept {
 
         // Filter by current threshold as early as possible.
-        if (lvl > get_level()) return;
+        if (!tag) tag = "LOG";
+        if (!enabled_by_name(lvl, tag)) return;
+
+        va_list ap;
+        va_start(ap, fmt);
+        vwritef_(lvl, tag, file, line, fmt, ap);
+        va_end(ap);
+    }
 
-        // 1) Build the message body using printf-style formatting.
-		char buf[2048]; // fixed-size buffer to avoid dynamic allocs in logging path
+    // Interned-tag variant used by the LOG_* macros (level already checked).
+    void Log::writef(LogLevel lvl, LogTagId tag, const char* file, int line, const char* fmt, ...) noexcept {
         va_list ap;
         va_start(ap, fmt);
-    #if defined(_WIN32)
-        _vsnprintf_s(buf, sizeof(buf), _TRUNCATE, fmt, ap);
-    #else
-        vsnprintf(buf, sizeof(buf), _TRUNCATE, fmt, ap);
-    #endif
+        vwritef_(lvl, tag_name(tag), file, line, fmt, ap);
         va_end(ap);
+    }
+
+    // std::string-style logging (when you already have a formatted message).
+    void Log::write(LogLevel lvl, const char* tag, const char* file, int line, const std::string& message) noexcept {
+        if (!tag) tag = "LOG";
+        if (!enabled_by_name(lvl, tag)) return;
+        write_(lvl, tag, file, line, message);
+    }
+
+    void Log::write(LogLevel lvl, LogTagId tag, const char* file, int line, const std::string& message) noexcept {
+        write_(lvl, tag_name(tag), file, line, message);
+    }
+
+    void Log::vwritef_(LogLevel lvl, const char* tag, const char* file, int line, const char* fmt, va_list ap) noexcept {
+        // 1) Prepend timestamp, level, and tag. Keep it compact.
+        LineBuffer& b = begin_line(lvl, tag);
 
-        // 2) Prepend timestamp, level, and tag. Keep it compact.
-        std::ostringstream oss;
-        oss << "[" << time_now_str() << "]"
-            << "[" << level_to_cstr(lvl) << "]"
-            << "[" << (tag ? tag : "LOG") << "] "
-            << buf;
+        // 2) Format the message body directly behind the prefix.
+        b.append_vformat(fmt, ap);
+        const size_t bodyEnd = b.len;
 
         // 3) Optionally append "(file:line)" for normal logs.
-        if (state().showSource) {
-            oss << " (" << file << ":" << line << ")";
-        }
+        end_line(b, file, line);
 
         // 4) Send to all sinks.
-        dispatch_(lvl, tag ? tag : "LOG", oss.str().c_str());
+        dispatch_(make_record(lvl, tag, file, line, b, bodyEnd, nullptr, 0));
     }
 
-    // std::string-style logging (when you already have a formatted message).
-    void Log::write(LogLevel lvl, const char* tag, const char* file, int line, const std::string& message) noexcept {
-        if (lvl > get_level()) return;
-        std::ostringstream oss;
-        oss << "[" << time_now_str() << "]"
-            << "[" << level_to_cstr(lvl) << "]"
-            << "[" << (tag ? tag : "LOG") << "] "
-            << message;
-        if (state().showSource) {
-            oss << " (" << file << ":" << line << ")";
-        }
-        dispatch_(lvl, tag ? tag : "LOG", oss.str().c_str());
+    void Log::write_(LogLevel lvl, const char* tag, const char* file, int line, std::string_view message) noexcept {
+        LineBuffer& b = begin_line(lvl, tag);
+        b.append(message);
+        const size_t bodyEnd = b.len;
+        end_line(b, file, line);
+        dispatch_(make_record(lvl, tag, file, line, b, bodyEnd, nullptr, 0));
+    }
+
+    // Structured logging. Fields are rendered with to_chars for the text
+    // form, and passed through untouched for sinks that want the types.
+    void Log::write_kv(LogLevel lvl, const char* tag, const char* file, int line,
+        const char* message, std::initializer_list<LogField> fields) noexcept {
+        if (!tag) tag = "LOG";
+        if (!enabled_by_name(lvl, tag)) return;
+        write_kv_(lvl, tag, file, line, message, fields);
+    }
+
+    void Log::write_kv(LogLevel lvl, LogTagId tag, const char* file, int line,
+        const char* message, std::initializer_list<LogField> fields) noexcept {
+        write_kv_(lvl, tag_name(tag), file, line, message, fields);
+    }
+
+    void Log::write_kv_(LogLevel lvl, const char* tag, const char* file, int line,
+        const char* message, std::initializer_list<LogField> fields) noexcept {
+        LineBuffer& b = begin_line(lvl, tag);
+        b.append(message ? message : "");
+        const size_t bodyEnd = b.len;
+        append_fields(b, fields);
+        end_line(b, file, line);
+        dispatch_(make_record(lvl, tag, file, line, b, bodyEnd, fields.begin(), fields.size()));
     }
 
-    // Deliver one formatted line to every sink.
-    void Log::dispatch_(LogLevel lvl, const char* tag, const char* formatted) noexcept {
+    // Deliver one record to every sink.
+    void Log::dispatch_(const LogRecord& record) noexcept {
         auto& S = state();
         std::scoped_lock lk(S.mtx);
 
-        // Each sink decides how to render (console/file/IDE window, etc.)  
-        for (auto& s : S.sinks) s->write(lvl, tag, formatted);
+        // Each sink decides how to render (console/file/IDE window, JSON, etc.)
+        for (auto& s : S.sinks) s->write_record(record);
     }
 
 } // namespace eng::debug
@@ -1,7 +1,13 @@
 #pragma once
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <concepts>
 #include <cstdint>
+#include <initializer_list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 /*
 ============================================================================================
@@ -25,8 +31,26 @@
     3) At shutdown:
          eng::debug::Log::shutdown();
 
+  Structured (key/value) logging:
+         LOG_INFO_KV("PERF", "frame", {"ms", 16.6}, {"fps", 60}, {"scene", name});
+     Values keep their type (int/uint/float/bool/string) all the way to the
+    sinks. Text sinks render "frame ms=16.6 fps=60 scene=\"menu\"" with
+    to_chars (no vsnprintf); JsonLinesSink writes one JSON object per line
+    so tools do not have to parse text back apart.
+
+  Filtering (cheapest first):
+     Compile time: LOG_* macros below ENG_LOG_MIN_LEVEL compile to nothing
+      (default: Debug in debug builds, Info when NDEBUG is defined).
+     Per tag: Log::set_tag_level("PERF", LogLevel::Debug) overrides the
+      global level for one tag. Tags are interned to a small LogTagId once
+      per call site (a function-local static inside the macro), so the
+      runtime check is two relaxed atomic loads, never a string compare.
+     Per call site: LOG_*_EVERY_N (1 of every N calls) and LOG_*_RATE (at
+      most N lines per second) for messages inside hot loops.
+
   Notes:
-     "tag" is a short category like "CORE", "PERF", "AI".
+     "tag" is a short category like "CORE", "PERF", "AI". With the macros it
+    must be a string literal (it is interned once per call site).
      If you pass empty file/line to write()/writef(), no "(file:line)" is appended.
      Whether "(file:line)" is printed for normal logs is controlled by
     LogConfig::showSourceInfo (we keep it off by default to keep output clean).
@@ -37,6 +61,22 @@ namespace eng::debug {
     // Logging severity. Lower number = more severe.
     enum class LogLevel : uint8_t { Error = 0, Warn, Info, Debug };
 
+    // Interned tag (see Log::tag_id). Id 0 is the fallback tag "LOG".
+    enum class LogTagId : std::uint16_t {};
+
+    // File rotation / buffering settings used when LogConfig::useFile is on.
+    // See RotatingFileSink in Sinks.h for how each field is applied.
+    struct LogRotation {
+        bool enabled = true;                  // false = plain FileSink (append, flush every line)
+        std::uint64_t maxBytes = 16ull << 20; // rotate when the active file reaches this size (0 = never)
+        std::uint32_t maxSeconds = 0;         // rotate when the active file is this old (0 = never)
+        std::uint32_t keepFiles = 5;          // rotated files kept next to the active one
+        std::size_t bufferBytes = 64 * 1024;  // in-memory buffer before a write to disk
+        std::uint32_t flushIntervalMs = 1000; // background flush of a partly filled buffer
+        LogLevel flushLevel = LogLevel::Error;// lines at this level or more severe flush at once
+        std::string compressCommand;          // e.g. "gzip -q"; run on rotated files (empty = off)
+    };
+
     // Global configuration passed to Log::init().
     struct LogConfig {
         LogLevel level = LogLevel::Info;      // Minimum level that will be printed
@@ -45,6 +85,55 @@ namespace eng::debug {
         bool useFile = true;                  // Append to file at filePath
         bool usePlatformOutput = true;        // Windows: also mirror to OutputDebugString
         bool showSourceInfo = false;          // Append "(file:line)" to normal logs if true
+        std::string tagLevels;                // Per-tag overrides, e.g. "PERF=Debug,AI=Warn"
+        LogRotation rotation;                 // Rotation/buffering of the file at filePath
+        bool useRing = true;                  // Also keep the last lines in a memory-mapped ring file
+        std::string ringPath = "engine.ring"; // Ring file (previous run's ring is kept as <path>.prev)
+        std::size_t ringBytes = 1u << 20;     // Ring data size; older lines are overwritten
+        bool useJson = false;                 // Also write JSON lines (one object per line)
+        std::string jsonPath = "engine.jsonl";// Path of the JSON-lines file
+    };
+
+    // One typed key/value pair for structured logging. Only refers to the
+    // caller's data, so it must not outlive the log call (the macros and
+    // initializer lists guarantee that).
+    struct LogField {
+        enum class Type : std::uint8_t { Int, UInt, Float, Bool, String };
+
+        const char* key;
+        Type type;
+        union {
+            std::int64_t  i;
+            std::uint64_t u;
+            double        f;
+            bool          b;
+        };
+        std::string_view s;   // Type::String only
+
+        LogField(const char* k, bool v) : key(k), type(Type::Bool), b(v) {}
+        template <std::signed_integral T>
+        LogField(const char* k, T v) : key(k), type(Type::Int), i(static_cast<std::int64_t>(v)) {}
+        template <std::unsigned_integral T>
+        LogField(const char* k, T v) : key(k), type(Type::UInt), u(static_cast<std::uint64_t>(v)) {}
+        template <std::floating_point T>
+        LogField(const char* k, T v) : key(k), type(Type::Float), f(static_cast<double>(v)) {}
+        LogField(const char* k, std::string_view v) : key(k), type(Type::String), u(0), s(v) {}
+        LogField(const char* k, const char* v) : LogField(k, std::string_view(v ? v : "")) {}
+        LogField(const char* k, const std::string& v) : LogField(k, std::string_view(v)) {}
+    };
+
+    // Everything known about one log line, handed to ILogSink::write_record.
+    // All views point into per-thread or caller memory: copy what you keep.
+    struct LogRecord {
+        LogLevel level;
+        const char* tag;
+        std::int64_t unixMs;          // wall clock, milliseconds since 1970
+        std::string_view message;     // message body only (no prefix, no fields)
+        const LogField* fields;       // key/value pairs (may be empty)
+        std::size_t fieldCount;
+        const char* file;             // empty unless LogConfig::showSourceInfo
+        int line;
+        std::string_view text;        // full rendered line, as passed to write()
     };
 
     // A sink is a destination for a formatted log line.
@@ -52,7 +141,13 @@ namespace eng::debug {
     struct ILogSink {
         virtual ~ILogSink() = default;
         // 'msg' is already fully formatted and contains timestamp/level/tag.
-        virtual void write(LogLevel lvl, const char* tag, const char* msg) = 0;
+        // It points into a per-thread buffer: copy it if you keep it, and do
+        // not rely on a trailing newline (sinks add their own).
+        virtual void write(LogLevel lvl, const char* tag, std::string_view msg) = 0;
+
+        // Structured entry point; Log calls this for every line. Text sinks
+        // keep the default, which forwards the rendered line to write().
+        virtual void write_record(const LogRecord& r) { write(r.level, r.tag, r.text); }
     };
 
     // Central logging facade used via static methods.
@@ -68,6 +163,27 @@ namespace eng::debug {
         static void set_level(LogLevel lvl);
         static LogLevel get_level();
 
+        // Max number of distinct tags; later tags share id 0 ("LOG").
+        static constexpr std::size_t kMaxTags = 256;
+
+        // Intern 'tag' and return its id (same id for equal strings). Takes a
+        // lock; the LOG_* macros call it once per call site.
+        static LogTagId tag_id(const char* tag);
+
+        // Name of an interned tag (stable pointer for the process lifetime).
+        static const char* tag_name(LogTagId id) noexcept;
+
+        // Per-tag level override; clear_tag_level() goes back to the global level.
+        static void set_tag_level(const char* tag, LogLevel lvl);
+        static void clear_tag_level(const char* tag);
+
+        // Parse "TAG=Level,TAG=Level" (levels: Error/Warn/Info/Debug, any
+        // case) and apply each pair. Returns false if any part was invalid.
+        static bool set_tag_levels(std::string_view spec);
+
+        // Would a line at 'lvl' for this tag be printed? Lock-free.
+        static bool enabled(LogLevel lvl, LogTagId tag) noexcept;
+
         // Add a custom sink (e.g., network sink). Takes ownership of the pointer.
         static void add_sink(std::unique_ptr<ILogSink> sink);
 
@@ -86,24 +202,143 @@ namespace eng::debug {
             const char* file, int line,
             const std::string& message) noexcept;
 
+        // Same as above for an interned tag. These do not re-check the level;
+        // the LOG_* macros call enabled() first so arguments are not evaluated
+        // for filtered lines.
+        static void writef(LogLevel lvl, LogTagId tag,
+            const char* file, int line,
+            const char* fmt, ...) noexcept;
+        static void write(LogLevel lvl, LogTagId tag,
+            const char* file, int line,
+            const std::string& message) noexcept;
+
+        // Structured log: 'message' plus typed fields. Example:
+        //   Log::write_kv(LogLevel::Info, "PERF", "", 0, "frame", { {"ms", 16.6}, {"fps", 60} });
+        static void write_kv(LogLevel lvl, const char* tag,
+            const char* file, int line,
+            const char* message, std::initializer_list<LogField> fields) noexcept;
+        static void write_kv(LogLevel lvl, LogTagId tag,
+            const char* file, int line,
+            const char* message, std::initializer_list<LogField> fields) noexcept;
+
+        // Lines dropped by LOG_*_EVERY_N / LOG_*_RATE so far (all call sites).
+        static std::uint64_t suppressed_count() noexcept;
+        static void add_suppressed_(std::uint32_t n) noexcept;
+
     private:
-        // Deliver one fully formatted line to every registered sink.
-        static void dispatch_(LogLevel lvl, const char* tag, const char* formatted) noexcept;
+        static void vwritef_(LogLevel lvl, const char* tag, const char* file, int line,
+            const char* fmt, va_list ap) noexcept;
+        static void write_(LogLevel lvl, const char* tag, const char* file, int line,
+            std::string_view message) noexcept;
+        static void write_kv_(LogLevel lvl, const char* tag, const char* file, int line,
+            const char* message, std::initializer_list<LogField> fields) noexcept;
+
+        // Deliver one record (and its rendered line) to every registered sink.
+        static void dispatch_(const LogRecord& record) noexcept;
+    };
+
+    // Per-call-site limiter used by LOG_*_RATE: lets through at most
+    // 'perSecond' lines in each one-second window and counts the rest.
+    // Lives in a function-local static, so it has no constructor work.
+    struct LogRateLimiter {
+        std::atomic<std::int64_t>  windowStartMs{ -1000000 };
+        std::atomic<std::uint32_t> inWindow{ 0 };
+
+        bool allow(std::uint32_t perSecond) noexcept;
     };
 
 // ================================ Convenience macros ================================
 // These macros automatically capture __FILE__ and __LINE__ so your log can
 // include them when showSourceInfo==true (or you can read them in sinks).
-// Use the *0 macros if you already have a std::string and don�t need printf.
+// Use the *0 macros if you already have a std::string and don't need printf.
+// Arguments are only evaluated when the line will actually be printed.
+
+// Compile-time floor: 0=Error, 1=Warn, 2=Info, 3=Debug. Calls below it expand
+// to a dead "if (false)" so the format string is still type-checked but no
+// code or string data is emitted.
+#ifndef ENG_LOG_MIN_LEVEL
+#  if defined(NDEBUG)
+#    define ENG_LOG_MIN_LEVEL 2
+#  else
+#    define ENG_LOG_MIN_LEVEL 3
+#  endif
+#endif
+
+#define ENG_LOG_AT_(LVL, WRITE, TAG, ...) do { \
+        static const ::eng::debug::LogTagId eng_log_tag_ = ::eng::debug::Log::tag_id(TAG); \
+        if (::eng::debug::Log::enabled(LVL, eng_log_tag_)) \
+            ::eng::debug::Log::WRITE(LVL, eng_log_tag_, __FILE__, __LINE__, __VA_ARGS__); \
+    } while (0)
+
+// Only 1 of every N calls from this call site is logged.
+#define ENG_LOG_EVERY_N_(LVL, TAG, N, ...) do { \
+        static const ::eng::debug::LogTagId eng_log_tag_ = ::eng::debug::Log::tag_id(TAG); \
+        static std::atomic<std::uint32_t> eng_log_n_{ 0 }; \
+        if (::eng::debug::Log::enabled(LVL, eng_log_tag_)) { \
+            if (eng_log_n_.fetch_add(1, std::memory_order_relaxed) % (N) == 0) \
+                ::eng::debug::Log::writef(LVL, eng_log_tag_, __FILE__, __LINE__, __VA_ARGS__); \
+            else ::eng::debug::Log::add_suppressed_(1); \
+        } \
+    } while (0)
+
+// At most PER_SEC lines per second from this call site.
+#define ENG_LOG_RATE_(LVL, TAG, PER_SEC, ...) do { \
+        static const ::eng::debug::LogTagId eng_log_tag_ = ::eng::debug::Log::tag_id(TAG); \
+        static ::eng::debug::LogRateLimiter eng_log_rl_; \
+        if (::eng::debug::Log::enabled(LVL, eng_log_tag_) && eng_log_rl_.allow(PER_SEC)) \
+            ::eng::debug::Log::writef(LVL, eng_log_tag_, __FILE__, __LINE__, __VA_ARGS__); \
+    } while (0)
+
+#define ENG_LOG_OFF_(LVL, ...) do { if (false) ::eng::debug::Log::writef(LVL, "", nullptr, 0, __VA_ARGS__); } while (0)
+#define ENG_LOG_OFF0_(LVL, MSG) do { if (false) ::eng::debug::Log::write(LVL, "", nullptr, 0, MSG); } while (0)
+#define ENG_LOG_OFF_KV_(LVL, MSG, ...) do { if (false) ::eng::debug::Log::write_kv(LVL, "", nullptr, 0, MSG, { __VA_ARGS__ }); } while (0)
+
+#define LOG_ERROR(TAG, ...)  ENG_LOG_AT_(::eng::debug::LogLevel::Error, writef, TAG, __VA_ARGS__)
+#define LOG_ERROR0(TAG, MSG) ENG_LOG_AT_(::eng::debug::LogLevel::Error, write, TAG, MSG)
+#define LOG_ERROR_KV(TAG, MSG, ...) ENG_LOG_AT_(::eng::debug::LogLevel::Error, write_kv, TAG, MSG, { __VA_ARGS__ })
+#define LOG_ERROR_EVERY_N(TAG, N, ...)     ENG_LOG_EVERY_N_(::eng::debug::LogLevel::Error, TAG, N, __VA_ARGS__)
+#define LOG_ERROR_RATE(TAG, PER_SEC, ...)  ENG_LOG_RATE_(::eng::debug::LogLevel::Error, TAG, PER_SEC, __VA_ARGS__)
+
+#if ENG_LOG_MIN_LEVEL >= 1
+#define LOG_WARN(TAG, ...)   ENG_LOG_AT_(::eng::debug::LogLevel::Warn, writef, TAG, __VA_ARGS__)
+#define LOG_WARN0(TAG, MSG)  ENG_LOG_AT_(::eng::debug::LogLevel::Warn, write, TAG, MSG)
+#define LOG_WARN_KV(TAG, MSG, ...) ENG_LOG_AT_(::eng::debug::LogLevel::Warn, write_kv, TAG, MSG, { __VA_ARGS__ })
+#define LOG_WARN_EVERY_N(TAG, N, ...)      ENG_LOG_EVERY_N_(::eng::debug::LogLevel::Warn, TAG, N, __VA_ARGS__)
+#define LOG_WARN_RATE(TAG, PER_SEC, ...)   ENG_LOG_RATE_(::eng::debug::LogLevel::Warn, TAG, PER_SEC, __VA_ARGS__)
+#else
+#define LOG_WARN(TAG, ...)   ENG_LOG_OFF_(::eng::debug::LogLevel::Warn, __VA_ARGS__)
+#define LOG_WARN0(TAG, MSG)  ENG_LOG_OFF0_(::eng::debug::LogLevel::Warn, MSG)
+#define LOG_WARN_KV(TAG, MSG, ...) ENG_LOG_OFF_KV_(::eng::debug::LogLevel::Warn, MSG, __VA_ARGS__)
+#define LOG_WARN_EVERY_N(TAG, N, ...)      ENG_LOG_OFF_(::eng::debug::LogLevel::Warn, __VA_ARGS__)
+#define LOG_WARN_RATE(TAG, PER_SEC, ...)   ENG_LOG_OFF_(::eng::debug::LogLevel::Warn, __VA_ARGS__)
+#endif
 
-#define LOG_ERROR(TAG, FMT, ...) ::eng::debug::Log::writef(::eng::debug::LogLevel::Error, TAG, __FILE__, __LINE__, FMT, __VA_ARGS__)
-#define LOG_WARN(TAG,  FMT, ...) ::eng::debug::Log::writef(::eng::debug::LogLevel::Warn,  TAG, __FILE__, __LINE__, FMT, __VA_ARGS__)
-#define LOG_INFO(TAG,  FMT, ...) ::eng::debug::Log::writef(::eng::debug::LogLevel::Info,  TAG, __FILE__, __LINE__, FMT, __VA_ARGS__)
-#define LOG_DEBUG(TAG, FMT, ...) ::eng::debug::Log::writef(::eng::debug::LogLevel::Debug, TAG, __FILE__, __LINE__, FMT, __VA_ARGS__)
+#if ENG_LOG_MIN_LEVEL >= 2
+#define LOG_INFO(TAG, ...)   ENG_LOG_AT_(::eng::debug::LogLevel::Info, writef, TAG, __VA_ARGS__)
+#define LOG_INFO0(TAG, MSG)  ENG_LOG_AT_(::eng::debug::LogLevel::Info, write, TAG, MSG)
+#define LOG_INFO_KV(TAG, MSG, ...) ENG_LOG_AT_(::eng::debug::LogLevel::Info, write_kv, TAG, MSG, { __VA_ARGS__ })
+#define LOG_INFO_EVERY_N(TAG, N, ...)      ENG_LOG_EVERY_N_(::eng::debug::LogLevel::Info, TAG, N, __VA_ARGS__)
+#define LOG_INFO_RATE(TAG, PER_SEC, ...)   ENG_LOG_RATE_(::eng::debug::LogLevel::Info, TAG, PER_SEC, __VA_ARGS__)
+#else
+#define LOG_INFO(TAG, ...)   ENG_LOG_OFF_(::eng::debug::LogLevel::Info, __VA_ARGS__)
+#define LOG_INFO0(TAG, MSG)  ENG_LOG_OFF0_(::eng::debug::LogLevel::Info, MSG)
+#define LOG_INFO_KV(TAG, MSG, ...) ENG_LOG_OFF_KV_(::eng::debug::LogLevel::Info, MSG, __VA_ARGS__)
+#define LOG_INFO_EVERY_N(TAG, N, ...)      ENG_LOG_OFF_(::eng::debug::LogLevel::Info, __VA_ARGS__)
+#define LOG_INFO_RATE(TAG, PER_SEC, ...)   ENG_LOG_OFF_(::eng::debug::LogLevel::Info, __VA_ARGS__)
+#endif
 
-#define LOG_ERROR0(TAG, MSG) ::eng::debug::Log::write(::eng::debug::LogLevel::Error, TAG, __FILE__, __LINE__, MSG)
-#define LOG_WARN0(TAG,  MSG) ::eng::debug::Log::write(::eng::debug::LogLevel::Warn,  TAG, __FILE__, __LINE__, MSG)
-#define LOG_INFO0(TAG,  MSG) ::eng::debug::Log::write(::eng::debug::LogLevel::Info,  TAG, __FILE__, __LINE__, MSG)
-#define LOG_DEBUG0(TAG, MSG) ::eng::debug::Log::write(::eng::debug::LogLevel::Debug, TAG, __FILE__, __LINE__, MSG)
+#if ENG_LOG_MIN_LEVEL >= 3
+#define LOG_DEBUG(TAG, ...)  ENG_LOG_AT_(::eng::debug::LogLevel::Debug, writef, TAG, __VA_ARGS__)
+#define LOG_DEBUG0(TAG, MSG) ENG_LOG_AT_(::eng::debug::LogLevel::Debug, write, TAG, MSG)
+#define LOG_DEBUG_KV(TAG, MSG, ...) ENG_LOG_AT_(::eng::debug::LogLevel::Debug, write_kv, TAG, MSG, { __VA_ARGS__ })
+#define LOG_DEBUG_EVERY_N(TAG, N, ...)     ENG_LOG_EVERY_N_(::eng::debug::LogLevel::Debug, TAG, N, __VA_ARGS__)
+#define LOG_DEBUG_RATE(TAG, PER_SEC, ...)  ENG_LOG_RATE_(::eng::debug::LogLevel::Debug, TAG, PER_SEC, __VA_ARGS__)
+#else
+#define LOG_DEBUG(TAG, ...)  ENG_LOG_OFF_(::eng::debug::LogLevel::Debug, __VA_ARGS__)
+#define LOG_DEBUG0(TAG, MSG) ENG_LOG_OFF0_(::eng::debug::LogLevel::Debug, MSG)
+#define LOG_DEBUG_KV(TAG, MSG, ...) ENG_LOG_OFF_KV_(::eng::debug::LogLevel::Debug, MSG, __VA_ARGS__)
+#define LOG_DEBUG_EVERY_N(TAG, N, ...)     ENG_LOG_OFF_(::eng::debug::LogLevel::Debug, __VA_ARGS__)
+#define LOG_DEBUG_RATE(TAG, PER_SEC, ...)  ENG_LOG_OFF_(::eng::debug::LogLevel::Debug, __VA_ARGS__)
+#endif
 
 } // namespace eng::debug
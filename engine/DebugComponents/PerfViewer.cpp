@@ -1,9 +1,11 @@
 #include "PerfViewer.h"
 #include "Log.h"
+#include "Telemetry.h"
 #include <algorithm>
 #include <cstdio>
 #include <sstream>
 #include <iomanip>
+#include <iterator>
 
 /*
 ===============================================================================
@@ -17,10 +19,18 @@
    - After end_frame() we advance s_head_ (circularly).
    - This allows export_csv(...) to dump a recent history window.
 
+ Categories
+   - s_categories_ holds the display names; a CategoryId is an index into it.
+   - Every FrameSample::sysTicks vector has one entry per category. Adding a
+     category resizes all ring slots once (startup cost only), so the hot
+     path in record_ticks() is a bounds check plus an integer add.
+   - Stats (s_stats_, FrameSample::stats) work the same way for counts.
+
  Printing "Perf %"
    - print_if_due_() checks if s_printIntervalSec_ seconds have passed.
    - We print the breakdown for the last completed frame, to avoid partial data.
-   - Percent for one subsystem = (sysSec / frameSec) * 100.
+   - Percent for one subsystem = (sysTicks / frameTicks) * 100. Both are in
+     the same unit, so no calibration is needed for percentages.
 
  Error handling and safety
    - Functions are noexcept where reasonable to keep perf profiling non-intrusive.
@@ -33,9 +43,12 @@ namespace eng::debug {
 
     // Static storage definitions
     PerfViewer::FrameSample PerfViewer::s_ring_[PerfViewer::kBuffer]{};
+    std::vector<std::string> PerfViewer::s_categories_;
+    std::vector<std::string> PerfViewer::s_stats_;
     int   PerfViewer::s_head_ = 0;
     bool  PerfViewer::s_inFrame_ = false;
-    PerfViewer::clock::time_point PerfViewer::s_frameStart_{};
+    std::uint64_t PerfViewer::s_frameIndex_ = 0;
+    TscClock::ticks PerfViewer::s_frameStart_ = 0;
     PerfViewer::clock::time_point PerfViewer::s_lastPrint_{};
     double PerfViewer::s_printIntervalSec_ = 1.0;
 
@@ -48,19 +61,71 @@ namespace eng::debug {
     void PerfViewer::ensure_init_() noexcept {
         static bool inited = false;
         if (!inited) {
+            inited = true;
             s_head_ = 0;
             s_inFrame_ = false;
             s_lastPrint_ = clock::now();
 
+            // Built-ins first, in enum order, so Subsystem values are valid ids.
+            static const char* const kBuiltins[] = {
+                "Graphics", "Physics", "AI", "Audio", "Gameplay", "IO", "Other"
+            };
+            static_assert(std::size(kBuiltins) == (size_t)Subsystem::COUNT,
+                "Built-in category names must match the Subsystem enum");
+            for (const char* name : kBuiltins) {
+                s_categories_.emplace_back(name);
+            }
+
             // Clear all ring buffer slots
             for (auto& f : s_ring_) {
-                f.frameSec = 0.0;
-                std::fill(f.sysSec.begin(), f.sysSec.end(), 0.0);
+                f.frameTicks = 0;
+                f.sysTicks.assign(s_categories_.size(), 0);
+                f.sysCounters.assign(s_categories_.size(), HwCounterValues{});
             }
-            inited = true;
         }
     }
 
+    // Register (or look up) a named category. Linear search is fine: this
+    // runs a handful of times at startup, never per frame.
+    CategoryId PerfViewer::register_category(std::string_view name) {
+        ensure_init_();
+        for (size_t i = 0; i < s_categories_.size(); ++i) {
+            if (s_categories_[i] == name) return static_cast<CategoryId>(i);
+        }
+
+        s_categories_.emplace_back(name);
+        for (auto& f : s_ring_) {
+            f.sysTicks.resize(s_categories_.size(), 0);
+            f.sysCounters.resize(s_categories_.size());
+        }
+        return static_cast<CategoryId>(s_categories_.size() - 1);
+    }
+
+    // Register (or look up) a named stat. Startup only, like categories.
+    StatId PerfViewer::register_stat(std::string_view name) {
+        ensure_init_();
+        for (size_t i = 0; i < s_stats_.size(); ++i) {
+            if (s_stats_[i] == name) return static_cast<StatId>(i);
+        }
+
+        s_stats_.emplace_back(name);
+        for (auto& f : s_ring_) {
+            f.stats.resize(s_stats_.size(), 0);
+        }
+        return static_cast<StatId>(s_stats_.size() - 1);
+    }
+
+    std::size_t PerfViewer::category_count() noexcept {
+        ensure_init_();
+        return s_categories_.size();
+    }
+
+    const std::string& PerfViewer::category_name(CategoryId cat) noexcept {
+        ensure_init_();
+        static const std::string kUnknown = "Unknown";
+        return (cat < s_categories_.size()) ? s_categories_[cat] : kUnknown;
+    }
+
     // Begin a new frame: clear the current slot and mark start time.
     void PerfViewer::begin_frame() noexcept {
         ensure_init_();
@@ -69,21 +134,58 @@ namespace eng::debug {
         if (s_inFrame_) end_frame();
 
         s_inFrame_ = true;
-        s_frameStart_ = clock::now();
+        s_frameStart_ = TscClock::now();
 
-        // Reset the subsystem accumulators for the current slot.
+        // Reset the category accumulators for the current slot.
         auto& f = s_ring_[s_head_];
-        f.frameSec = 0.0;
-        std::fill(f.sysSec.begin(), f.sysSec.end(), 0.0);
+        f.frameTicks = 0;
+        std::fill(f.sysTicks.begin(), f.sysTicks.end(), 0);
+        std::fill(f.sysCounters.begin(), f.sysCounters.end(), HwCounterValues{});
+        std::fill(f.stats.begin(), f.stats.end(), 0);
+    }
+
+    // Copy the newest completed frames (plus the open one) for a crash
+    // snapshot. Reads the ring in place; categories beyond a slot's size are 0.
+    std::size_t PerfViewer::copy_recent_frames(TscClock::ticks* out, std::size_t maxFrames,
+        std::size_t catCount, bool& partial) noexcept {
+        partial = false;
+        if (!out || maxFrames == 0) return 0;
+
+        const std::size_t open = s_inFrame_ ? 1 : 0;
+        std::size_t done = static_cast<std::size_t>(std::min<std::uint64_t>(s_frameIndex_, kBuffer - 1));
+        if (done + open > maxFrames) done = maxFrames - open;
+
+        std::size_t written = 0;
+        auto emit = [&](const FrameSample& f, TscClock::ticks frameTicks) {
+            TscClock::ticks* row = out + written * (catCount + 1);
+            row[0] = frameTicks;
+            for (std::size_t c = 0; c < catCount; ++c) row[c + 1] = (c < f.sysTicks.size()) ? f.sysTicks[c] : 0;
+            ++written;
+        };
+
+        for (std::size_t k = done; k > 0; --k) {
+            const auto& f = s_ring_[(s_head_ + kBuffer - static_cast<int>(k)) % kBuffer];
+            emit(f, f.frameTicks);
+        }
+        if (open) {
+            emit(s_ring_[s_head_], TscClock::now() - s_frameStart_);
+            partial = true;
+        }
+        return written;
     }
 
     // End the current frame: store total frame time, maybe print, advance head.
     void PerfViewer::end_frame() noexcept {
         if (!s_inFrame_) return;
-        using namespace std::chrono;
 
         auto& f = s_ring_[s_head_];
-        f.frameSec = duration_cast<duration<double>>(clock::now() - s_frameStart_).count();
+        f.frameTicks = TscClock::now_ordered() - s_frameStart_;
+
+        // Hand the finished frame to the live telemetry stream (lock-free queue).
+        if (Telemetry::running()) {
+            Telemetry::publish_frame(s_frameIndex_, f.frameTicks, f.sysTicks.data(), f.sysTicks.size());
+        }
+        ++s_frameIndex_;
 
         // Periodically print the last completed frame's percentages.
         print_if_due_();
@@ -93,29 +195,39 @@ namespace eng::debug {
         s_inFrame_ = false;
     }
 
-    // Accumulate seconds for a given subsystem in the current frame.
-    void PerfViewer::record(Subsystem sys, double seconds) noexcept {
+    // Accumulate ticks for a given category in the current frame.
+    void PerfViewer::record_ticks(CategoryId cat, TscClock::ticks ticks) noexcept {
         if (!s_inFrame_) return; // ignore if no frame is active
         auto& f = s_ring_[s_head_];
-        const auto idx = static_cast<size_t>(sys);
-        if (idx < f.sysSec.size()) {
-            f.sysSec[idx] += seconds;
+        if (cat < f.sysTicks.size()) {
+            f.sysTicks[cat] += ticks;
         }
     }
 
-    // Convert enum to display name for printing/export.
-    const char* PerfViewer::sys_name_(Subsystem s) noexcept {
-        switch (s) {
-        case Subsystem::Graphics: return "Graphics";
-        case Subsystem::Physics:  return "Physics";
-        case Subsystem::AI:       return "AI";
-        case Subsystem::Audio:    return "Audio";
-        case Subsystem::Gameplay: return "Gameplay";
-        case Subsystem::IO:       return "IO";
-        default:                  return "Other";
+    // Accumulate hardware counter deltas for a given category.
+    void PerfViewer::record_counters(CategoryId cat, const HwCounterValues& delta) noexcept {
+        if (!s_inFrame_) return;
+        auto& f = s_ring_[s_head_];
+        if (cat < f.sysCounters.size()) {
+            auto& acc = f.sysCounters[cat];
+            for (size_t i = 0; i < acc.v.size(); ++i) acc.v[i] += delta.v[i];
         }
     }
 
+    // Accumulate a per-frame stat.
+    void PerfViewer::add_stat(StatId stat, std::uint64_t value) noexcept {
+        if (!s_inFrame_) return;
+        auto& f = s_ring_[s_head_];
+        if (stat < f.stats.size()) {
+            f.stats[stat] += value;
+        }
+    }
+
+    // Seconds-based variant: convert once and reuse the tick path.
+    void PerfViewer::record(CategoryId cat, double seconds) noexcept {
+        record_ticks(cat, TscClock::from_seconds(seconds));
+    }
+
     // If enough time has passed, print one compact "Perf %" line for the
     // last completed frame. We avoid printing the current frame because
     // it may not be done yet.
@@ -129,26 +241,49 @@ namespace eng::debug {
         // Snapshot the most recently completed frame:
         const int last = (s_head_ - 1 + kBuffer) % kBuffer;
         const auto& f = s_ring_[last];
-        if (f.frameSec <= 0.0) return;  // nothing meaningful to print
+        if (f.frameTicks == 0) return;  // nothing meaningful to print
 
         std::ostringstream oss;
         oss << std::fixed << std::setprecision(1);
         oss << "Perf %: ";
         bool first = true;
-        for (int i = 0; i < (int)Subsystem::COUNT; ++i) {
-            const double sec = f.sysSec[(size_t)i];
-            if (sec <= 0.0) continue;
+        for (size_t i = 0; i < f.sysTicks.size(); ++i) {
+            const auto ticks = f.sysTicks[i];
+            if (ticks == 0) continue;
 
             // Percent of frame time, clamped to [0, 100].
-            const double pct = std::clamp(sec / f.frameSec * 100.0, 0.0, 100.0);
+            const double pct = std::clamp((double)ticks / (double)f.frameTicks * 100.0, 0.0, 100.0);
             if (!first) oss << " | ";
             first = false;
-            oss << sys_name_((Subsystem)i) << " " << pct << "%";
+            oss << s_categories_[i] << " " << pct << "%";
+
+            // Hardware counters, if this category had a DBG_SCOPE_HW scope:
+            // IPC and misses per 1000 instructions (MPKI) are comparable
+            // across frames of different length.
+            const auto& hw = f.sysCounters[i];
+            const double instr = (double)hw[HwEvent::Instructions];
+            if (instr > 0.0) {
+                const double cycles = (double)hw[HwEvent::Cycles];
+                oss << " [IPC " << std::setprecision(2) << (cycles > 0.0 ? instr / cycles : 0.0)
+                    << std::setprecision(1)
+                    << ", L1 " << (double)hw[HwEvent::L1DMisses] * 1000.0 / instr
+                    << ", LLC " << (double)hw[HwEvent::LLCMisses] * 1000.0 / instr
+                    << ", BR " << (double)hw[HwEvent::BranchMisses] * 1000.0 / instr
+                    << " /kI]";
+            }
         }
         if (first) {
 
-            // No subsystems were measured in that frame (e.g., profiling disabled).
-            oss << "(no subsystems measured)";
+            // No categories were measured in that frame (e.g., profiling disabled).
+            oss << "(no categories measured)";
+        }
+
+        // Non-time stats of the same frame, e.g. "|| GL binds 42, GL binds elided 130"
+        bool firstStat = true;
+        for (size_t i = 0; i < f.stats.size(); ++i) {
+            if (f.stats[i] == 0) continue;
+            oss << (firstStat ? " || " : ", ") << s_stats_[i] << " " << f.stats[i];
+            firstStat = false;
         }
 
         // Send a single clean line to the logging system.
@@ -158,8 +293,11 @@ namespace eng::debug {
 
     // Export the ring buffer contents to a CSV file.
     // The CSV contains:
-    //   frame, frame_ms, Graphics_ms, Physics_ms, ...
-    // Only frames with frameSec > 0 are written.
+    //   frame, frame_ms, Graphics_ms, Physics_ms, ..., <registered>_ms
+    // and, if HwCounters were ever enabled, raw counter columns per category:
+    //   Graphics_instr, Graphics_cycles, Graphics_l1_miss, ...
+    // followed by one column per registered stat.
+    // Only frames with frameTicks > 0 are written.
     // Export the ring buffer contents to a CSV file.
     bool PerfViewer::export_csv(const std::string& path) {
         std::FILE* fp = nullptr;
@@ -177,8 +315,19 @@ namespace eng::debug {
 
         // Header row
         std::fprintf(fp, "frame,frame_ms");
-        for (int i = 0; i < (int)Subsystem::COUNT; ++i) {
-            std::fprintf(fp, ",%s_ms", sys_name_((Subsystem)i));
+        for (const auto& name : s_categories_) {
+            std::fprintf(fp, ",%s_ms", name.c_str());
+        }
+        const bool withCounters = HwCounters::ever_enabled();
+        if (withCounters) {
+            for (const auto& name : s_categories_) {
+                for (size_t e = 0; e < (size_t)HwEvent::COUNT; ++e) {
+                    std::fprintf(fp, ",%s_%s", name.c_str(), HwCounters::event_name((HwEvent)e));
+                }
+            }
+        }
+        for (const auto& name : s_stats_) {
+            std::fprintf(fp, ",%s", name.c_str());
         }
         std::fprintf(fp, "\n");
 
@@ -187,11 +336,21 @@ namespace eng::debug {
         for (int i = 0; i < kBuffer; ++i) {
             const int idx = (s_head_ + i) % kBuffer;
             const auto& f = s_ring_[idx];
-            if (f.frameSec <= 0.0) continue;
+            if (f.frameTicks == 0) continue;
 
-            std::fprintf(fp, "%d,%.3f", frameId++, f.frameSec * 1000.0);
-            for (int j = 0; j < (int)Subsystem::COUNT; ++j) {
-                std::fprintf(fp, ",%.3f", f.sysSec[(size_t)j] * 1000.0);
+            std::fprintf(fp, "%d,%.3f", frameId++, TscClock::to_seconds(f.frameTicks) * 1000.0);
+            for (const auto ticks : f.sysTicks) {
+                std::fprintf(fp, ",%.3f", TscClock::to_seconds(ticks) * 1000.0);
+            }
+            if (withCounters) {
+                for (const auto& hw : f.sysCounters) {
+                    for (const auto value : hw.v) {
+                        std::fprintf(fp, ",%llu", (unsigned long long)value);
+                    }
+                }
+            }
+            for (const auto value : f.stats) {
+                std::fprintf(fp, ",%llu", (unsigned long long)value);
             }
             std::fprintf(fp, "\n");
         }
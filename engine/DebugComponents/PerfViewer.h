@@ -1,35 +1,49 @@
 #pragma once
-#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
-#include "Trace.h" 
+#include <string_view>
+#include <vector>
+#include "Trace.h"
+#include "Tsc.h"
+#include "HwCounters.h"
 
 /*
 ===============================================================================
  PerfViewer.h
  ------------------------------------------------------------------------------
  Purpose
-   PerfViewer aggregates per-frame time spent in each "Subsystem" (Graphics,
-   Physics, etc.) and provides:
+   PerfViewer aggregates per-frame time spent in each profiling category
+   (Graphics, Window, Collision, etc.) and provides:
+     - register_category(name): add a named category at startup.
      - begin_frame() / end_frame(): mark the frame boundary.
-     - record(sys, seconds): add time to a subsystem inside the current frame.
+     - record_ticks(cat, ticks): add TSC ticks to a category inside the
+       current frame (the hot path used by ScopeTimer).
+     - record(cat, seconds): same, for callers that already have seconds.
+     - record_counters(cat, delta): add hardware counter deltas (HwCounters.h)
+       for scopes opened with DBG_SCOPE_HW.
+     - register_stat(name) / add_stat(stat, n): per-frame counts that are
+       not times (e.g. GL calls issued / elided by GLState).
      - set_print_interval(seconds): print percentages once every N seconds.
      - export_csv(path): dump recent frames to a CSV file.
 
  High-level design
-   - While a frame is "open", calls to record(...) add seconds to the current
-     frame slot in a ring buffer.
+   - While a frame is "open", calls to record_ticks(...) add integer ticks to
+     the current frame slot in a ring buffer. Ticks are only converted to
+     seconds (TscClock::to_seconds) when printing or exporting.
    - end_frame() finalizes that slot by storing the total frame time.
    - At a fixed interval (default 1 second), we print the last completed
-     frame's subsystem percentages, e.g. "Graphics 28.4% | Physics 5.2%".
+     frame's category percentages, e.g. "Graphics 28.4% | Collision 5.2%".
    - A ring buffer stores the last kBuffer frames so we can export them later.
 
  Usage
+   // Once, at startup:
+   static const auto kParticles = PerfViewer::register_category("Particles");
+
    PerfViewer::begin_frame();
    {
-       DBG_SCOPE_SYS("Graphics", eng::debug::Subsystem::Graphics);
-       // draw calls...
+       DBG_SCOPE_SYS("Particles", kParticles);
+       // particle update...
    }
    PerfViewer::end_frame();
 
@@ -43,30 +57,83 @@
      end_frame() at the end, once per frame.
    - record(...) is usually called indirectly via ScopeTimer (DBG_SCOPE_SYS).
    - The ring buffer length (kBuffer) defines how many recent frames are kept.
+   - The built-in Subsystem values are registered first, so their enum values
+     are valid category ids. Per-frame storage grows with each registration.
+   - Categories with counter data get a bracket after their percentage in the
+     periodic print (IPC and misses per 1k instructions), and the CSV gets
+     <name>_instr, <name>_cycles, ... columns once HwCounters were enabled.
+   - If the Telemetry server is running, end_frame() also queues the frame
+     for streaming (see Telemetry.h).
+   - register_category() is meant for startup on the main thread; it is not
+     synchronized against record_ticks() on other threads.
+   - Stats are summed per frame like ticks. The periodic print appends the
+     non-zero ones after the percentages ("|| GL issued 42, ..."), and the
+     CSV gets one column per stat.
 ===============================================================================
 */
 
 namespace eng::debug {
 
+    // Index of a per-frame stat registered with PerfViewer::register_stat().
+    using StatId = std::uint16_t;
+
     class PerfViewer {
     public:
 
         // Call at the very start of a frame. This marks a new slot in the ring
-        // buffer and clears any previous subsystem accumulators for that slot.
+        // buffer and clears any previous category accumulators for that slot.
         static void begin_frame() noexcept;
 
         // Call at the very end of a frame. This computes the full frame
         // duration and finalizes the slot. It may also trigger a periodic print.
         static void end_frame() noexcept;
 
-        // Add 'seconds' to the accumulator for the given subsystem in the
-        // current frame slot. Typically called by ScopeTimer's destructor.
-        static void record(Subsystem sys, double seconds) noexcept;
+        // Register a named category and return its id. Registering an
+        // existing name returns the id it already has.
+        static CategoryId register_category(std::string_view name);
+
+        // Number of registered categories and their display names.
+        static std::size_t category_count() noexcept;
+        static const std::string& category_name(CategoryId cat) noexcept;
+
+        // Add 'ticks' (TscClock units) to the accumulator for the given
+        // category in the current frame slot. Called by ScopeTimer's destructor.
+        static void record_ticks(CategoryId cat, TscClock::ticks ticks) noexcept;
+        static void record_ticks(Subsystem sys, TscClock::ticks ticks) noexcept {
+            record_ticks(static_cast<CategoryId>(sys), ticks);
+        }
+
+        // Add hardware counter deltas to the given category (DBG_SCOPE_HW).
+        static void record_counters(CategoryId cat, const HwCounterValues& delta) noexcept;
+
+        // Convenience for callers that measured seconds themselves.
+        static void record(CategoryId cat, double seconds) noexcept;
+        static void record(Subsystem sys, double seconds) noexcept {
+            record(static_cast<CategoryId>(sys), seconds);
+        }
+
+        // Register a named per-frame count and return its id (same name,
+        // same id). Startup only, like register_category().
+        static StatId register_stat(std::string_view name);
+
+        // Add 'value' to the stat in the current frame slot.
+        static void add_stat(StatId stat, std::uint64_t value) noexcept;
 
         // Dump recent frames from the ring buffer to a CSV file.
         // Returns true on success, false if the file could not be opened.
         static bool export_csv(const std::string& path);
 
+        // Crash-time copy of the most recent frames, oldest first, with no
+        // locks or allocation (CrashSnapshot calls it from a signal handler).
+        // Each frame is written to 'out' as frameTicks followed by 'catCount'
+        // category ticks. A frame that is still open is appended last with
+        // its ticks so far, and 'partial' is set. Returns frames written.
+        static std::size_t copy_recent_frames(TscClock::ticks* out, std::size_t maxFrames,
+            std::size_t catCount, bool& partial) noexcept;
+
+        // Number of frames completed so far (incremented by end_frame()).
+        static std::uint64_t frame_index() noexcept { return s_frameIndex_; }
+
         // Change how often (in seconds) we print percentages to the log.
         // Default is 1.0s. Values <= 0 are clamped to 1.0.
         static void set_print_interval(double seconds) noexcept;
@@ -77,17 +144,24 @@ namespace eng::debug {
         // One frame's worth of timing data
         struct FrameSample {
 
-            // Accumulated seconds for each subsystem in this frame
-            std::array<double, (size_t)Subsystem::COUNT> sysSec{};
+            // Accumulated ticks for each category in this frame, indexed by
+            // CategoryId. Sized to category_count() by register_category().
+            std::vector<TscClock::ticks> sysTicks;
+
+            // Accumulated hardware counters per category (same indexing).
+            // All zero unless DBG_SCOPE_HW scopes ran with counters enabled.
+            std::vector<HwCounterValues> sysCounters;
+
+            // Per-frame stats, indexed by StatId.
+            std::vector<std::uint64_t> stats;
 
-            // Total seconds for the whole frame (end_frame() fills this)
-            double frameSec = 0.0;
+            // Total ticks for the whole frame (end_frame() fills this)
+            TscClock::ticks frameTicks = 0;
         };
 
         // Internal helpers
         static void ensure_init_() noexcept;    // lazy init of static state
         static void print_if_due_() noexcept;   // periodic "Perf %" print
-        static const char* sys_name_(Subsystem s) noexcept;
 
         // Ring buffer storing the last kBuffer frames.
         // Choose a size that is a good tradeoff for your analysis needs.
@@ -95,9 +169,12 @@ namespace eng::debug {
 
         // Static state (one global instance)
         static FrameSample      s_ring_[kBuffer];  // circular storage
+        static std::vector<std::string> s_categories_; // names, indexed by CategoryId
+        static std::vector<std::string> s_stats_;      // names, indexed by StatId
         static int              s_head_;           // index of the "current" slot
         static bool             s_inFrame_;        // true between begin/end_frame
-        static clock::time_point s_frameStart_;    // timestamp at begin_frame
+        static std::uint64_t    s_frameIndex_;     // completed frame counter
+        static TscClock::ticks  s_frameStart_;     // tick count at begin_frame
         static clock::time_point s_lastPrint_;     // last time we printed "Perf %"
         static double           s_printIntervalSec_; // seconds between prints
     };
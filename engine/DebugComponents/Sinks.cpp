@@ -1,8 +1,21 @@
 #include "Sinks.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
 
 #if defined(_WIN32)
+#define NOMINMAX
 #include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 /*
@@ -13,9 +26,13 @@
 
    - ConsoleSink: prints to stderr and (optionally) to VS Output window.
    - FileSink   : appends to a text file.
+   - RotatingFileSink: buffered, rotating file output for long runs.
+   - RingFileSink: memory-mapped circular file with the most recent lines.
+   - JsonLinesSink: one JSON object per record, typed fields kept.
 
  Both sinks expect that the incoming 'msg' is already fully formatted by the
- Log facade (timestamp, level, tag, message body). Sinks just render it.
+ Log facade (timestamp, level, tag, message body). Sinks just render it,
+ without adding another level/tag prefix.
 
  Implementation notes:
    - ConsoleSink uses fprintf(stderr, ...) and flushes after each line so you
@@ -23,38 +40,32 @@
    - On Windows, ConsoleSink can also call OutputDebugStringA so that messages
      appear in Visual Studio's Output window when debugging.
    - FileSink uses std::ofstream opened in append mode and flushes per write.
+   - RotatingFileSink keeps its ofstream unbuffered: it already writes whole
+     chunks, so a second copy into the stream buffer would be wasted work.
 ===============================================================================
 */
 namespace eng::debug {  
 
-    // Small helper: convert enum LogLevel to a short text label.
-    // We keep it here (local to this .cpp) because only sinks need it.
-    static const char* lvl_to_cstr(LogLevel l) {
-        switch (l) {
-        case LogLevel::Error: return "ERROR";
-        case LogLevel::Warn: return "WARN";
-        case LogLevel::Info: return "INFO";
-        default:              return "DEBUG";
-        }
-    }
-
     // ConsoleSink::write
     // -------------------------------------------------------------------------
     // Print to stderr. Example line:
-    //   [INFO][CORE] 12:34:56.789 Message text ...
+    //   [12:34:56.789][INFO][CORE] Message text ...
     //
     // Then, on Windows and when enabled, mirror the same line to the VS Output
     // window via OutputDebugStringA. This is handy when running without a
     // console (e.g., double-clicking the .exe from Explorer).
-    void ConsoleSink::write(LogLevel lvl, const char* tag, const char* msg) {
-        std::fprintf(stderr, "[%s][%s] %s\n", lvl_to_cstr(lvl), tag, msg);
+    void ConsoleSink::write(LogLevel, const char*, std::string_view msg) {
+        std::fwrite(msg.data(), 1, msg.size(), stderr);
+        std::fputc('\n', stderr);
         std::fflush(stderr);
     #if defined(_WIN32)
         if (m_usePlatformOutput) {
 
-            // Build one string and send it to the debugger output.
-            std::string line = "[" + std::string(lvl_to_cstr(lvl)) + "][" + tag + "] " + msg + "\n";
-            OutputDebugStringA(line.c_str());
+            // OutputDebugStringA needs a NUL-terminated string. Reuse one
+            // scratch buffer so we do not allocate per line.
+            m_scratch.assign(msg.data(), msg.size());
+            m_scratch += '\n';
+            OutputDebugStringA(m_scratch.c_str());
         }
     #endif
     }
@@ -69,10 +80,497 @@ namespace eng::debug {
     // -------------------------------------------------------------------------
     // Append one line to the log file and flush immediately. Flushing ensures
     // the line makes it to disk even if the program exits unexpectedly.
-    void FileSink::write(LogLevel lvl, const char* tag, const char* msg) {
+    void FileSink::write(LogLevel, const char*, std::string_view msg) {
         if (!m_out.is_open()) return;
-        m_out << "[" << lvl_to_cstr(lvl) << "][" << tag << "] " << msg << "\n";
+        m_out.write(msg.data(), static_cast<std::streamsize>(msg.size()));
+        m_out.put('\n');
         m_out.flush();
     }
 
+    namespace {
+
+        // "20261018-153012" in local time, used in rotated file names.
+        std::string rotation_stamp() {
+            const std::time_t t = std::time(nullptr);
+            std::tm tm{};
+        #if defined(_WIN32)
+            localtime_s(&tm, &t);
+        #else
+            localtime_r(&t, &tm);
+        #endif
+            char buf[32];
+            std::strftime(buf, sizeof(buf), "%Y%m%d-%H%M%S", &tm);
+            return buf;
+        }
+
+        // A rotated file of 'stem' looks like "<stem>.<digits>..." (the stamp
+        // always starts with the year), optionally with a compression suffix.
+        bool is_rotated_name(const std::string& name, const std::string& stem) {
+            return name.size() > stem.size() + 1
+                && name.compare(0, stem.size(), stem) == 0
+                && name[stem.size()] == '.'
+                && name[stem.size() + 1] >= '0' && name[stem.size() + 1] <= '9';
+        }
+
+    } // namespace
+
+    // RotatingFileSink: open the active file and start the background thread.
+    RotatingFileSink::RotatingFileSink(const std::string& path, const LogRotation& cfg)
+        : m_path(path), m_cfg(cfg) {
+        m_buf.reserve(m_cfg.bufferBytes + 1024);
+        m_back.reserve(m_cfg.bufferBytes + 1024);
+        m_lastFlush = Clock::now();
+        {
+            std::scoped_lock fl(m_fileMtx);
+            open_();
+        }
+        m_worker = std::thread([this] { worker_(); });
+    }
+
+    // Stop the worker, then write whatever is still buffered.
+    RotatingFileSink::~RotatingFileSink() {
+        {
+            std::scoped_lock lk(m_mtx);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        if (m_worker.joinable()) m_worker.join();
+
+        std::vector<std::string> rotated;
+        {
+            std::scoped_lock lk(m_mtx, m_fileMtx);
+            write_chunk_(m_back);
+            write_chunk_(m_buf);
+            rotated.swap(m_rotated);
+        }
+        housekeeping_(rotated);
+    }
+
+    // RotatingFileSink::write
+    // -------------------------------------------------------------------------
+    // Normal case: one append into m_buf. Severe lines and a worker that fell
+    // behind are the only cases where the caller writes to disk itself.
+    void RotatingFileSink::write(LogLevel lvl, const char*, std::string_view msg) {
+        std::scoped_lock lk(m_mtx);
+        m_buf.append(msg.data(), msg.size());
+        m_buf.push_back('\n');
+
+        const bool severe = static_cast<int>(lvl) <= static_cast<int>(m_cfg.flushLevel);
+        if (!severe && m_buf.size() < m_cfg.bufferBytes) return;
+
+        if (!severe && m_back.empty()) {
+            m_back.swap(m_buf);
+            m_cv.notify_one();
+            return;
+        }
+
+        // Write synchronously: older chunk first so the file stays in order.
+        std::scoped_lock fl(m_fileMtx);
+        write_chunk_(m_back);
+        write_chunk_(m_buf);
+        m_lastFlush = Clock::now();
+        if (!m_rotated.empty()) m_cv.notify_one();
+    }
+
+    // Open (or create) the active file and pick up its current size.
+    void RotatingFileSink::open_() {
+        m_out.close();
+        m_out.clear();
+        m_out.rdbuf()->pubsetbuf(nullptr, 0);
+        m_out.open(m_path, std::ios::out | std::ios::app | std::ios::binary);
+
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(m_path, ec);
+        m_fileBytes = ec ? 0 : static_cast<std::uint64_t>(size);
+        m_openedAt = Clock::now();
+    }
+
+    // Write one chunk, clear it (keeping its capacity), rotate if due.
+    void RotatingFileSink::write_chunk_(std::string& chunk) {
+        if (!chunk.empty() && m_out.is_open()) {
+            m_out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            m_fileBytes += chunk.size();
+        }
+        chunk.clear();
+
+        const bool tooBig = m_cfg.maxBytes > 0 && m_fileBytes >= m_cfg.maxBytes;
+        const bool tooOld = m_cfg.maxSeconds > 0 && m_fileBytes > 0
+            && Clock::now() - m_openedAt >= std::chrono::seconds(m_cfg.maxSeconds);
+        if (tooBig || tooOld) rotate_();
+    }
+
+    // "dir/engine.log" -> "dir/engine.<stamp>.log", then start a fresh file.
+    // Only the rename happens here; compression and pruning are left to the
+    // worker via m_rotated.
+    void RotatingFileSink::rotate_() {
+        namespace fs = std::filesystem;
+        m_out.close();
+
+        const fs::path active(m_path);
+        const std::string base = (active.parent_path() / active.stem()).string() + "." + rotation_stamp();
+        const std::string ext = active.extension().string();
+        std::string target = base + ext;
+        std::error_code ec;
+        for (int n = 1; fs::exists(target, ec) || fs::exists(target + ".gz", ec); ++n) {
+            // Same second: "_01", "_02"... sort after the plain stamp.
+            char suffix[16];
+            std::snprintf(suffix, sizeof(suffix), "_%02d", n);
+            target = base + suffix + ext;
+        }
+
+        fs::rename(active, target, ec);
+        if (!ec) m_rotated.push_back(std::move(target));
+        open_();
+    }
+
+    // Compress freshly rotated files (if configured) and delete the oldest
+    // rotated files beyond keepFiles. Runs without any lock held.
+    void RotatingFileSink::housekeeping_(std::vector<std::string>& rotated) {
+        namespace fs = std::filesystem;
+        if (rotated.empty()) return;
+
+        if (!m_cfg.compressCommand.empty()) {
+            for (const auto& f : rotated) {
+                const std::string cmd = m_cfg.compressCommand + " \"" + f + "\"";
+                std::system(cmd.c_str());
+            }
+        }
+        rotated.clear();
+
+        // Rotated names sort by time because the stamp is fixed width.
+        const fs::path active(m_path);
+        const fs::path dir = active.parent_path().empty() ? fs::path(".") : active.parent_path();
+        const std::string stem = active.stem().string();
+        std::vector<fs::path> found;
+        std::error_code ec;
+        for (const auto& e : fs::directory_iterator(dir, ec)) {
+            if (!e.is_regular_file(ec)) continue;
+            if (is_rotated_name(e.path().filename().string(), stem)) found.push_back(e.path());
+        }
+        if (found.size() <= m_cfg.keepFiles) return;
+        std::sort(found.begin(), found.end());
+        for (size_t i = 0; i + m_cfg.keepFiles < found.size(); ++i) fs::remove(found[i], ec);
+    }
+
+    // Background thread: write full buffers handed over by write(), flush a
+    // stale partial buffer every flushIntervalMs, rotate idle files that got
+    // too old, and do the slow housekeeping outside every lock.
+    void RotatingFileSink::worker_() {
+        const auto interval = std::chrono::milliseconds(std::max<std::uint32_t>(m_cfg.flushIntervalMs, 10));
+        std::vector<std::string> rotated;
+
+        std::unique_lock lk(m_mtx);
+        while (!m_stop) {
+            m_cv.wait_for(lk, interval, [this] { return m_stop || !m_back.empty(); });
+            if (m_stop) break;
+
+            if (m_back.empty() && !m_buf.empty() && Clock::now() - m_lastFlush >= interval) {
+                m_back.swap(m_buf);
+                m_lastFlush = Clock::now();
+            }
+
+            // Take the file lock before releasing m_mtx so a synchronous
+            // write() cannot overtake this (older) chunk.
+            std::unique_lock fl(m_fileMtx);
+            m_writing.swap(m_back);
+            lk.unlock();
+
+            write_chunk_(m_writing);
+            rotated.swap(m_rotated);
+            fl.unlock();
+
+            housekeeping_(rotated);
+            lk.lock();
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // JsonLinesSink
+    // -------------------------------------------------------------------------
+
+    namespace {
+
+        // Append 'v' as a JSON string literal (quotes included).
+        void json_string(std::string& out, std::string_view v) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            out.push_back('"');
+            for (const char c : v) {
+                switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += "\\u00";
+                        out.push_back(kHex[(c >> 4) & 0xF]);
+                        out.push_back(kHex[c & 0xF]);
+                    }
+                    else {
+                        out.push_back(c);
+                    }
+                }
+            }
+            out.push_back('"');
+        }
+
+        template <typename T>
+        void json_number(std::string& out, T v) {
+            char buf[32];
+            const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(buf, static_cast<size_t>(r.ptr - buf));
+        }
+
+        const char* json_level(LogLevel l) {
+            switch (l) {
+            case LogLevel::Error: return "ERROR";
+            case LogLevel::Warn:  return "WARN";
+            case LogLevel::Info:  return "INFO";
+            default:              return "DEBUG";
+            }
+        }
+
+    } // namespace
+
+    JsonLinesSink::JsonLinesSink(const std::string& path) : m_out(path, std::ios::out | std::ios::app | std::ios::binary) {
+        m_line.reserve(512);
+    }
+
+    JsonLinesSink::~JsonLinesSink() { if (m_out.is_open()) m_out.flush(); }
+
+    void JsonLinesSink::write(LogLevel lvl, const char* tag, std::string_view msg) {
+        using namespace std::chrono;
+        const auto ms = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+        write_record(LogRecord{ lvl, tag, static_cast<std::int64_t>(ms), msg, nullptr, 0, "", 0, msg });
+    }
+
+    // JsonLinesSink::write_record
+    // -------------------------------------------------------------------------
+    // Numbers go through to_chars (shortest form that reads back exactly), so
+    // a float field is never re-parsed from text with rounding.
+    void JsonLinesSink::write_record(const LogRecord& r) {
+        if (!m_out.is_open()) return;
+        std::string& o = m_line;
+        o.clear();
+
+        o += "{\"ts\":";
+        json_number(o, r.unixMs);
+        o += ",\"level\":\"";
+        o += json_level(r.level);
+        o += "\",\"tag\":";
+        json_string(o, r.tag ? r.tag : "");
+        o += ",\"msg\":";
+        json_string(o, r.message);
+
+        for (std::size_t i = 0; i < r.fieldCount; ++i) {
+            const LogField& f = r.fields[i];
+            o.push_back(',');
+            json_string(o, f.key ? f.key : "?");
+            o.push_back(':');
+            switch (f.type) {
+            case LogField::Type::Int:    json_number(o, f.i); break;
+            case LogField::Type::UInt:   json_number(o, f.u); break;
+            case LogField::Type::Float:
+                if (std::isfinite(f.f)) json_number(o, f.f);
+                else o += "null";
+                break;
+            case LogField::Type::Bool:   o += f.b ? "true" : "false"; break;
+            case LogField::Type::String: json_string(o, f.s); break;
+            }
+        }
+
+        if (r.file && *r.file) {
+            o += ",\"file\":";
+            json_string(o, r.file);
+            o += ",\"line\":";
+            json_number(o, r.line);
+        }
+
+        o += "}\n";
+        m_out.write(o.data(), static_cast<std::streamsize>(o.size()));
+        if (r.level == LogLevel::Error) m_out.flush();
+    }
+
+    // -------------------------------------------------------------------------
+    // RingFileSink
+    // -------------------------------------------------------------------------
+
+    std::atomic<const RingFileSink*> RingFileSink::s_current_{ nullptr };
+
+    namespace {
+
+        constexpr char kRingMagic[8] = { 'E', 'N', 'G', 'R', 'I', 'N', 'G', '1' };
+
+        // Copy the tail of a ring into 'out' (see RingFileSink::copy_tail).
+        // Positions are "logical" (0..head); the byte at logical i lives at
+        // data[i % cap].
+        std::size_t ring_tail(const char* data, std::uint64_t cap, std::uint64_t head,
+            char* out, std::size_t outCap, std::size_t maxLines) noexcept {
+            if (cap == 0 || head == 0 || outCap == 0) return 0;
+            auto at = [&](std::uint64_t i) { return data[i % cap]; };
+
+            const std::uint64_t end = head;
+            std::uint64_t begin = (head > cap) ? head - cap : 0;
+
+            // After a wrap the oldest line was partly overwritten: skip up to
+            // and including its '\n', and start at the line right after it,
+            // which is whole. (A line starting exactly at head - cap cannot be
+            // told apart: the byte before it has been overwritten.)
+            if (head > cap) {
+                while (begin < end && at(begin) != '\n') ++begin;
+                if (begin < end) ++begin;
+            }
+
+            // Keep the last maxLines lines ('end' sits right after a '\n').
+            if (maxLines > 0) {
+                std::size_t lines = 0;
+                for (std::uint64_t i = end - 1; i > begin; --i) {
+                    if (at(i - 1) == '\n' && ++lines == maxLines) { begin = i; break; }
+                }
+            }
+
+            // Fit into 'out', starting at a line boundary.
+            if (end - begin > outCap) {
+                begin = end - outCap;
+                while (begin < end && at(begin - 1) != '\n') ++begin;
+            }
+
+            // At most two copies: up to the physical end of the ring, then the rest.
+            const std::size_t n = static_cast<std::size_t>(end - begin);
+            const std::size_t off = static_cast<std::size_t>(begin % cap);
+            const std::size_t first = std::min<std::size_t>(n, static_cast<std::size_t>(cap) - off);
+            std::memcpy(out, data + off, first);
+            std::memcpy(out + first, data, n - first);
+            return n;
+        }
+
+    } // namespace
+
+    // Create/resize the ring file and map it. On failure the sink stays
+    // closed and write() does nothing.
+    RingFileSink::RingFileSink(const std::string& path, std::size_t capacityBytes) {
+        namespace fs = std::filesystem;
+        if (capacityBytes < 4096) capacityBytes = 4096;
+
+        // Keep the previous run's ring around for post-mortems.
+        {
+            RingLogHeader prev{};
+            std::string text, err;
+            if (read_file(path, text, prev, err) && prev.head > 0) {
+                std::error_code ec;
+                fs::rename(path, path + ".prev", ec);
+            }
+        }
+
+        m_capacity = capacityBytes;
+        m_mapBytes = sizeof(RingLogHeader) + capacityBytes;
+        void* base = nullptr;
+
+    #if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+            nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        ULARGE_INTEGER size;
+        size.QuadPart = static_cast<ULONGLONG>(m_mapBytes);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+        if (!mapping) { CloseHandle(file); return; }
+        base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_mapBytes);
+        if (!base) { CloseHandle(mapping); CloseHandle(file); return; }
+        m_file = file;
+        m_mapping = mapping;
+    #else
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return;
+        if (::ftruncate(fd, static_cast<off_t>(m_mapBytes)) != 0) { ::close(fd); return; }
+        base = ::mmap(nullptr, m_mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) { ::close(fd); return; }
+        m_fd = fd;
+    #endif
+
+        m_hdr = static_cast<RingLogHeader*>(base);
+        m_data = static_cast<char*>(base) + sizeof(RingLogHeader);
+
+        std::memcpy(m_hdr->magic, kRingMagic, sizeof(kRingMagic));
+        m_hdr->version = kRingLogVersion;
+        m_hdr->headerBytes = sizeof(RingLogHeader);
+        m_hdr->capacity = m_capacity;
+        m_hdr->head = 0;
+    #if defined(_WIN32)
+        m_hdr->pid = GetCurrentProcessId();
+    #else
+        m_hdr->pid = static_cast<std::uint64_t>(::getpid());
+    #endif
+        m_hdr->startTime = static_cast<std::uint64_t>(std::time(nullptr));
+
+        s_current_.store(this, std::memory_order_release);
+    }
+
+    // Unmap. The OS writes the pages back on its own schedule.
+    RingFileSink::~RingFileSink() {
+        const RingFileSink* self = this;
+        s_current_.compare_exchange_strong(self, nullptr);
+        if (!m_hdr) return;
+    #if defined(_WIN32)
+        UnmapViewOfFile(m_hdr);
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+        CloseHandle(static_cast<HANDLE>(m_file));
+    #else
+        ::munmap(m_hdr, m_mapBytes);
+        ::close(m_fd);
+    #endif
+    }
+
+    // RingFileSink::write
+    // -------------------------------------------------------------------------
+    // Log::dispatch_ serializes calls, so there is one writer at a time. The
+    // new 'head' is published last with a release store: a reader (or the
+    // file after a crash) never counts bytes that were not fully copied.
+    void RingFileSink::write(LogLevel, const char*, std::string_view msg) {
+        if (!m_hdr) return;
+        const std::size_t n = std::min<std::size_t>(msg.size(), static_cast<std::size_t>(m_capacity) - 1);
+
+        std::atomic_ref<std::uint64_t> headRef(m_hdr->head);
+        const std::uint64_t head = headRef.load(std::memory_order_relaxed);
+        const std::size_t off = static_cast<std::size_t>(head % m_capacity);
+        const std::size_t first = std::min<std::size_t>(n, static_cast<std::size_t>(m_capacity) - off);
+        std::memcpy(m_data + off, msg.data(), first);
+        std::memcpy(m_data, msg.data() + first, n - first);
+        m_data[(head + n) % m_capacity] = '\n';
+        headRef.store(head + n + 1, std::memory_order_release);
+    }
+
+    std::size_t RingFileSink::copy_tail(char* out, std::size_t outCap, std::size_t maxLines) const noexcept {
+        if (!m_hdr || !out) return 0;
+        const std::uint64_t head = std::atomic_ref<std::uint64_t>(m_hdr->head).load(std::memory_order_acquire);
+        return ring_tail(m_data, m_capacity, head, out, outCap, maxLines);
+    }
+
+    const RingFileSink* RingFileSink::current() noexcept {
+        return s_current_.load(std::memory_order_acquire);
+    }
+
+    // Plain file read: works on a ring left by a dead process, or a live one
+    // (which may then be a few lines behind).
+    bool RingFileSink::read_file(const std::string& path, std::string& text,
+        RingLogHeader& info, std::string& error) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) { error = "cannot open " + path; return false; }
+
+        std::string raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (raw.size() < sizeof(RingLogHeader)) { error = "file too small for a ring header"; return false; }
+        std::memcpy(&info, raw.data(), sizeof(RingLogHeader));
+        if (std::memcmp(info.magic, kRingMagic, sizeof(kRingMagic)) != 0) { error = "not a log ring file (bad magic)"; return false; }
+        if (info.version != kRingLogVersion) { error = "unsupported ring version " + std::to_string(info.version); return false; }
+        if (info.headerBytes < sizeof(RingLogHeader) || raw.size() < info.headerBytes + info.capacity) {
+            error = "ring file is truncated";
+            return false;
+        }
+
+        text.resize(static_cast<std::size_t>(info.capacity));
+        text.resize(ring_tail(raw.data() + info.headerBytes, info.capacity, info.head,
+            text.data(), text.size(), 0));
+        return true;
+    }
+
 } // namespace eng::debug
@@ -1,6 +1,11 @@
 #pragma once
 #include "Log.h"
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <thread>
 
 /*
 ===============================================================================
@@ -9,11 +14,17 @@
  Purpose
    A "sink" is a destination where a formatted log line is written to.
    The Log system can broadcast each line to one or more sinks. This header
-   declares two concrete sinks you can use immediately:
+   declares the concrete sinks you can use immediately:
 
-	 1) ConsoleSink  -> prints to stderr, and optionally mirrors to
-						Visual Studio's Output window (Windows only).
-	 2) FileSink     -> appends each line to a text file on disk.
+	 1) ConsoleSink      -> prints to stderr, and optionally mirrors to
+							Visual Studio's Output window (Windows only).
+	 2) FileSink         -> appends each line to a text file on disk.
+	 3) RotatingFileSink -> buffered file output with size/time based
+							rotation (the default file sink, see LogRotation).
+	 4) RingFileSink     -> circular, memory-mapped file holding the last
+							lines; survives a crash without any flushing.
+	 5) JsonLinesSink    -> one JSON object per line with typed fields, for
+							log ingestion tools.
 
  How it fits together
    - The Log facade formats a final line (with timestamp, level, tag, message).
@@ -22,7 +33,8 @@
 
  Thread-safety
    - The Log facade holds a mutex when calling sinks.
-   - Each sink implementation here performs simple I/O; no extra locking needed.
+   - ConsoleSink/FileSink perform simple I/O; no extra locking needed.
+   - RotatingFileSink also has a background thread and its own locks.
 
  Notes
    - You can add your own sinks by subclassing ILogSink (e.g., network sink).
@@ -51,9 +63,10 @@ namespace eng::debug {
 		explicit ConsoleSink(bool usePlatformOutput = true) : m_usePlatformOutput(usePlatformOutput) {}
 
 		// Render one fully formatted line.
-		void write(LogLevel lvl, const char* tag, const char* msg) override;
+		void write(LogLevel lvl, const char* tag, std::string_view msg) override;
 	private:
 		bool m_usePlatformOutput = true;
+		std::string m_scratch;	// reused NUL-terminated copy for OutputDebugString
 	};
 
 	// FileSink
@@ -70,9 +83,174 @@ namespace eng::debug {
 		~FileSink();
 
 		// Render one fully formatted line to the file (plus newline).
-		void write(LogLevel lvl, const char* tag, const char* msg) override;
+		void write(LogLevel lvl, const char* tag, std::string_view msg) override;
 	private:
 		std::ofstream m_out;	// owned file stream
 	};
 
+	// RotatingFileSink
+		// -------------------------------------------------------------------------
+		// File sink for long (soak) runs. Lines are collected in memory and
+		// written in large chunks, and the file is rotated so it never grows
+		// without bound.
+		//
+		// When lines reach the disk:
+		//   - buffer reaches LogRotation::bufferBytes -> handed to the background
+		//     thread (the caller does not wait for the write),
+		//   - a line at LogRotation::flushLevel or more severe (Error by default)
+		//     -> everything is written at once on the calling thread, so the
+		//     last lines before a crash are on disk,
+		//   - otherwise the background thread writes a partly filled buffer every
+		//     flushIntervalMs, and the destructor writes what is left.
+		//
+		// Rotation:
+		//   When the active file reaches maxBytes or is older than maxSeconds it
+		//   is renamed "engine.log" -> "engine.20261018-153012.log" (local time)
+		//   and a new "engine.log" is started. The background thread then runs
+		//   compressCommand on the rotated file (if set) and deletes the oldest
+		//   rotated files beyond keepFiles.
+		//
+		// Locking:
+		//   m_mtx guards the in-memory buffers, m_fileMtx the file itself. Always
+		//   taken in that order, so chunks reach the file in the order logged.
+	class RotatingFileSink final : public ILogSink {
+	public:
+		RotatingFileSink(const std::string& path, const LogRotation& cfg);
+		~RotatingFileSink();
+
+		// Append one line to the buffer (see above for when it is written).
+		void write(LogLevel lvl, const char* tag, std::string_view msg) override;
+	private:
+		void open_();                          // open m_path for append (m_fileMtx held)
+		void write_chunk_(std::string& chunk); // write + clear + maybe rotate (m_fileMtx held)
+		void rotate_();                        // rename active file, reopen (m_fileMtx held)
+		void housekeeping_(std::vector<std::string>& rotated); // compress + prune, no locks held
+		void worker_();                        // background flush/rotate/housekeeping loop
+
+		using Clock = std::chrono::steady_clock;
+
+		std::string m_path;
+		LogRotation m_cfg;
+
+		// Guarded by m_mtx.
+		std::mutex m_mtx;
+		std::condition_variable m_cv;
+		std::string m_buf;                     // lines being appended
+		std::string m_back;                    // full buffer waiting for the worker
+		Clock::time_point m_lastFlush;
+		bool m_stop = false;
+
+		// Guarded by m_fileMtx.
+		std::mutex m_fileMtx;
+		std::ofstream m_out;
+		std::string m_writing;                 // worker's chunk (swapped with m_back)
+		std::uint64_t m_fileBytes = 0;
+		Clock::time_point m_openedAt;
+		std::vector<std::string> m_rotated;    // rotated files not yet compressed/pruned
+
+		std::thread m_worker;
+	};
+
+	// JsonLinesSink
+		// -------------------------------------------------------------------------
+		// Writes every record as one JSON object per line ("JSON lines"):
+		//
+		//   {"ts":1760800000123,"level":"INFO","tag":"PERF","msg":"frame","ms":16.6,"fps":60}
+		//
+		// - "ts" is unix time in milliseconds; structured fields follow "msg"
+		//   as top-level keys with their own JSON types (NaN/inf become null).
+		//   ts/level/tag/msg/file/line are reserved, so do not use them as keys.
+		// - printf-style lines have no fields; their formatted body is "msg".
+		// - "file"/"line" are added only when the call site passed them and
+		//   LogConfig::showSourceInfo is on.
+		// - The stream is buffered; lines at Error are flushed at once.
+	class JsonLinesSink final : public ILogSink {
+	public:
+		explicit JsonLinesSink(const std::string& path);
+		~JsonLinesSink();
+
+		// Plain line without a record: written with the line as "msg".
+		void write(LogLevel lvl, const char* tag, std::string_view msg) override;
+		void write_record(const LogRecord& r) override;
+	private:
+		std::ofstream m_out;
+		std::string m_line;		// reused per record, so no allocation once warm
+	};
+
+	// Fixed header at the start of a ring file (see RingFileSink). All fields
+	// are little-endian, written by the engine and read by logring_dump.
+	struct RingLogHeader {
+		char          magic[8];     // "ENGRING1"
+		std::uint32_t version;      // kRingLogVersion
+		std::uint32_t headerBytes;  // sizeof(RingLogHeader); data starts here
+		std::uint64_t capacity;     // data bytes after the header
+		std::uint64_t head;         // total bytes ever written; next write at head % capacity
+		std::uint64_t pid;          // writer process id
+		std::uint64_t startTime;    // writer start, unix seconds
+	};
+	inline constexpr std::uint32_t kRingLogVersion = 1;
+
+	// RingFileSink
+		// -------------------------------------------------------------------------
+		// Keeps the most recent log lines in a circular file that is mapped into
+		// memory. A line costs one or two memcpy calls and one atomic store; there
+		// is no write() or flush call at all.
+		//
+		// Why it survives a crash:
+		//   The mapping is shared with the file, so the pages belong to the OS
+		//   page cache, not to our process. When the process dies the OS still
+		//   writes them back. (Power loss is a different story.)
+		//
+		// Layout:
+		//   [RingLogHeader][capacity bytes of '\n'-terminated lines, wrapping]
+		//   'head' is published after the line bytes, so a line cut off by a
+		//   crash is not counted. After the ring wraps, the oldest line is
+		//   usually partial and readers skip it.
+		//
+		// Reading:
+		//   - copy_tail() gives the last N lines as text; no allocation, so the
+		//     crash handler can call it (see CrashLogger).
+		//   - read_file() linearizes a ring file on disk (tools/logring_dump).
+		//
+		// At startup a non-empty ring left by the previous run is renamed to
+		// "<path>.prev" so the last run's lines are not overwritten.
+	class RingFileSink final : public ILogSink {
+	public:
+		RingFileSink(const std::string& path, std::size_t capacityBytes);
+		~RingFileSink();
+
+		// Copy one line (plus '\n') into the ring. Lines longer than the ring
+		// are truncated.
+		void write(LogLevel lvl, const char* tag, std::string_view msg) override;
+
+		// True if the file was created and mapped.
+		bool is_open() const noexcept { return m_hdr != nullptr; }
+
+		// Copy the last 'maxLines' whole lines (0 = all that fit) into 'out'.
+		// Returns the number of bytes written; 'out' is not NUL-terminated.
+		std::size_t copy_tail(char* out, std::size_t outCap, std::size_t maxLines) const noexcept;
+
+		// The most recently constructed ring that is still alive, or nullptr.
+		static const RingFileSink* current() noexcept;
+
+		// Read a ring file from disk and return its lines oldest-first in
+		// 'text'. 'info' receives the header. Returns false with 'error' set
+		// if the file is missing or not a ring file.
+		static bool read_file(const std::string& path, std::string& text,
+			RingLogHeader& info, std::string& error);
+
+	private:
+		RingLogHeader* m_hdr = nullptr;  // start of the mapping
+		char* m_data = nullptr;          // m_hdr + headerBytes
+		std::uint64_t m_capacity = 0;
+		std::size_t m_mapBytes = 0;
+	#if defined(_WIN32)
+		void* m_file = nullptr;          // HANDLE
+		void* m_mapping = nullptr;       // HANDLE
+	#else
+		int m_fd = -1;
+	#endif
+		static std::atomic<const RingFileSink*> s_current_;
+	};
+
 } // namespace eng::debug
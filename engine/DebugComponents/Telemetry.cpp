@@ -0,0 +1,351 @@
+#include "Telemetry.h"
+#include "PerfViewer.h"
+#include "Log.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "ws2_32.lib") // link winsock automatically
+#pragma comment(lib, "psapi.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/*
+===============================================================================
+ Telemetry.cpp
+ ------------------------------------------------------------------------------
+ Implementation of the telemetry server.
+
+ Data flow
+   game thread                       server thread
+   -----------                       -------------
+   publish_frame()  --> SPSC ring --> drain, format "F ..." lines, send()
+   set_fps()        --> atomic        read when formatting
+   (category list changed)            send "H ..." line
+	  --> names copied under a mutex (rare: startup only)
+
+ SPSC ring
+   - kRing fixed-size FramePacket slots, a write index (game thread only) and
+	 a read index (server thread only), both monotonic counters.
+   - Full ring = drop the packet and bump a counter; the drop count is sent
+	 with each frame so a recorder can tell that data is missing.
+
+ Sockets
+   - Thin #if _WIN32 layer over Winsock / BSD sockets.
+   - The listening socket and all client sockets are polled with a short
+	 timeout so the thread notices stop() quickly.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	namespace {
+
+	#if defined(_WIN32)
+		using socket_t = SOCKET;
+		constexpr socket_t kInvalidSocket = INVALID_SOCKET;
+		void close_socket_(socket_t s) { closesocket(s); }
+	#else
+		using socket_t = int;
+		constexpr socket_t kInvalidSocket = -1;
+		void close_socket_(socket_t s) { close(s); }
+	#endif
+
+		constexpr int kProtocolVersion = 1;
+		constexpr std::uint32_t kRing = 512;          // ~8 s at 60 FPS
+		constexpr auto kMemSampleInterval = std::chrono::milliseconds(250);
+
+		// One frame as queued by the game thread (plain data, fixed size).
+		struct FramePacket {
+			std::uint64_t frameIndex = 0;
+			float         frameMs = 0.0f;
+			float         fps = 0.0f;
+			std::uint32_t catCount = 0;
+			float         catMs[Telemetry::kMaxCategories]{};
+		};
+
+		struct TelemetryState {
+			TelemetryConfig cfg;
+			std::thread     worker;
+			std::atomic<bool> running{ false };
+			std::atomic<bool> stopRequested{ false };
+
+			// SPSC ring
+			std::array<FramePacket, kRing> ring{};
+			std::atomic<std::uint64_t> writeIdx{ 0 };   // producer: game thread
+			std::atomic<std::uint64_t> readIdx{ 0 };    // consumer: server thread
+			std::atomic<std::uint64_t> drops{ 0 };
+
+			std::atomic<float> fps{ 0.0f };
+
+			// Category names, copied by the game thread when the count changes.
+			std::mutex namesMtx;
+			std::vector<std::string> names;
+			std::atomic<std::uint32_t> namesVersion{ 0 };
+			std::size_t lastCatCount = 0;               // game thread only
+		};
+
+		TelemetryState& state() { static TelemetryState S; return S; }
+
+		// Resident set size of this process, in KiB (0 if unknown).
+		std::uint64_t process_rss_kb_() {
+		#if defined(_WIN32)
+			PROCESS_MEMORY_COUNTERS pmc{};
+			if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+				return static_cast<std::uint64_t>(pmc.WorkingSetSize) / 1024;
+			}
+			return 0;
+		#else
+			// /proc/self/statm: size resident shared text lib data dt (pages)
+			std::uint64_t sizePages = 0, rssPages = 0;
+			if (std::FILE* fp = std::fopen("/proc/self/statm", "r")) {
+				if (std::fscanf(fp, "%llu %llu",
+					(unsigned long long*)&sizePages, (unsigned long long*)&rssPages) != 2) {
+					rssPages = 0;
+				}
+				std::fclose(fp);
+			}
+			return rssPages * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+		#endif
+		}
+
+		socket_t open_listener_(std::uint16_t port) {
+			socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+			if (s == kInvalidSocket) return kInvalidSocket;
+
+			int yes = 1;
+			setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&yes), sizeof(yes));
+
+			sockaddr_in addr{};
+			addr.sin_family = AF_INET;
+			addr.sin_port = htons(port);
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // localhost only
+
+			if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(s, 4) != 0) {
+				close_socket_(s);
+				return kInvalidSocket;
+			}
+			return s;
+		}
+
+		// Wait up to timeoutMs for the listener to become readable.
+		bool wait_readable_(socket_t s, int timeoutMs) {
+		#if defined(_WIN32)
+			WSAPOLLFD p{};
+			p.fd = s;
+			p.events = POLLRDNORM;
+			return WSAPoll(&p, 1, timeoutMs) > 0 && (p.revents & POLLRDNORM);
+		#else
+			pollfd p{};
+			p.fd = s;
+			p.events = POLLIN;
+			return poll(&p, 1, timeoutMs) > 0 && (p.revents & POLLIN);
+		#endif
+		}
+
+		// Send the whole buffer; false if the client went away.
+		bool send_all_(socket_t s, const char* data, std::size_t len) {
+			while (len > 0) {
+			#if defined(_WIN32)
+				const int n = send(s, data, static_cast<int>(len), 0);
+			#else
+				const ssize_t n = send(s, data, len, MSG_NOSIGNAL);
+			#endif
+				if (n <= 0) return false;
+				data += n;
+				len -= static_cast<std::size_t>(n);
+			}
+			return true;
+		}
+
+		std::string header_line_(TelemetryState& S) {
+			std::scoped_lock lk(S.namesMtx);
+			std::string line = "H " + std::to_string(kProtocolVersion) + " " + std::to_string(S.names.size());
+			for (const auto& n : S.names) {
+				line += ' ';
+				line += n;
+			}
+			line += '\n';
+			return line;
+		}
+
+		// Server thread main loop.
+		void server_main_(socket_t listener) {
+			auto& S = state();
+			std::vector<socket_t> clients;
+			std::uint32_t sentNamesVersion = 0;
+			std::uint64_t rssKb = process_rss_kb_();
+			auto lastMemSample = std::chrono::steady_clock::now();
+			std::string out;
+			out.reserve(64 * 1024);
+
+			while (!S.stopRequested.load(std::memory_order_acquire)) {
+
+				// 1) Accept new clients (also acts as our ~10 ms tick).
+				if (wait_readable_(listener, 10)) {
+					socket_t c = accept(listener, nullptr, nullptr);
+					if (c != kInvalidSocket) {
+						if ((int)clients.size() >= S.cfg.maxClients) {
+							close_socket_(c);
+						}
+						else {
+							const std::string h = header_line_(S);
+							if (send_all_(c, h.data(), h.size())) clients.push_back(c);
+							else close_socket_(c);
+						}
+					}
+				}
+
+				// 2) Sample memory a few times per second (never on the game thread).
+				const auto now = std::chrono::steady_clock::now();
+				if (now - lastMemSample >= kMemSampleInterval) {
+					rssKb = process_rss_kb_();
+					lastMemSample = now;
+				}
+
+				// 3) Drain the ring into one text buffer.
+				out.clear();
+				const std::uint32_t namesVersion = S.namesVersion.load(std::memory_order_acquire);
+				if (namesVersion != sentNamesVersion) {
+					out += header_line_(S);
+					sentNamesVersion = namesVersion;
+				}
+
+				std::uint64_t r = S.readIdx.load(std::memory_order_relaxed);
+				const std::uint64_t w = S.writeIdx.load(std::memory_order_acquire);
+				const std::uint64_t drops = S.drops.load(std::memory_order_relaxed);
+				char line[64 + Telemetry::kMaxCategories * 16];
+				for (; r != w; ++r) {
+					const FramePacket& p = S.ring[r % kRing];
+					int len = std::snprintf(line, sizeof(line), "F %llu %.3f %.1f %llu %llu",
+						(unsigned long long)p.frameIndex, p.frameMs, p.fps,
+						(unsigned long long)rssKb, (unsigned long long)drops);
+					for (std::uint32_t i = 0; i < p.catCount && len > 0 && len < (int)sizeof(line) - 16; ++i) {
+						len += std::snprintf(line + len, sizeof(line) - len, " %.3f", p.catMs[i]);
+					}
+					out.append(line, (len > 0) ? (size_t)len : 0);
+					out += '\n';
+				}
+				S.readIdx.store(r, std::memory_order_release);
+
+				// 4) Send to every client; drop the ones that disconnected.
+				if (!out.empty()) {
+					for (size_t i = 0; i < clients.size();) {
+						if (send_all_(clients[i], out.data(), out.size())) {
+							++i;
+						}
+						else {
+							close_socket_(clients[i]);
+							clients[i] = clients.back();
+							clients.pop_back();
+						}
+					}
+				}
+			}
+
+			for (socket_t c : clients) close_socket_(c);
+			close_socket_(listener);
+		}
+
+	} // namespace
+
+	bool Telemetry::start(const TelemetryConfig& cfg) {
+		auto& S = state();
+		if (!cfg.enabled || S.running.load()) return S.running.load();
+
+	#if defined(_WIN32)
+		WSADATA wsa;
+		if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+	#endif
+
+		const socket_t listener = open_listener_(cfg.port);
+		if (listener == kInvalidSocket) {
+			Log::writef(LogLevel::Warn, "TELEM", "", 0, "Telemetry: could not listen on 127.0.0.1:%u", (unsigned)cfg.port);
+			return false;
+		}
+
+		S.cfg = cfg;
+		S.stopRequested.store(false);
+		S.running.store(true, std::memory_order_release);
+		S.worker = std::thread(server_main_, listener);
+
+		Log::writef(LogLevel::Info, "TELEM", "", 0, "Telemetry listening on 127.0.0.1:%u", (unsigned)cfg.port);
+		return true;
+	}
+
+	void Telemetry::stop() {
+		auto& S = state();
+		if (!S.running.load()) return;
+
+		S.stopRequested.store(true, std::memory_order_release);
+		if (S.worker.joinable()) S.worker.join();
+		S.running.store(false, std::memory_order_release);
+
+	#if defined(_WIN32)
+		WSACleanup();
+	#endif
+	}
+
+	bool Telemetry::running() noexcept {
+		return state().running.load(std::memory_order_acquire);
+	}
+
+	void Telemetry::set_fps(double fps) noexcept {
+		state().fps.store(static_cast<float>(fps), std::memory_order_relaxed);
+	}
+
+	void Telemetry::publish_frame(std::uint64_t frameIndex, TscClock::ticks frameTicks,
+		const TscClock::ticks* catTicks, std::size_t catCount) noexcept {
+		auto& S = state();
+
+		// Category list changed (startup only): copy names for the server thread.
+		if (catCount != S.lastCatCount) {
+			{
+				std::scoped_lock lk(S.namesMtx);
+				S.names.clear();
+				for (std::size_t i = 0; i < catCount && i < kMaxCategories; ++i) {
+					S.names.push_back(PerfViewer::category_name(static_cast<CategoryId>(i)));
+				}
+			}
+			S.lastCatCount = catCount;
+			S.namesVersion.fetch_add(1, std::memory_order_release);
+		}
+
+		const std::uint64_t w = S.writeIdx.load(std::memory_order_relaxed);
+		const std::uint64_t r = S.readIdx.load(std::memory_order_acquire);
+		if (w - r >= kRing) {
+			S.drops.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		FramePacket& p = S.ring[w % kRing];
+		const double msPerTick = TscClock::seconds_per_tick() * 1000.0;
+		p.frameIndex = frameIndex;
+		p.frameMs = static_cast<float>(static_cast<double>(frameTicks) * msPerTick);
+		p.fps = S.fps.load(std::memory_order_relaxed);
+		p.catCount = static_cast<std::uint32_t>(catCount < kMaxCategories ? catCount : kMaxCategories);
+		for (std::uint32_t i = 0; i < p.catCount; ++i) {
+			p.catMs[i] = static_cast<float>(static_cast<double>(catTicks[i]) * msPerTick);
+		}
+
+		S.writeIdx.store(w + 1, std::memory_order_release);
+	}
+
+} // namespace eng::debug
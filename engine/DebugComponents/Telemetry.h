@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Tsc.h"
+
+/*
+===============================================================================
+ Telemetry.h
+ ------------------------------------------------------------------------------
+ Purpose
+   Optional live telemetry endpoint. Streams every PerfViewer frame (frame
+   time + per-category time), the current FPS and process memory to an
+   external viewer/recorder over a localhost TCP socket. Meant for headless
+   soak runs where the once-per-second PERF log line is not enough.
+
+ How it works
+   - The game thread calls publish_frame() from PerfViewer::end_frame().
+	 That only copies a small fixed-size packet into a lock-free
+	 single-producer/single-consumer ring. No I/O and no allocation; the only
+	 lock is taken when the category list changes (startup).
+   - A background thread owns the socket. It accepts clients, drains the
+	 ring, samples process memory a few times per second, and sends text
+	 lines to every connected client.
+   - If nobody drains the ring fast enough, new packets are dropped (and
+	 counted) instead of blocking the game thread.
+
+ Protocol (one ASCII line per message, space separated)
+   H <version> <ncat> <cat0> <cat1> ...                      category header
+   F <frame> <frame_ms> <fps> <rss_kb> <drops> <cat0_ms> ... one frame
+   A header line is sent when a client connects and whenever the category
+   list changes. Category names never contain spaces.
+
+ Usage
+   eng::debug::TelemetryConfig cfg;
+   cfg.enabled = true;
+   cfg.port = 7777;
+   eng::debug::Telemetry::start(cfg);
+   ...
+   eng::debug::Telemetry::stop();
+
+   Then run the bundled client:  telemetry_client 7777
+
+ Notes
+   - The server binds to 127.0.0.1 only.
+   - At most kMaxCategories categories are streamed per frame.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	struct TelemetryConfig {
+		bool          enabled = false;   // start the server at all
+		std::uint16_t port = 7777;       // localhost TCP port
+		int           maxClients = 4;    // simultaneous viewers/recorders
+	};
+
+	class Telemetry {
+	public:
+		// Max categories carried per frame packet.
+		static constexpr std::size_t kMaxCategories = 32;
+
+		// Start the background server thread. Returns false if disabled or the
+		// port could not be bound.
+		static bool start(const TelemetryConfig& cfg);
+
+		// Stop the server thread and close all sockets.
+		static void stop();
+
+		// True while the server thread is running.
+		static bool running() noexcept;
+
+		// Game thread: queue one finished frame. Never blocks.
+		static void publish_frame(std::uint64_t frameIndex, TscClock::ticks frameTicks,
+			const TscClock::ticks* catTicks, std::size_t catCount) noexcept;
+
+		// Game thread: latest FPS value to attach to the following frames.
+		static void set_fps(double fps) noexcept;
+	};
+
+} // namespace eng::debug
@@ -9,15 +9,18 @@
 
  What happens at runtime
    1) When a ScopeTimer object is constructed (usually by DBG_SCOPE_SYS),
-	  we store the current time (steady_clock) and the chosen Subsystem.
-   2) When the object leaves scope, the destructor computes the elapsed time
-	  in seconds and forwards it to PerfViewer::record(sys, seconds).
-   3) PerfViewer aggregates these times per frame and can print system
-	  percentages or export CSV.
-
- Why steady_clock?
-   - It is monotonic, meaning it never goes backward if the system time changes.
-	 This is ideal for measuring durations.
+	  we store the current TSC tick count and the chosen category
+	  (inline in Trace.h, so construction is just an rdtsc).
+   2) When the object leaves scope, the destructor computes the elapsed ticks
+	  and forwards them to PerfViewer::record_ticks(cat, ticks).
+   3) PerfViewer aggregates these ticks per frame and converts them to
+	  seconds only when printing percentages or exporting CSV.
+
+ Why TSC instead of steady_clock?
+   - steady_clock::now() is a library call (and a vDSO/QPC call under that)
+	 that costs tens of nanoseconds. rdtsc is a single instruction. With
+	 thousands of scopes per frame the difference is measurable.
+   - See Tsc.h for calibration and the non-x86 fallback.
 
  Error safety
    - The destructor is noexcept, so even if exceptions happen in the user code,
@@ -27,21 +30,12 @@
 
 namespace eng::debug {
 
-	ScopeTimer::ScopeTimer(std::string_view name, Subsystem sys) noexcept
-		: m_name(name), m_sys(sys), m_start(clock::now()) {
-		// Nothing else to do here. We only capture the start timestamp.
-	}
-
 	ScopeTimer::~ScopeTimer() noexcept {
-		using namespace std::chrono;
-
-		// Compute seconds elapsed since construction.
-		const auto sec = duration_cast<duration<double>>(clock::now() - m_start).count();
 
-		// Report the measured duration to the aggregator.
-		// PerfViewer will attribute this time to the given subsystem for the
+		// Report the measured ticks to the aggregator.
+		// PerfViewer will attribute them to the given category for the
 		// current frame (i.e., between begin_frame() and end_frame()).
-		PerfViewer::record(m_sys, sec);
+		PerfViewer::record_ticks(m_cat, TscClock::now_ordered() - m_start);
 	}
 
 } // namespace eng::debug
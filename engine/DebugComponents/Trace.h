@@ -1,6 +1,14 @@
 #pragma once
-#include <chrono>
+#include <cstdint>
 #include <string_view>
+#include "Tsc.h"
+
+// Compile-time switch for all DBG_SCOPE_* instrumentation. Define
+// ENG_PROFILING=0 (CMake: -DSTRUCTSQUAD_PROFILING=OFF) to strip every scope
+// to nothing; the code inside the scope is unaffected.
+#ifndef ENG_PROFILING
+#define ENG_PROFILING 1
+#endif
 
 /*
 ===============================================================================
@@ -9,9 +17,9 @@
  Purpose
    Provide a tiny RAII timer (ScopeTimer) to measure how long a block of code
    takes to run. When the timer object goes out of scope (end of the block),
-   it automatically reports the duration to PerfViewer, grouped by a "Subsystem"
-   (Graphics, Physics, etc.). This makes it easy to see how much time each
-   system consumes per frame.
+   it automatically reports the duration to PerfViewer, grouped by a profiling
+   category ("Graphics", "Window", "Collision", ...). This makes it easy to see
+   how much time each system consumes per frame.
 
  Key ideas
    - RAII (Resource Acquisition Is Initialization): you construct an object at
@@ -33,19 +41,31 @@
 
  Notes
    - The "name" parameter is currently kept for clarity but not used by the
-	 aggregator; the Subsystem enum is what groups the times.
-   - Overhead is very low: one timestamp at construction and one at destruction,
-	 plus an atomic-like accumulation inside PerfViewer.
+	 aggregator; the category id is what groups the times.
+   - Categories are registered at runtime with
+	 PerfViewer::register_category("Name"). The Subsystem enum values are
+	 pre-registered built-ins, so both forms can be passed to DBG_SCOPE_SYS.
+   - Overhead is very low: one rdtsc at construction, one rdtscp at
+	 destruction (see Tsc.h), plus an integer add inside PerfViewer. Run the
+	 bench_scope_timer tool to see the per-scope cost on your machine.
+   - With ENG_PROFILING=0 the macro expands to nothing at all.
 ===============================================================================
 */
 
 namespace eng::debug {
 
+	// CategoryId
+	// -------------------------------------------------------------------------
+	// Index of a profiling category in PerfViewer's category table. Obtain one
+	// with PerfViewer::register_category("Name") at startup and keep it.
+	using CategoryId = std::uint16_t;
+
 	// Subsystem
 	// -------------------------------------------------------------------------
-	// This enum lists the major systems you might want to profile individually.
-	// You can expand it over time (AI, Audio, etc.). COUNT is kept as the last
-	// entry so arrays can use it for their size.
+	// Built-in categories. PerfViewer registers these first, in this order, so
+	// each enum value is also a valid CategoryId. Systems that need their own
+	// label should register a named category instead of extending this enum.
+	// COUNT is the number of built-ins.
 	enum class Subsystem : unsigned char {
 		Graphics = 0,
 		Physics,
@@ -62,8 +82,8 @@ namespace eng::debug {
 
 	// ScopeTimer
 	// -------------------------------------------------------------------------
-	// RAII timer that records the time spent between construction and
-	// destruction, and then reports it to PerfViewer::record(sys, seconds).
+	// RAII timer that records the TSC ticks spent between construction and
+	// destruction, and then reports them to PerfViewer::record_ticks(cat, ticks).
 	//
 	// Usage:
 	//   {
@@ -73,34 +93,50 @@ namespace eng::debug {
 	class ScopeTimer {
 	public:
 		// name: a short label describing the work (used for clarity).
-		// sys : which subsystem to attribute this time to.
-		ScopeTimer(std::string_view name, Subsystem sys) noexcept;
+		// cat : which category to attribute this time to.
+		// The name is not stored: the aggregator groups by category only,
+		// and keeping the object small keeps the scope cheap.
+		ScopeTimer(std::string_view name, CategoryId cat) noexcept
+			: m_start(TscClock::now()), m_cat(cat) {
+			(void)name;
+		}
 
-		// On scope exit, compute the elapsed time and report to PerfViewer.
+		// Built-in category overload (Subsystem::Graphics, ...).
+		ScopeTimer(std::string_view name, Subsystem sys) noexcept
+			: ScopeTimer(name, static_cast<CategoryId>(sys)) {}
+
+		// On scope exit, compute the elapsed ticks and report to PerfViewer.
 		~ScopeTimer() noexcept;
 
-	private:
-		using clock = std::chrono::steady_clock; // monotonic clock
+		ScopeTimer(const ScopeTimer&) = delete;
+		ScopeTimer& operator=(const ScopeTimer&) = delete;
 
-		std::string_view m_name;     // label (not currently used by aggregator)
-		Subsystem        m_sys;      // which subsystem this scope belongs to
-		clock::time_point m_start;   // timestamp captured at construction
+	private:
+		TscClock::ticks m_start;     // tick count captured at construction
+		CategoryId      m_cat;       // which category this scope belongs to
 	};
 
 	// Helper macro
 	// -------------------------------------------------------------------------
 	// Creates a unique ScopeTimer object on the stack for the current block.
 	// NAME  : human-readable label (const char* or std::string_view)
-	// SUBSYS: one of the values from Subsystem (e.g., Subsystem::Graphics)
+	// SUBSYS: a CategoryId from register_category(), or a built-in Subsystem
 	//
 	// The trick with __LINE__ makes the variable name unique per line, so you
-	// can place multiple DBG_SCOPE_SYS(...) in the same function.
+	// can place multiple DBG_SCOPE_SYS(...) in the same function. The extra
+	// CONCAT indirection is needed so __LINE__ expands before pasting.
 	//
 	// Example:
 	//   void update() {
 	//     DBG_SCOPE_SYS("Gameplay", eng::debug::Subsystem::Gameplay);
 	//     // gameplay code...
 	//   }
-#define DBG_SCOPE_SYS(NAME, SUBSYS) ::eng::debug::ScopeTimer _dbg_scope_##__LINE__{NAME, SUBSYS}
+#define DBG_CONCAT_IMPL_(A, B) A##B
+#define DBG_CONCAT_(A, B) DBG_CONCAT_IMPL_(A, B)
+#if ENG_PROFILING
+#define DBG_SCOPE_SYS(NAME, SUBSYS) ::eng::debug::ScopeTimer DBG_CONCAT_(_dbg_scope_, __LINE__){NAME, SUBSYS}
+#else
+#define DBG_SCOPE_SYS(NAME, SUBSYS) ((void)0)
+#endif
 
 } // namespace eng::debug
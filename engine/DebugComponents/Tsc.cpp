@@ -0,0 +1,69 @@
+#include "Tsc.h"
+#include "Log.h"
+
+/*
+===============================================================================
+ Tsc.cpp
+ ------------------------------------------------------------------------------
+ Calibration of TscClock.
+
+ Key ideas
+   - We take a (steady_clock, tsc) pair, busy-wait ~20 ms, take another pair,
+     and divide: seconds_per_tick = elapsed_seconds / elapsed_ticks.
+   - Busy-waiting (instead of sleep) keeps the core awake, so the measurement
+     is not skewed by the thread being descheduled at the end points.
+   - The result is stored in a function-local static, so initialization is
+     thread-safe and happens exactly once.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	namespace {
+
+		// Length of the calibration window. Longer = more precise, slower startup.
+		constexpr auto kCalibrationWindow = std::chrono::milliseconds(20);
+
+		double measure_seconds_per_tick_() noexcept {
+		#if ENG_TSC_X86
+			using clock = std::chrono::steady_clock;
+
+			const auto t0 = clock::now();
+			const auto c0 = TscClock::now();
+			auto t1 = t0;
+			while (t1 - t0 < kCalibrationWindow) {
+				t1 = clock::now();
+			}
+			const auto c1 = TscClock::now_ordered();
+
+			const double sec = std::chrono::duration<double>(t1 - t0).count();
+			const double ticks = static_cast<double>(c1 - c0);
+			return (ticks > 0.0) ? sec / ticks : 1e-9;
+		#else
+			// Fallback clock already counts nanoseconds.
+			return 1e-9;
+		#endif
+		}
+
+		double calibrated_() noexcept {
+			static const double spt = measure_seconds_per_tick_();
+			return spt;
+		}
+
+	} // namespace
+
+	void TscClock::calibrate() noexcept {
+		const double spt = calibrated_();
+		Log::writef(LogLevel::Info, "PERF", "", 0,
+			"TscClock calibrated: %.3f MHz", (spt > 0.0) ? 1e-6 / spt : 0.0);
+	}
+
+	double TscClock::seconds_per_tick() noexcept {
+		return calibrated_();
+	}
+
+	TscClock::ticks TscClock::from_seconds(double s) noexcept {
+		return (s <= 0.0) ? 0 : static_cast<ticks>(s / seconds_per_tick());
+	}
+
+} // namespace eng::debug
@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ENG_TSC_X86 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define ENG_TSC_X86 1
+#else
+#define ENG_TSC_X86 0
+#endif
+
+/*
+===============================================================================
+ Tsc.h
+ ------------------------------------------------------------------------------
+ Purpose
+   TscClock is a very cheap timestamp source for the profiler. On x86 it reads
+   the CPU time-stamp counter (rdtsc / rdtscp) instead of going through
+   std::chrono::steady_clock, which makes a timestamp cost a handful of
+   cycles instead of a system-library call.
+
+ How it works
+   - now()          : rdtsc, used at the START of a measured region.
+   - now_ordered()  : rdtscp, used at the END of a region. rdtscp waits for
+                      all previous instructions to finish, so the measured
+                      work cannot "leak" past the end stamp.
+   - calibrate()    : measures how many ticks pass per steady_clock second.
+                      This runs once (about 20 ms busy-wait). Call it at
+                      startup so the first frame does not pay for it; if you
+                      do not, it runs lazily on the first conversion.
+   - to_seconds()   : converts a tick delta to seconds using the calibration.
+
+ Notes
+   - Ticks are stored as integers everywhere (ScopeTimer, PerfViewer), and
+     only converted to seconds when printing or exporting.
+   - Modern CPUs have an invariant TSC (constant rate across P-states), so
+     one calibration is enough for the process lifetime.
+   - On non-x86 targets we fall back to steady_clock nanoseconds, so the API
+     stays the same everywhere.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	class TscClock {
+	public:
+		using ticks = std::uint64_t;
+
+		// Timestamp for the start of a measured region.
+		static ticks now() noexcept {
+		#if ENG_TSC_X86
+			return __rdtsc();
+		#else
+			return fallback_now_();
+		#endif
+		}
+
+		// Timestamp for the end of a measured region (waits for prior work).
+		static ticks now_ordered() noexcept {
+		#if ENG_TSC_X86
+			unsigned int aux;
+			return __rdtscp(&aux);
+		#else
+			return fallback_now_();
+		#endif
+		}
+
+		// Measure ticks-per-second against steady_clock. Safe to call more
+		// than once; only the first call does the work.
+		static void calibrate() noexcept;
+
+		// Conversion helpers (calibrate lazily on first use).
+		static double seconds_per_tick() noexcept;
+		static double to_seconds(ticks t) noexcept { return static_cast<double>(t) * seconds_per_tick(); }
+		static ticks  from_seconds(double s) noexcept;
+
+	private:
+		static ticks fallback_now_() noexcept {
+			using namespace std::chrono;
+			return static_cast<ticks>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+		}
+	};
+
+} // namespace eng::debug
@@ -0,0 +1,345 @@
+#include "DebugComponents/Watchdog.h"
+#include "DebugComponents/CrashLogger.h"
+#include "DebugComponents/Log.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#else
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ENG_HAS_BACKTRACE 1
+#else
+#define ENG_HAS_BACKTRACE 0
+#endif
+#endif
+
+/*
+===============================================================================
+ Watchdog.cpp
+ ------------------------------------------------------------------------------
+ Implementation of Watchdog.
+
+ Heartbeat
+   - s_beatNs holds the steady-clock time of the last heartbeat (0 while
+	 suspended); it doubles as the identity of the current frame. s_beats
+	 counts heartbeats (the frame number in messages). Both are written only
+	 by the main thread, with relaxed stores.
+   - The watchdog remembers the heartbeat it already reported, so one stall
+	 produces one report no matter how long it lasts.
+
+ Stack sampling (POSIX)
+   - The watchdog writes a request id into s_sample.request and sends
+	 kSampleSignal to the main thread. The handler copies backtrace() into
+	 s_sample and publishes the id in s_sample.done.
+   - A late signal (after the watchdog gave up waiting) finds request == 0
+	 and does nothing, so it cannot overwrite a buffer being read.
+   - Frames 0 and 1 of the handler's backtrace are the handler itself and the
+	 kernel's signal trampoline; frame 2 is the interrupted PC.
+
+ Stack sampling (Windows)
+   - SuspendThread + GetThreadContext, then an unwind with
+	 RtlLookupFunctionEntry / RtlVirtualUnwind into a fixed array, then
+	 ResumeThread. The suspended thread may hold the heap or dbghelp lock,
+	 so nothing in between allocates or calls dbghelp (StackWalk64 does
+	 both). Symbols are looked up after the thread runs again.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	namespace {
+
+		using clock = std::chrono::steady_clock;
+
+		constexpr int kMaxFrames = 64;
+
+		// Fixed size: it is filled while the main thread is suspended, when
+		// the heap may be locked by that thread.
+		struct StackSample {
+			double         atMs = 0.0;                // stall age when taken
+			int            count = 0;
+			std::uintptr_t frames[kMaxFrames];        // [0] = PC
+		};
+
+		WatchdogConfig           s_cfg;
+		std::thread              s_thread;
+		std::mutex               s_mtx;              // for s_cv only
+		std::condition_variable  s_cv;
+		std::atomic<bool>        s_running{ false };
+		std::atomic<std::int64_t>  s_beatNs{ 0 };
+		std::atomic<std::uint64_t> s_beats{ 0 };
+		std::atomic<std::uint64_t> s_hangs{ 0 };
+		unsigned                 s_reports = 0;
+
+	#if defined(_WIN32)
+		HANDLE s_mainThread = nullptr;
+	#else
+		constexpr int kSampleSignal = SIGUSR2;
+		pthread_t s_mainThread{};
+
+		struct SampleSlot {
+			std::atomic<unsigned> request{ 0 };
+			std::atomic<unsigned> done{ 0 };
+			int                   count = 0;
+			void*                 frames[kMaxFrames + 2];
+		};
+		SampleSlot s_sample;
+
+		void on_sample_signal(int, siginfo_t*, void*) {
+			const unsigned req = s_sample.request.load(std::memory_order_acquire);
+			if (req == 0 || s_sample.done.load(std::memory_order_relaxed) == req) return;
+			const int savedErrno = errno;
+		#if ENG_HAS_BACKTRACE
+			s_sample.count = ::backtrace(s_sample.frames, kMaxFrames + 2);
+		#else
+			s_sample.count = 0;
+		#endif
+			s_sample.done.store(req, std::memory_order_release);
+			errno = savedErrno;
+		}
+	#endif
+
+		std::int64_t now_ns() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+		}
+
+		// Sleep that stop() can cut short. Returns false once stopping.
+		bool wait_ms(unsigned ms) {
+			std::unique_lock<std::mutex> lk(s_mtx);
+			s_cv.wait_for(lk, std::chrono::milliseconds(ms), [] { return !s_running.load(); });
+			return s_running.load();
+		}
+
+		// One sample of the main thread's stack; empty if it did not respond.
+		bool sample_main_thread(StackSample& out) {
+		#if defined(_WIN32)
+			// Nothing between Suspend and Resume may allocate or take a lock the
+			// main thread could be holding (heap, dbghelp): the unwind uses the
+			// loader's function tables only, and frames go into a fixed array.
+			if (::SuspendThread(s_mainThread) == static_cast<DWORD>(-1)) return false;
+			CONTEXT ctx{};
+			ctx.ContextFlags = CONTEXT_FULL;
+			if (::GetThreadContext(s_mainThread, &ctx)) {
+			#if defined(_M_X64) || defined(_M_ARM64)
+			#if defined(_M_X64)
+				DWORD64& pc = ctx.Rip;
+			#else
+				DWORD64& pc = ctx.Pc;
+			#endif
+				while (pc && out.count < kMaxFrames) {
+					out.frames[out.count++] = static_cast<std::uintptr_t>(pc);
+					DWORD64 imageBase = 0;
+					PRUNTIME_FUNCTION fn = ::RtlLookupFunctionEntry(pc, &imageBase, nullptr);
+					if (!fn) {
+						// Leaf function: the return address is still on top of
+						// the stack (x64) or in the link register (ARM64)
+					#if defined(_M_X64)
+						pc = *reinterpret_cast<const DWORD64*>(ctx.Rsp);
+						ctx.Rsp += 8;
+					#else
+						if (pc == ctx.Lr) break;
+						pc = ctx.Lr;
+					#endif
+						continue;
+					}
+					PVOID handlerData = nullptr;
+					DWORD64 establisherFrame = 0;
+					::RtlVirtualUnwind(UNW_FLAG_NHANDLER, imageBase, pc, fn, &ctx, &handlerData, &establisherFrame, nullptr);
+				}
+			#else
+				// x86 has no unwind tables; the PC alone still shows where it hangs
+				out.frames[out.count++] = static_cast<std::uintptr_t>(ctx.Eip);
+			#endif
+			}
+			::ResumeThread(s_mainThread);
+			return out.count > 0;
+		#else
+			static unsigned nextId = 0;
+			if (++nextId == 0) nextId = 1;   // 0 means "no request"
+			const unsigned id = nextId;
+			s_sample.request.store(id, std::memory_order_release);
+			if (::pthread_kill(s_mainThread, kSampleSignal) != 0) {
+				s_sample.request.store(0, std::memory_order_release);
+				return false;
+			}
+			const auto deadline = clock::now() + std::chrono::milliseconds(200);
+			while (s_sample.done.load(std::memory_order_acquire) != id && clock::now() < deadline) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			const bool ok = s_sample.done.load(std::memory_order_acquire) == id;
+			if (ok) {
+				for (int i = 2; i < s_sample.count && out.count < kMaxFrames; ++i) {
+					out.frames[out.count++] = reinterpret_cast<std::uintptr_t>(s_sample.frames[i]);
+				}
+			}
+			s_sample.request.store(0, std::memory_order_release);
+			return ok && out.count > 0;
+		#endif
+		}
+
+		void write_frames(std::FILE* fp, const StackSample& s) {
+			std::fprintf(fp, "PC: 0x%llx\n", static_cast<unsigned long long>(s.frames[0]));
+			std::fprintf(fp, "Stack (raw):\n");
+			for (int i = 0; i < s.count; ++i) {
+				std::fprintf(fp, "  [%d] 0x%llx", i, static_cast<unsigned long long>(s.frames[i]));
+			#if defined(_WIN32)
+				char buffer[sizeof(SYMBOL_INFO) + 256];
+				PSYMBOL_INFO sym = reinterpret_cast<PSYMBOL_INFO>(buffer);
+				sym->SizeOfStruct = sizeof(SYMBOL_INFO);
+				sym->MaxNameLen = 255;
+				DWORD64 disp = 0;
+				if (::SymFromAddr(::GetCurrentProcess(), s.frames[i], &disp, sym)) {
+					std::fprintf(fp, " %s +0x%llx", sym->Name, static_cast<unsigned long long>(disp));
+				}
+			#endif
+				std::fprintf(fp, "\n");
+			}
+		}
+
+		std::string write_hang_report(std::uint64_t frame, double stallMs, const std::vector<StackSample>& samples) {
+			const std::string path = CrashLogger::report_path("hang");
+		#if defined(_WIN32)
+			std::FILE* fp = nullptr;
+			if (fopen_s(&fp, path.c_str(), "w") != 0) fp = nullptr;
+		#else
+			std::FILE* fp = std::fopen(path.c_str(), "w");
+		#endif
+			if (!fp) return std::string();
+			std::fprintf(fp, "Hang detected\n--------------------------------------------------\n");
+			std::fprintf(fp, "Frame %llu stalled for at least %.0f ms (threshold %u ms)\n",
+				static_cast<unsigned long long>(frame), stallMs, s_cfg.hangMs);
+			if (samples.empty()) std::fprintf(fp, "\n(main thread did not respond to stack sampling)\n");
+			for (size_t i = 0; i < samples.size(); ++i) {
+				std::fprintf(fp, "\nSample %zu of %zu at +%.0f ms\n", i + 1, samples.size(), samples[i].atMs);
+				write_frames(fp, samples[i]);
+			}
+			CrashLogger::append_report_tail(fp);
+			std::fclose(fp);
+			return path;
+		}
+
+		void handle_hang(std::int64_t beatNs) {
+			const std::uint64_t frame = s_beats.load(std::memory_order_relaxed);
+			auto ageMs = [beatNs] { return static_cast<double>(now_ns() - beatNs) / 1e6; };
+			auto stalled = [beatNs] { return s_beatNs.load(std::memory_order_relaxed) == beatNs; };
+
+			std::vector<StackSample> samples;
+			for (unsigned i = 0; i < s_cfg.samples && stalled(); ++i) {
+				if (i > 0 && !wait_ms(s_cfg.sampleIntervalMs)) return;
+				if (!stalled()) break;
+				StackSample s;
+				s.atMs = ageMs();
+				if (sample_main_thread(s)) samples.push_back(std::move(s));
+			}
+			const double stallMs = ageMs();
+			s_hangs.fetch_add(1, std::memory_order_relaxed);
+
+			// File first: the main thread may be stuck inside the logger.
+			std::string path;
+			if (s_cfg.writeReport && s_reports < s_cfg.maxReports) {
+				path = write_hang_report(frame, stallMs, samples);
+				if (!path.empty()) ++s_reports;
+			}
+			LOG_WARN("WATCHDOG", "Frame %llu stalled %.0f ms (threshold %u ms), %zu stack sample(s)%s%s",
+				static_cast<unsigned long long>(frame), stallMs, s_cfg.hangMs, samples.size(),
+				path.empty() ? "" : ", report: ", path.c_str());
+
+			// Wait for the frame to finish, then log how long it really took.
+			while (stalled()) {
+				if (!wait_ms(s_cfg.checkIntervalMs)) return;
+			}
+			if (s_beatNs.load(std::memory_order_relaxed) != 0) {
+				LOG_WARN("WATCHDOG", "Frame %llu recovered after ~%.0f ms",
+					static_cast<unsigned long long>(frame), ageMs());
+			}
+		}
+
+		void watchdog_main() {
+			std::int64_t reported = 0;
+			while (wait_ms(s_cfg.checkIntervalMs)) {
+			#if defined(_WIN32)
+				if (::IsDebuggerPresent()) continue;
+			#endif
+				const std::int64_t beatNs = s_beatNs.load(std::memory_order_relaxed);
+				if (beatNs == 0 || beatNs == reported) continue;
+				if (now_ns() - beatNs < static_cast<std::int64_t>(s_cfg.hangMs) * 1000000) continue;
+				reported = beatNs;
+				handle_hang(beatNs);
+			}
+		}
+
+	} // namespace
+
+	bool Watchdog::start(const WatchdogConfig& cfg) {
+		if (!cfg.enabled || s_running.load()) return false;
+		s_cfg = cfg;
+		s_beatNs.store(0);
+		s_reports = 0;
+
+	#if defined(_WIN32)
+		// A real handle (GetCurrentThread() is only a pseudo handle).
+		::DuplicateHandle(::GetCurrentProcess(), ::GetCurrentThread(), ::GetCurrentProcess(), &s_mainThread,
+			THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, 0);
+		::SymSetOptions(SYMOPT_DEFERRED_LOADS | SYMOPT_UNDNAME);
+		::SymInitialize(::GetCurrentProcess(), nullptr, TRUE);   // fails harmlessly if CrashLogger did it
+	#else
+		s_mainThread = ::pthread_self();
+	#if ENG_HAS_BACKTRACE
+		void* warm[4];
+		::backtrace(warm, 4);   // load the unwinder now, not inside the handler
+	#endif
+		struct sigaction sa {};
+		sa.sa_sigaction = on_sample_signal;
+		sigemptyset(&sa.sa_mask);
+		sa.sa_flags = SA_SIGINFO | SA_RESTART;
+		::sigaction(kSampleSignal, &sa, nullptr);
+	#endif
+
+		s_running.store(true);
+		s_thread = std::thread(watchdog_main);
+		LOG_INFO("WATCHDOG", "Watchdog started (hang threshold %u ms)", cfg.hangMs);
+		return true;
+	}
+
+	void Watchdog::stop() {
+		if (!s_running.exchange(false)) return;
+		{
+			std::lock_guard<std::mutex> lk(s_mtx);
+		}
+		s_cv.notify_all();
+		if (s_thread.joinable()) s_thread.join();
+	#if defined(_WIN32)
+		if (s_mainThread) ::CloseHandle(s_mainThread);
+		s_mainThread = nullptr;
+	#endif
+	}
+
+	void Watchdog::heartbeat() noexcept {
+		s_beatNs.store(now_ns(), std::memory_order_relaxed);
+		s_beats.store(s_beats.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	void Watchdog::suspend() noexcept {
+		s_beatNs.store(0, std::memory_order_relaxed);
+	}
+
+	std::uint64_t Watchdog::hang_count() noexcept {
+		return s_hangs.load(std::memory_order_relaxed);
+	}
+
+} // namespace eng::debug
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+
+/*
+===============================================================================
+ Watchdog.h
+ ------------------------------------------------------------------------------
+ Purpose
+   Detects frames that stall (a blocking flush, a driver hang, a deadlock)
+   and records where the main thread was stuck. CrashLogger only sees
+   crashes; a frame that takes three seconds and then carries on leaves no
+   trace otherwise.
+
+ How it works
+   - The main thread calls heartbeat() once per frame (CoreEngine::GameLoop).
+	 That is one relaxed atomic store.
+   - A background thread checks the age of the last heartbeat every
+	 checkIntervalMs. Once it exceeds hangMs, it samples the main thread's
+	 stack up to 'samples' times, sampleIntervalMs apart (stopping early if
+	 the frame finishes), logs a WATCHDOG warning and, if enabled, writes
+	 hang_YYYYMMDD_HHMMSS.txt next to the executable.
+   - When the frame finally ends, one more line logs the total stall time.
+   - Linux/POSIX: the main thread is sampled by sending it kSampleSignal
+	 (SIGUSR2); the handler records the interrupted PC and backtrace() into a
+	 static buffer. The report uses the crash report layout ("PC:",
+	 "  [i] 0x...", "Memory map:"), so crash_symbolize works on it too.
+   - Windows: the main thread is suspended, its context read and walked
+	 with StackWalk64, then resumed; frames are symbolized with DbgHelp.
+
+ Usage
+   eng::debug::WatchdogConfig cfg;
+   cfg.hangMs = 1000;
+   eng::debug::Watchdog::start(cfg);     // from the main thread
+   ...
+   eng::debug::Watchdog::heartbeat();    // every frame
+   eng::debug::Watchdog::suspend();      // before intentionally long work
+   ...
+   eng::debug::Watchdog::stop();
+
+ Notes
+   - Nothing is watched until the first heartbeat(), and after suspend()
+	 nothing is watched until the next one.
+   - The report file is written before the log line: if the main thread is
+	 stuck inside the logger, the report still gets out.
+   - On Windows, hangs are ignored while a debugger is attached (a
+	 breakpoint is not a hang).
+   - POSIX: the handler is installed with SA_RESTART, but a few calls
+	 (nanosleep, poll, ...) still return EINTR when a sample lands while the
+	 main thread is blocked in them; only stalled frames are sampled.
+===============================================================================
+*/
+
+namespace eng::debug {
+
+	struct WatchdogConfig {
+		bool        enabled = true;
+		unsigned    hangMs = 1000;           // frame age that counts as a hang
+		unsigned    checkIntervalMs = 50;    // how often the watchdog looks
+		unsigned    samples = 3;             // stack samples per hang
+		unsigned    sampleIntervalMs = 250;  // spacing between samples
+		bool        writeReport = true;      // hang_*.txt next to the exe
+		unsigned    maxReports = 5;          // per run, to keep soak runs tidy
+	};
+
+	class Watchdog {
+	public:
+		// Start the watchdog thread, watching the calling thread. Returns
+		// false if disabled or already running.
+		static bool start(const WatchdogConfig& cfg);
+
+		// Stop and join the watchdog thread.
+		static void stop();
+
+		// Main thread: the current frame made progress. Never blocks.
+		static void heartbeat() noexcept;
+
+		// Main thread: stop watching until the next heartbeat() (loading
+		// screens, shutdown).
+		static void suspend() noexcept;
+
+		// Hangs detected so far.
+		static std::uint64_t hang_count() noexcept;
+	};
+
+} // namespace eng::debug
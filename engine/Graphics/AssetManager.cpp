@@ -0,0 +1,292 @@
+#include "AssetManager.h"
+#include <algorithm>
+#include <iostream>
+
+namespace Framework {
+
+    // ===== AssetHandle =====
+
+    AssetHandle::AssetHandle(AssetManager* manager, std::uint32_t slot)
+        : manager(manager), slot(slot)
+    {
+        manager->AddRef(slot);
+    }
+
+    AssetHandle::AssetHandle(const AssetHandle& other)
+        : manager(other.manager), slot(other.slot)
+    {
+        if (manager) manager->AddRef(slot);
+    }
+
+    AssetHandle::AssetHandle(AssetHandle&& other) noexcept
+        : manager(other.manager), slot(other.slot)
+    {
+        other.manager = nullptr;
+    }
+
+    AssetHandle& AssetHandle::operator=(AssetHandle other) noexcept {
+        std::swap(manager, other.manager);
+        std::swap(slot, other.slot);
+        return *this;
+    }
+
+    AssetHandle::~AssetHandle() {
+        Reset();
+    }
+
+    void AssetHandle::Reset() {
+        if (manager) manager->Release(slot);
+        manager = nullptr;
+    }
+
+    AssetState AssetHandle::GetState() const {
+        return manager ? manager->slots[slot].state : AssetState::Failed;
+    }
+
+    Mesh* AssetHandle::GetMesh() const {
+        if (!manager) return nullptr;
+        const AssetManager::Slot& s = manager->slots[slot];
+        if (s.type != AssetType::Mesh || s.state != AssetState::Ready) return nullptr;
+        return manager->uploader.GetMesh(s.object);
+    }
+
+    TextureRegion AssetHandle::GetTexture() const {
+        if (!manager) return TextureRegion{};
+        const AssetManager::Slot& s = manager->slots[slot];
+        if (s.type != AssetType::Texture || s.state != AssetState::Ready) return TextureRegion{};
+        return manager->uploader.GetTextureRegion(s.object);
+    }
+
+    // ===== AssetManager =====
+
+    AssetManager::AssetManager(IAssetUploader& uploader, unsigned workerCount)
+        : workerCount(workerCount), uploader(uploader)
+    {
+        if (this->workerCount == 0) this->workerCount = DefaultDecodeWorkers();
+    }
+
+    AssetManager::~AssetManager() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+
+        for (std::uint32_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].state == AssetState::Ready) Free(i);
+        }
+    }
+
+    AssetHandle AssetManager::LoadTexture(const std::string& path, AssetPriority priority, bool allowAtlas) {
+        return Load(AssetType::Texture, path, priority, allowAtlas);
+    }
+
+    AssetHandle AssetManager::LoadMesh(const std::string& path, AssetPriority priority) {
+        return Load(AssetType::Mesh, path, priority, false);
+    }
+
+    AssetHandle AssetManager::Load(AssetType type, const std::string& path, AssetPriority priority, bool allowAtlas) {
+        const std::string key = (type == AssetType::Texture ? "t:" : "m:") + path;
+
+        auto it = byPath.find(key);
+        if (it != byPath.end()) {
+            Slot& s = slots[it->second];
+            if (s.state == AssetState::Failed) {
+                // Try again: the file may have been added or fixed since
+                s.state = AssetState::Queued;
+                s.priority = priority;
+                s.allowAtlas = allowAtlas;
+                s.request = MakeRequest(type, path, it->second);
+                Enqueue(s);
+            }
+            else if (s.state == AssetState::Queued) {
+                if (s.request->cancelled) {
+                    // Dropped since the last Update() and wanted again
+                    s.request = MakeRequest(type, path, it->second);
+                    s.priority = priority;
+                    Enqueue(s);
+                }
+                else if (priority > s.priority) {
+                    // Queue it again higher up; whichever copy a worker takes first wins
+                    s.priority = priority;
+                    Enqueue(s);
+                }
+            }
+            return AssetHandle(this, it->second);
+        }
+
+        std::uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            index = static_cast<std::uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        Slot& s = slots[index];
+        s.type = type;
+        s.state = AssetState::Queued;
+        s.priority = priority;
+        s.path = path;
+        s.allowAtlas = allowAtlas;
+        s.request = MakeRequest(type, path, index);
+        byPath.emplace(key, index);
+        Enqueue(s);
+        return AssetHandle(this, index);
+    }
+
+    std::shared_ptr<AssetManager::Request> AssetManager::MakeRequest(AssetType type, const std::string& path,
+        std::uint32_t slot) {
+        auto request = std::make_shared<Request>();
+        request->type = type;
+        request->path = path;
+        request->slot = slot;
+        return request;
+    }
+
+    void AssetManager::Enqueue(Slot& slot) {
+        if (workers.empty()) {
+            for (unsigned i = 0; i < workerCount; ++i) workers.emplace_back(&AssetManager::WorkerMain, this);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push(Job{ slot.priority, nextSequence++, slot.request });
+        }
+        wake.notify_one();
+    }
+
+    void AssetManager::Release(std::uint32_t slot) {
+        Slot& s = slots[slot];
+        if (--s.refs > 0) return;
+        if (s.request) s.request->cancelled = true;   // workers skip it
+        unreferenced.push_back(slot);
+    }
+
+    void AssetManager::Free(std::uint32_t slot) {
+        Slot& s = slots[slot];
+        if (s.state == AssetState::Ready) {
+            if (s.type == AssetType::Mesh) uploader.DestroyMesh(s.object);
+            else uploader.DestroyTexture(s.object);
+        }
+        byPath.erase((s.type == AssetType::Texture ? "t:" : "m:") + s.path);
+        s = Slot{};
+        freeSlots.push_back(slot);
+    }
+
+    void AssetManager::WorkerMain() {
+        for (;;) {
+            std::shared_ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                request = jobs.top().request;
+                jobs.pop();
+                ++busy;
+            }
+            if (request->cancelled || request->claimed.exchange(true)) {
+                std::lock_guard<std::mutex> lock(mutex);
+                --busy;
+                idle.notify_all();
+                continue;
+            }
+
+            // I/O and decode, off the render thread
+            std::string error;
+            if (request->type == AssetType::Texture) {
+                request->ok = LoadImage(request->path, request->image, &error);
+            }
+            else {
+                request->ok = ObjLoader::Load(request->path, request->mesh, &error);
+            }
+            if (!request->ok) {
+                std::cerr << "AssetManager: " << request->path << ": " << error << "\n";
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            done.push_back(std::move(request));
+            --busy;
+            idle.notify_all();
+        }
+    }
+
+    void AssetManager::WaitForDecodes() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return jobs.empty() && busy == 0; });
+    }
+
+    std::size_t AssetManager::Upload(Slot& slot) {
+        Request& request = *slot.request;
+        std::size_t bytes = 0;
+        if (slot.type == AssetType::Texture) {
+            slot.object = uploader.CreateTexture(slot.path, request.image, slot.allowAtlas);
+            bytes = request.image.pixels.size();
+        }
+        else {
+            const ObjMesh& obj = request.mesh;
+            slot.object = uploader.CreateMesh(slot.path, obj);
+            bytes = obj.vertexCount * 6 * sizeof(float) + obj.indexCount * sizeof(std::uint32_t);
+        }
+        slot.request.reset();   // drops the decoded pixels / mapped cache
+        slot.state = AssetState::Ready;
+        return bytes;
+    }
+
+    void AssetManager::Update(std::size_t budgetBytes) {
+        // Free what nobody holds any more (unless it was loaded again since)
+        for (std::uint32_t slot : unreferenced) {
+            if (slots[slot].refs == 0 && !slots[slot].path.empty()) Free(slot);
+        }
+        unreferenced.clear();
+
+        std::vector<std::shared_ptr<Request>> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.swap(done);
+        }
+        for (const std::shared_ptr<Request>& request : finished) {
+            if (request->cancelled) continue;
+            Slot& s = slots[request->slot];
+            if (s.request != request) continue;
+            s.state = request->ok ? AssetState::Decoded : AssetState::Failed;
+            if (!request->ok) {
+                s.request.reset();
+                ++stats.failures;
+            }
+        }
+
+        // Upload decoded assets, highest priority first
+        std::vector<std::uint32_t> decoded;
+        std::size_t queued = 0, loaded = 0;
+        for (std::uint32_t i = 0; i < slots.size(); ++i) {
+            switch (slots[i].state) {
+            case AssetState::Decoded: decoded.push_back(i); break;
+            case AssetState::Queued:  if (!slots[i].path.empty()) ++queued; break;
+            case AssetState::Ready:   ++loaded; break;
+            default: break;
+            }
+        }
+        std::stable_sort(decoded.begin(), decoded.end(), [this](std::uint32_t a, std::uint32_t b) {
+            return slots[a].priority > slots[b].priority;
+        });
+
+        stats.uploadsThisFrame = 0;
+        stats.bytesThisFrame = 0;
+        for (std::uint32_t slot : decoded) {
+            if (stats.uploadsThisFrame > 0 && stats.bytesThisFrame >= budgetBytes) break;
+            stats.bytesThisFrame += Upload(slots[slot]);
+            ++stats.uploadsThisFrame;
+        }
+
+        // Mipmaps of the textures touched above
+        uploader.Flush();
+
+        stats.queued = queued;
+        stats.decoded = decoded.size() - stats.uploadsThisFrame;
+        stats.loaded = loaded + stats.uploadsThisFrame;
+    }
+
+}
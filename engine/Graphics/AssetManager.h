@@ -0,0 +1,192 @@
+#pragma once
+#include "AssetUploader.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Asynchronous asset streaming.
+//
+// Load*() returns a handle immediately; the file is read (from a mounted
+// PackFile when one holds it) and decoded on a worker thread (images with
+// stb_image, meshes through ObjLoader and its binary cache) in priority
+// order, FIFO within a priority. Update(), once
+// per frame on the render thread, creates the GPU objects for finished
+// loads, highest priority first, until the frame's byte budget is spent,
+// so a burst of loads streams in over several frames instead of hitching
+// one. Draw code checks IsReady() and skips (or uses a placeholder for)
+// assets still in flight.
+//
+// Handles are reference counted and share one load per path. When the
+// last handle of an asset goes, a pending load is cancelled and a loaded
+// asset is freed at the next Update(). Loading again while pending with a
+// higher priority moves the request up the queue; loading a path that
+// failed tries it again.
+//
+// GPU objects are made and freed through an IAssetUploader:
+// GLAssetUploader in the engine, RecordingAssetUploader in
+// tools/bench_asset_streaming, which checks all of the above without a GPU.
+// Workers start with the first load.
+//
+// Handles and every member function are for the main / render thread.
+// Shaders stay synchronous: they need the GL context to compile and are
+// already fast through ProgramCache.
+
+namespace Framework {
+
+    class Mesh;
+    class AssetManager;
+
+    enum class AssetType : std::uint8_t {
+        Texture,
+        Mesh,
+    };
+
+    enum class AssetState : std::uint8_t {
+        Queued,       // waiting for / on a worker
+        Decoded,      // waiting for upload budget
+        Ready,
+        Failed,
+    };
+
+    enum class AssetPriority : std::uint8_t {
+        Low,          // prefetch
+        Normal,
+        High,         // needed on screen now
+    };
+
+    struct AssetStats {
+        std::size_t queued = 0;           // not yet decoded
+        std::size_t decoded = 0;          // waiting for upload
+        std::size_t loaded = 0;           // ready, alive
+        std::size_t uploadsThisFrame = 0;
+        std::size_t bytesThisFrame = 0;
+        std::size_t failures = 0;
+    };
+
+    class AssetHandle {
+    public:
+        AssetHandle() = default;
+        AssetHandle(const AssetHandle& other);
+        AssetHandle(AssetHandle&& other) noexcept;
+        AssetHandle& operator=(AssetHandle other) noexcept;
+        ~AssetHandle();
+
+        bool IsValid() const { return manager != nullptr; }
+        AssetState GetState() const;
+        bool IsReady() const { return GetState() == AssetState::Ready; }
+
+        // nullptr / empty region until ready, or for the other asset type
+        Mesh* GetMesh() const;
+        TextureRegion GetTexture() const;
+
+        void Reset();
+
+    private:
+        friend class AssetManager;
+        AssetHandle(AssetManager* manager, std::uint32_t slot);
+
+        AssetManager* manager = nullptr;
+        std::uint32_t slot = 0;
+    };
+
+    class AssetManager {
+    public:
+        // 'workers' 0 picks one per spare core (at most 4). 'uploader'
+        // must outlive the manager.
+        explicit AssetManager(IAssetUploader& uploader, unsigned workers = 0);
+        ~AssetManager();   // frees every asset through the uploader; no handle may outlive it
+
+        AssetManager(const AssetManager&) = delete;
+        AssetManager& operator=(const AssetManager&) = delete;
+
+        AssetHandle LoadTexture(const std::string& path, AssetPriority priority = AssetPriority::Normal,
+            bool allowAtlas = true);
+        AssetHandle LoadMesh(const std::string& path, AssetPriority priority = AssetPriority::Normal);
+
+        // Create GPU objects for finished loads, about 'budgetBytes' per
+        // call (at least one asset), and free unreferenced ones.
+        void Update(std::size_t budgetBytes = 4u << 20);
+
+        // Block until every queued load has been read and decoded (loading
+        // screens). The results still upload through Update().
+        void WaitForDecodes();
+
+        const AssetStats& GetStats() const { return stats; }
+        std::size_t GetWorkerCount() const { return workers.size(); }
+
+    private:
+        friend class AssetHandle;
+
+        // Shared between the render thread and the worker decoding it
+        struct Request {
+            AssetType type;
+            std::string path;
+            std::uint32_t slot;
+            std::atomic<bool> claimed{ false };     // a worker has taken it
+            std::atomic<bool> cancelled{ false };
+
+            // Worker output
+            bool ok = false;
+            Image image;
+            ObjMesh mesh;
+        };
+
+        struct Slot {
+            AssetType type = AssetType::Texture;
+            AssetState state = AssetState::Queued;
+            AssetPriority priority = AssetPriority::Normal;
+            std::string path;
+            bool allowAtlas = true;
+            std::uint32_t refs = 0;
+            std::shared_ptr<Request> request;       // while not ready
+            IAssetUploader::AssetId object = 0;     // when ready
+        };
+
+        struct Job {
+            AssetPriority priority;
+            std::uint64_t sequence;
+            std::shared_ptr<Request> request;
+            bool operator<(const Job& other) const {   // max-heap: high priority, then oldest
+                if (priority != other.priority) return priority < other.priority;
+                return sequence > other.sequence;
+            }
+        };
+
+        AssetHandle Load(AssetType type, const std::string& path, AssetPriority priority, bool allowAtlas);
+        static std::shared_ptr<Request> MakeRequest(AssetType type, const std::string& path, std::uint32_t slot);
+        void Enqueue(Slot& slot);
+        void AddRef(std::uint32_t slot) { ++slots[slot].refs; }
+        void Release(std::uint32_t slot);
+        void Free(std::uint32_t slot);
+        std::size_t Upload(Slot& slot);
+        void WorkerMain();
+
+        std::vector<Slot> slots;
+        std::vector<std::uint32_t> freeSlots;
+        std::unordered_map<std::string, std::uint32_t> byPath;   // "<type>:<path>" -> slot
+        std::vector<std::uint32_t> unreferenced;                  // freed at the next Update()
+
+        // Worker side, guarded by 'mutex'
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;             // a worker finished a job
+        unsigned busy = 0;                        // jobs taken off 'jobs', not yet in 'done'
+        std::priority_queue<Job> jobs;
+        std::uint64_t nextSequence = 0;
+        std::vector<std::shared_ptr<Request>> done;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+        unsigned workerCount;
+
+        IAssetUploader& uploader;
+        AssetStats stats;
+    };
+
+}
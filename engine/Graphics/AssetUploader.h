@@ -0,0 +1,36 @@
+#pragma once
+#include "Texture.h"
+#include "ObjLoader.h"
+#include <cstdint>
+#include <string>
+
+// The GPU side of AssetManager: turning decoded images and meshes into GPU
+// objects and freeing them again. GLAssetUploader does it for real (atlas
+// packing through a TextureLoader, meshes as Mesh); RecordingAssetUploader
+// only counts, so the streaming logic (queueing, priorities, budgets,
+// reference counts) can be checked on machines without a GPU.
+// Ids are 0 for none. All calls on the render thread.
+
+namespace Framework {
+
+    class Mesh;
+
+    class IAssetUploader {
+    public:
+        using AssetId = std::uint32_t;
+
+        virtual ~IAssetUploader() = default;
+
+        virtual AssetId CreateTexture(const std::string& name, const Image& image, bool allowAtlas) = 0;
+        virtual void DestroyTexture(AssetId id) = 0;
+        virtual TextureRegion GetTextureRegion(AssetId id) const = 0;
+
+        virtual AssetId CreateMesh(const std::string& name, const ObjMesh& mesh) = 0;
+        virtual void DestroyMesh(AssetId id) = 0;
+        virtual Mesh* GetMesh(AssetId id) const = 0;
+
+        // After each batch of creates (mipmaps and the like).
+        virtual void Flush() = 0;
+    };
+
+}
@@ -0,0 +1,84 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+
+namespace Framework {
+
+    SkylinePacker::SkylinePacker(int width, int height)
+        : width(width), height(height)
+    {
+        Reset();
+    }
+
+    void SkylinePacker::Reset() {
+        skyline.assign(1, Segment{ 0, 0, width });
+        usedArea = 0;
+    }
+
+    double SkylinePacker::GetOccupancy() const {
+        const long long area = static_cast<long long>(width) * height;
+        return area > 0 ? static_cast<double>(usedArea) / area : 0.0;
+    }
+
+    int SkylinePacker::Fit(std::size_t index, int w, int h) const {
+        if (skyline[index].x + w > width) return -1;
+
+        // The rectangle rests on the highest segment it spans
+        int y = 0;
+        int remaining = w;
+        for (std::size_t i = index; remaining > 0; ++i) {
+            y = std::max(y, skyline[i].y);
+            if (y + h > height) return -1;
+            remaining -= skyline[i].width;
+        }
+        return y;
+    }
+
+    bool SkylinePacker::Pack(int w, int h, int& x, int& y) {
+        if (w <= 0 || h <= 0) return false;
+
+        std::size_t best = skyline.size();
+        int bestTop = height + 1, bestWidth = width + 1, bestY = 0;
+        for (std::size_t i = 0; i < skyline.size(); ++i) {
+            const int fitY = Fit(i, w, h);
+            if (fitY < 0) continue;
+            const int top = fitY + h;
+            if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+                best = i;
+                bestTop = top;
+                bestWidth = skyline[i].width;
+                bestY = fitY;
+            }
+        }
+        if (best == skyline.size()) return false;
+
+        x = skyline[best].x;
+        y = bestY;
+        skyline.insert(skyline.begin() + best, Segment{ x, y + h, w });
+
+        // Cut the segments now covered by the new one
+        for (std::size_t i = best + 1; i < skyline.size();) {
+            const int coveredTo = skyline[i - 1].x + skyline[i - 1].width;
+            if (skyline[i].x >= coveredTo) break;
+            const int overlap = coveredTo - skyline[i].x;
+            skyline[i].x += overlap;
+            skyline[i].width -= overlap;
+            if (skyline[i].width > 0) break;
+            skyline.erase(skyline.begin() + i);
+        }
+
+        // Merge neighbours at the same height
+        for (std::size_t i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            }
+            else {
+                ++i;
+            }
+        }
+
+        usedArea += static_cast<long long>(w) * h;
+        return true;
+    }
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Skyline rectangle packer for texture atlases. The free space is kept as
+// a "skyline": the top edge of everything placed so far, stored as
+// horizontal segments. A rectangle goes where its top ends lowest
+// (bottom-left rule), ties broken by the narrower segment. Packing is
+// O(segments) per rectangle and wastes little space for sprite-sized
+// rectangles, which is why it is preferred over a full maxrects search.
+//
+// Pure CPU and GL-free, so tools can pack atlases offline with it too.
+
+namespace Framework {
+
+    class SkylinePacker {
+    public:
+        SkylinePacker(int width, int height);
+
+        // Place a w x h rectangle. Returns false (and leaves the packer
+        // unchanged) when it does not fit.
+        bool Pack(int w, int h, int& x, int& y);
+
+        void Reset();
+
+        int GetWidth() const { return width; }
+        int GetHeight() const { return height; }
+
+        // Fraction of the area covered by packed rectangles.
+        double GetOccupancy() const;
+
+    private:
+        struct Segment {
+            int x, y, width;
+        };
+
+        // Lowest y a w x h rectangle can sit at with its left edge on
+        // segment 'index', or -1 if it does not fit there.
+        int Fit(std::size_t index, int w, int h) const;
+
+        int width, height;
+        std::vector<Segment> skyline;
+        long long usedArea = 0;
+    };
+
+}
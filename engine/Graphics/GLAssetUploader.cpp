@@ -0,0 +1,55 @@
+#include "Precompiled.h"
+#include "GLAssetUploader.h"
+#include "Mesh.h"
+
+namespace Framework {
+
+    GLAssetUploader::GLAssetUploader()
+        : textures(1)   // used for atlas packing and uploads only; its own worker never starts
+    {
+    }
+
+    GLAssetUploader::~GLAssetUploader() = default;
+
+    IAssetUploader::AssetId GLAssetUploader::CreateTexture(const std::string& name, const Image& image, bool allowAtlas) {
+        return textures.Insert(name, image, allowAtlas);
+    }
+
+    void GLAssetUploader::DestroyTexture(AssetId id) {
+        textures.Release(id);
+    }
+
+    TextureRegion GLAssetUploader::GetTextureRegion(AssetId id) const {
+        return textures.GetRegion(id);
+    }
+
+    IAssetUploader::AssetId GLAssetUploader::CreateMesh(const std::string&, const ObjMesh& obj) {
+        auto mesh = std::make_unique<Mesh>(obj.vertices, obj.vertexCount, GL_TRIANGLES, MeshUsage::StaticNoShadow);
+        mesh->SetIndices(obj.indices, obj.indexCount);
+
+        if (!freeMeshIds.empty()) {
+            const AssetId id = freeMeshIds.back();
+            freeMeshIds.pop_back();
+            meshes[id - 1] = std::move(mesh);
+            return id;
+        }
+        meshes.push_back(std::move(mesh));
+        return static_cast<AssetId>(meshes.size());
+    }
+
+    void GLAssetUploader::DestroyMesh(AssetId id) {
+        if (id == 0 || id > meshes.size() || !meshes[id - 1]) return;
+        meshes[id - 1].reset();
+        freeMeshIds.push_back(id);
+    }
+
+    Mesh* GLAssetUploader::GetMesh(AssetId id) const {
+        return (id == 0 || id > meshes.size()) ? nullptr : meshes[id - 1].get();
+    }
+
+    void GLAssetUploader::Flush() {
+        // Mipmaps of the textures touched since the last call
+        textures.Update(0);
+    }
+
+}
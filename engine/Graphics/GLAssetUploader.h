@@ -0,0 +1,34 @@
+#pragma once
+#include "AssetUploader.h"
+#include <memory>
+#include <vector>
+
+namespace Framework {
+
+    // IAssetUploader on the GL context: images through a TextureLoader
+    // (atlas packing, staged uploads, mipmaps), meshes as static Mesh
+    // objects with no CPU copy kept.
+    class GLAssetUploader : public IAssetUploader {
+    public:
+        GLAssetUploader();
+        ~GLAssetUploader() override;   // before the GL context goes
+
+        AssetId CreateTexture(const std::string& name, const Image& image, bool allowAtlas) override;
+        void DestroyTexture(AssetId id) override;
+        TextureRegion GetTextureRegion(AssetId id) const override;
+
+        AssetId CreateMesh(const std::string& name, const ObjMesh& mesh) override;
+        void DestroyMesh(AssetId id) override;
+        Mesh* GetMesh(AssetId id) const override;
+
+        void Flush() override;
+
+        TextureLoader& GetTextures() { return textures; }
+
+    private:
+        TextureLoader textures;
+        std::vector<std::unique_ptr<Mesh>> meshes;   // index = id - 1
+        std::vector<AssetId> freeMeshIds;
+    };
+
+}
@@ -0,0 +1,109 @@
+#include "GLRenderBackend.h"
+#include "GLState.h"
+#include "GL/glew.h"
+#include "GL/gl.h"
+
+namespace Framework {
+
+    namespace {
+        GLenum ToGL(Primitive primitive) {
+            switch (primitive) {
+            case Primitive::Lines:       return GL_LINES;
+            case Primitive::TriangleFan: return GL_TRIANGLE_FAN;
+            default:                     return GL_TRIANGLES;
+            }
+        }
+    }
+
+    unsigned GLRenderBackend::CreateVertexBuffer(std::size_t bytes) {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+        return buffer;
+    }
+
+    void GLRenderBackend::DestroyBuffer(unsigned buffer) {
+        GLState::DeleteBuffer(buffer);
+    }
+
+    unsigned GLRenderBackend::CreateVertexArray(unsigned buffer, const VertexAttrib* attribs,
+        std::size_t attribCount, std::size_t stride) {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        GLState::BindVertexArray(vao);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        for (std::size_t i = 0; i < attribCount; ++i) {
+            glVertexAttribPointer(attribs[i].location, attribs[i].components, GL_FLOAT, GL_FALSE,
+                static_cast<GLsizei>(stride), reinterpret_cast<const void*>(attribs[i].offset));
+            glEnableVertexAttribArray(attribs[i].location);
+        }
+        GLState::BindVertexArray(0);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+        return vao;
+    }
+
+    void GLRenderBackend::DestroyVertexArray(unsigned vao) {
+        GLState::DeleteVertexArray(vao);
+    }
+
+    void GLRenderBackend::OrphanBuffer(unsigned buffer, std::size_t bytes) {
+        GLState::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+    }
+
+    void* GLRenderBackend::MapBufferRange(unsigned buffer, std::size_t offset, std::size_t bytes) {
+        GLState::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        return glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    }
+
+    void GLRenderBackend::UnmapBuffer(unsigned buffer) {
+        GLState::BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    void GLRenderBackend::UseProgram(unsigned program) {
+        GLState::UseProgram(program);
+    }
+
+    void GLRenderBackend::BindTexture(unsigned unit, unsigned texture) {
+        GLState::BindTexture(unit, GL_TEXTURE_2D, texture);
+    }
+
+    void GLRenderBackend::BindVertexArray(unsigned vao) {
+        GLState::BindVertexArray(vao);
+    }
+
+    void GLRenderBackend::DrawArrays(Primitive primitive, std::size_t first, std::size_t count) {
+        glDrawArrays(ToGL(primitive), static_cast<GLint>(first), static_cast<GLsizei>(count));
+    }
+
+    void GLRenderBackend::DrawArraysInstanced(Primitive primitive, std::size_t first, std::size_t count,
+        std::size_t instances) {
+        glDrawArraysInstanced(ToGL(primitive), static_cast<GLint>(first), static_cast<GLsizei>(count),
+            static_cast<GLsizei>(instances));
+    }
+
+    void GLRenderBackend::DrawElements(Primitive primitive, IndexType type, std::size_t first, std::size_t count,
+        std::size_t baseVertex, std::size_t instances) {
+        if (type == IndexType::None) return;
+        const GLenum glType = (type == IndexType::UInt16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        const std::size_t indexSize = (type == IndexType::UInt16) ? 2 : 4;
+        void* offset = reinterpret_cast<void*>(first * indexSize);
+        if (instances > 0) {
+            glDrawElementsInstancedBaseVertex(ToGL(primitive), static_cast<GLsizei>(count), glType, offset,
+                static_cast<GLsizei>(instances), static_cast<GLint>(baseVertex));
+        }
+        else {
+            glDrawElementsBaseVertex(ToGL(primitive), static_cast<GLsizei>(count), glType, offset,
+                static_cast<GLint>(baseVertex));
+        }
+    }
+
+    void GLRenderBackend::SetUniform3f(int location, float x, float y, float z) {
+        if (location >= 0) glUniform3f(location, x, y, z);
+    }
+
+}
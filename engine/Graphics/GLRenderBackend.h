@@ -0,0 +1,31 @@
+#pragma once
+#include "RenderBackend.h"
+
+namespace Framework {
+
+    // IRenderBackend on top of the current OpenGL context.
+    class GLRenderBackend : public IRenderBackend {
+    public:
+        unsigned CreateVertexBuffer(std::size_t bytes) override;
+        void DestroyBuffer(unsigned buffer) override;
+
+        unsigned CreateVertexArray(unsigned buffer, const VertexAttrib* attribs,
+            std::size_t attribCount, std::size_t stride) override;
+        void DestroyVertexArray(unsigned vao) override;
+
+        void OrphanBuffer(unsigned buffer, std::size_t bytes) override;
+        void* MapBufferRange(unsigned buffer, std::size_t offset, std::size_t bytes) override;
+        void UnmapBuffer(unsigned buffer) override;
+
+        void UseProgram(unsigned program) override;
+        void BindTexture(unsigned unit, unsigned texture) override;
+        void BindVertexArray(unsigned vao) override;
+        void DrawArrays(Primitive primitive, std::size_t first, std::size_t count) override;
+        void DrawArraysInstanced(Primitive primitive, std::size_t first, std::size_t count,
+            std::size_t instances) override;
+        void DrawElements(Primitive primitive, IndexType type, std::size_t first, std::size_t count,
+            std::size_t baseVertex, std::size_t instances) override;
+        void SetUniform3f(int location, float x, float y, float z) override;
+    };
+
+}
@@ -0,0 +1,159 @@
+#include "GLState.h"
+#include "GL/glew.h"
+#include "GL/gl.h"
+
+namespace Framework {
+
+    namespace {
+        constexpr unsigned kUnknown = ~0u;       // forces the next call through
+        constexpr unsigned kTextureUnits = 32;
+        constexpr unsigned kUniformBindings = 16;
+
+        // Generic buffer targets that are context state (not vertex array state)
+        enum BufferSlot { ArrayBuffer, UniformBuffer, PixelPack, PixelUnpack, CopyRead, CopyWrite, BufferSlots };
+
+        int SlotOf(unsigned target) {
+            switch (target) {
+            case GL_ARRAY_BUFFER:        return ArrayBuffer;
+            case GL_UNIFORM_BUFFER:      return UniformBuffer;
+            case GL_PIXEL_PACK_BUFFER:   return PixelPack;
+            case GL_PIXEL_UNPACK_BUFFER: return PixelUnpack;
+            case GL_COPY_READ_BUFFER:    return CopyRead;
+            case GL_COPY_WRITE_BUFFER:   return CopyWrite;
+            default:                     return -1;
+            }
+        }
+
+        struct Shadow {
+            unsigned program = kUnknown;
+            unsigned vao = kUnknown;
+            unsigned buffers[BufferSlots];
+            unsigned uniformBindings[kUniformBindings];
+            unsigned activeUnit = kUnknown;
+            unsigned textures[kTextureUnits];
+            int blend = -1;
+            unsigned blendSrc = kUnknown, blendDst = kUnknown;
+
+            Shadow() { Reset(); }
+            void Reset() {
+                program = vao = activeUnit = blendSrc = blendDst = kUnknown;
+                blend = -1;
+                for (unsigned& b : buffers) b = kUnknown;
+                for (unsigned& b : uniformBindings) b = kUnknown;
+                for (unsigned& t : textures) t = kUnknown;
+            }
+        };
+
+        Shadow s_state;
+    }
+
+    GLState::Counters GLState::counters;
+
+    void GLState::UseProgram(unsigned program) {
+        if (s_state.program == program) { ++counters.elided; return; }
+        s_state.program = program;
+        glUseProgram(program);
+        ++counters.issued;
+    }
+
+    void GLState::BindVertexArray(unsigned vao) {
+        if (s_state.vao == vao) { ++counters.elided; return; }
+        s_state.vao = vao;
+        glBindVertexArray(vao);
+        ++counters.issued;
+    }
+
+    void GLState::BindBuffer(unsigned target, unsigned buffer) {
+        const int slot = SlotOf(target);
+        if (slot >= 0) {
+            if (s_state.buffers[slot] == buffer) { ++counters.elided; return; }
+            s_state.buffers[slot] = buffer;
+        }
+        glBindBuffer(target, buffer);
+        ++counters.issued;
+    }
+
+    void GLState::BindBufferBase(unsigned target, unsigned index, unsigned buffer) {
+        const bool tracked = (target == GL_UNIFORM_BUFFER && index < kUniformBindings);
+        if (tracked && s_state.uniformBindings[index] == buffer) { ++counters.elided; return; }
+        if (tracked) s_state.uniformBindings[index] = buffer;
+
+        // Also binds the generic target
+        const int slot = SlotOf(target);
+        if (slot >= 0) s_state.buffers[slot] = buffer;
+
+        glBindBufferBase(target, index, buffer);
+        ++counters.issued;
+    }
+
+    void GLState::ActiveTexture(unsigned unit) {
+        if (s_state.activeUnit == unit) { ++counters.elided; return; }
+        s_state.activeUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        ++counters.issued;
+    }
+
+    void GLState::BindTexture(unsigned unit, unsigned target, unsigned texture) {
+        const bool tracked = (target == GL_TEXTURE_2D && unit < kTextureUnits);
+        if (tracked && s_state.textures[unit] == texture) { ++counters.elided; return; }
+        ActiveTexture(unit);
+        if (tracked) s_state.textures[unit] = texture;
+        glBindTexture(target, texture);
+        ++counters.issued;
+    }
+
+    void GLState::SetBlend(bool enabled) {
+        if (s_state.blend == (enabled ? 1 : 0)) { ++counters.elided; return; }
+        s_state.blend = enabled ? 1 : 0;
+        if (enabled) glEnable(GL_BLEND);
+        else glDisable(GL_BLEND);
+        ++counters.issued;
+    }
+
+    void GLState::BlendFunc(unsigned src, unsigned dst) {
+        if (s_state.blendSrc == src && s_state.blendDst == dst) { ++counters.elided; return; }
+        s_state.blendSrc = src;
+        s_state.blendDst = dst;
+        glBlendFunc(src, dst);
+        ++counters.issued;
+    }
+
+    void GLState::DeleteProgram(unsigned program) {
+        // A program in use stays current until another is bound, so keep the
+        // shadow but make the next UseProgram reach GL.
+        if (s_state.program == program) s_state.program = kUnknown;
+        glDeleteProgram(program);
+    }
+
+    void GLState::DeleteVertexArray(unsigned vao) {
+        if (s_state.vao == vao) s_state.vao = 0;
+        GLuint name = vao;
+        glDeleteVertexArrays(1, &name);
+    }
+
+    void GLState::DeleteBuffer(unsigned buffer) {
+        for (unsigned& b : s_state.buffers) if (b == buffer) b = 0;
+        for (unsigned& b : s_state.uniformBindings) if (b == buffer) b = 0;
+        GLuint name = buffer;
+        glDeleteBuffers(1, &name);
+    }
+
+    void GLState::DeleteTexture(unsigned texture) {
+        for (unsigned& t : s_state.textures) if (t == texture) t = 0;
+        GLuint name = texture;
+        glDeleteTextures(1, &name);
+    }
+
+    bool GLState::WaitAndDeleteFence(void* fence) {
+        GLsync sync = static_cast<GLsync>(fence);
+        const bool stalled = glClientWaitSync(sync, 0, 0) == GL_TIMEOUT_EXPIRED;
+        if (stalled) glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);   // 1 s cap
+        glDeleteSync(sync);
+        return stalled;
+    }
+
+    void GLState::Invalidate() {
+        s_state.Reset();
+    }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+
+// Shadow copy of the GL binding state. Every bind in the engine goes
+// through here; a call that would set what is already bound is dropped
+// before it reaches the driver. Counts of calls issued and elided are
+// published to PerfViewer by GraphicsSystem each frame.
+//
+// Tracked: program, vertex array, generic buffer bindings (array, uniform,
+// pixel pack/unpack, copy read/write), indexed uniform buffer bindings,
+// the active texture unit and the 2D texture of each unit, blend enable
+// and blend func. Element array buffers are vertex array state and are
+// never cached.
+//
+// Single GL context, GL thread only. Call Invalidate() after code that
+// changes GL state behind GLState's back (e.g. a third-party UI library).
+
+namespace Framework {
+
+    class GLState {
+    public:
+        struct Counters {
+            std::size_t issued = 0;
+            std::size_t elided = 0;
+        };
+
+        static void UseProgram(unsigned program);
+        static void BindVertexArray(unsigned vao);
+        static void BindBuffer(unsigned target, unsigned buffer);
+        static void BindBufferBase(unsigned target, unsigned index, unsigned buffer);
+        static void ActiveTexture(unsigned unit);
+        static void BindTexture(unsigned unit, unsigned target, unsigned texture);
+
+        static void SetBlend(bool enabled);
+        static void BlendFunc(unsigned src, unsigned dst);
+
+        // Delete through here so a deleted name that was bound reads as 0,
+        // as it does in GL.
+        static void DeleteProgram(unsigned program);
+        static void DeleteVertexArray(unsigned vao);
+        static void DeleteBuffer(unsigned buffer);
+        static void DeleteTexture(unsigned texture);
+
+        // Wait for a glFenceSync fence (at most 1 s), then delete it. For
+        // ring buffers that reuse a region once the GPU is done with it;
+        // returns true when the fence had not signaled yet (a stall).
+        static bool WaitAndDeleteFence(void* fence);
+
+        // Forget everything; the next bind of each kind always reaches GL.
+        static void Invalidate();
+
+        static const Counters& GetCounters() { return counters; }
+        static void ResetCounters() { counters = Counters{}; }
+
+    private:
+        static Counters counters;
+    };
+
+}
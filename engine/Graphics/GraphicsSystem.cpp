@@ -4,10 +4,20 @@
 #include "GL/glew.h"
 #include "GL/gl.h"
 #include <GLFW/glfw3.h>
+#include <cstdlib>
 
 #include "Shader.h"
 #include "Mesh.h"
 #include "MeshFactory.h"
+#include "GLRenderBackend.h"
+#include "SpriteBatch.h"
+#include "RenderCommandBuffer.h"
+#include "UniformBuffer.h"
+#include "GLState.h"
+#include "ShaderHotReload.h"
+#include "AssetManager.h"
+#include "GLAssetUploader.h"
+#include "DebugComponents/PerfViewer.h"
 
 
 namespace Framework
@@ -20,11 +30,20 @@ namespace Framework
     GraphicsSystem::~GraphicsSystem()
     {
         std::cout << "GraphicsSystem: Cleaning up...\n";
+        delete shaderReload;   // before the shaders it watches
         for (auto mesh : meshes) {
-            if (mesh) {
+            if (mesh && !IsSharedMesh(mesh)) {
                 delete mesh;
             }
         }
+        ReleaseSharedMeshes();
+        delete assets;
+        delete assetUploader;
+        delete instancedShader;
+        delete frameUniforms;
+        delete commands;
+        delete spriteBatch;
+        delete renderBackend;
         delete shader;
     }
 
@@ -62,6 +81,7 @@ namespace Framework
         // Load shaders with better error handling
         try {
             shader = new Shader("shaders/basic.vert", "shaders/basic.frag");
+            instancedShader = new Shader("shaders/instanced.vert", "shaders/basic.frag");
             std::cout << "Shaders loaded successfully\n";
         }
         catch (const std::exception& e) {
@@ -69,26 +89,33 @@ namespace Framework
             return;
         }
 
-        // Create multiple meshes
-        meshes.push_back(CreateTriangle());
-        meshes.push_back(CreateQuad());
-        meshes.push_back(CreateLine());
-        meshes.push_back(CreateCircle(40, 0.5f));
-
-        meshColors.push_back(glm::vec3(1.0f, 0.0f, 0.0f)); // Red
-        meshColors.push_back(glm::vec3(0.0f, 1.0f, 0.0f)); // Green
-        meshColors.push_back(glm::vec3(0.0f, 0.0f, 1.0f)); // Blue
-        meshColors.push_back(glm::vec3(1.0f, 1.0f, 0.0f)); // Yellow
+        // Shader hot reload, debug builds only unless
+        // STRUCTSQUAD_SHADER_RELOAD=1 (=0 turns it off in debug too)
+#ifdef _DEBUG
+        bool watchShaders = true;
+#else
+        bool watchShaders = false;
+#endif
+        if (const char* reload = std::getenv("STRUCTSQUAD_SHADER_RELOAD")) watchShaders = std::string(reload) != "0";
+        if (watchShaders) {
+            shaderReload = new ShaderHotReload();
+            shaderReload->Watch(shader);
+            shaderReload->Watch(instancedShader);
+        }
 
-        currentMeshIndex = 0;  // start with first mesh
+        // Create multiple meshes
+        CreateDemoMeshes();
 
         std::cout << "Multiple meshes created successfully\n";
 
-        // Just draw the first mesh on init
-        shader->Bind();
-        if (!meshes.empty()) {
-            meshes[currentMeshIndex]->Draw();
-        }
+        renderBackend = new GLRenderBackend();
+        spriteBatch = new SpriteBatch(*renderBackend);
+        commands = new RenderCommandBuffer();
+        frameUniforms = new UniformBuffer(sizeof(FrameData), kFrameDataBinding);
+        frameUniforms->Update(FrameData{});
+        assetUploader = new GLAssetUploader();
+        assets = new AssetManager(*assetUploader);
+
     }
 
     void GraphicsSystem::Update(float dt)
@@ -102,6 +129,12 @@ namespace Framework
             return;
         }
 
+        // Swap in rebuilt shaders before anything of this frame is recorded
+        if (shaderReload) shaderReload->Update();
+
+        // Upload assets decoded since last frame (4 MB budget)
+        if (assets) assets->Update();
+
         // Rendering
         BeginFrame();
 
@@ -110,13 +143,53 @@ namespace Framework
             return;
         }
 
-        shader->Bind();
+        FrameData frame;
+        frame.time = glm::vec4(static_cast<float>(glfwGetTime()), dt, 0.0f, 0.0f);
+        frameUniforms->Update(frame);
 
-        SetCurrentMeshColor();
+        // Animate the Dynamic demo meshes before anything draws them
+        for (Mesh* mesh : meshes) {
+            if (mesh && mesh->GetUsage() == MeshUsage::Dynamic) UpdateWave(*mesh, frame.time.x);
+        }
 
-        if (currentMeshIndex >= 0 && currentMeshIndex < (int)meshes.size()) {
-            if (meshes[currentMeshIndex])
-                meshes[currentMeshIndex]->Draw();
+        if (instanceDemo && instancedShader) {
+            DrawInstanceDemo();
+        }
+        else if (batchDemo && spriteBatch) {
+            DrawBatchDemo();
+        }
+        else if (currentMeshIndex >= 0 && currentMeshIndex < (int)meshes.size() && meshes[currentMeshIndex] && instancedShader) {
+            // One instance, so the mesh's scale applies (the basic shader
+            // has no transform)
+            const glm::vec3 color = GetCurrentMeshColor();
+            MeshInstance instance;
+            instance.scaleX = instance.scaleY = meshScales[currentMeshIndex];
+            instance.r = color.r;
+            instance.g = color.g;
+            instance.b = color.b;
+            SubmitInstance(meshes[currentMeshIndex], instance);
+            FlushInstances();
+        }
+
+        commands->Execute(*renderBackend);
+
+        // Dynamic mesh copies read by the draws just issued
+        Mesh::FenceSubmittedDraws();
+
+        // Binds issued vs. dropped by the state cache this frame
+        static const auto kGLIssued = eng::debug::PerfViewer::register_stat("GL binds");
+        static const auto kGLElided = eng::debug::PerfViewer::register_stat("GL binds elided");
+        eng::debug::PerfViewer::add_stat(kGLIssued, GLState::GetCounters().issued);
+        eng::debug::PerfViewer::add_stat(kGLElided, GLState::GetCounters().elided);
+        GLState::ResetCounters();
+
+        // Streaming: KB uploaded this frame and assets still on their way
+        static const auto kAssetUploadKB = eng::debug::PerfViewer::register_stat("Asset upload KB");
+        static const auto kAssetsPending = eng::debug::PerfViewer::register_stat("Assets pending");
+        if (assets) {
+            const AssetStats& s = assets->GetStats();
+            eng::debug::PerfViewer::add_stat(kAssetUploadKB, s.bytesThisFrame / 1024);
+            eng::debug::PerfViewer::add_stat(kAssetsPending, s.queued + s.decoded);
         }
 
         // Check for OpenGL errors
@@ -159,10 +232,10 @@ namespace Framework
 
             if (meshes.empty()) return;
 
-            // Delete current mesh if valid
+            // Delete current mesh if valid (a shared one is only dropped)
             if (currentMeshIndex >= 0 && currentMeshIndex < (int)meshes.size()) {
                 if (meshes[currentMeshIndex]) {
-                    delete meshes[currentMeshIndex];
+                    if (!IsSharedMesh(meshes[currentMeshIndex])) delete meshes[currentMeshIndex];
                     meshes[currentMeshIndex] = nullptr;
                 }
             }
@@ -178,20 +251,7 @@ namespace Framework
 
             if (allDeleted) {
                 // Recreate all meshes since all are deleted (reset)
-                meshes.clear();
-                meshColors.clear();
-
-                meshes.push_back(CreateTriangle());
-                meshes.push_back(CreateQuad());
-                meshes.push_back(CreateLine());
-                meshes.push_back(CreateCircle(40, 0.5f));
-
-                meshColors.push_back(glm::vec3(1.0f, 0.0f, 0.0f)); // Red
-                meshColors.push_back(glm::vec3(0.0f, 1.0f, 0.0f)); // Green
-                meshColors.push_back(glm::vec3(0.0f, 0.0f, 1.0f)); // Blue
-                meshColors.push_back(glm::vec3(1.0f, 1.0f, 0.0f)); // Yellow
-
-                currentMeshIndex = 0;
+                CreateDemoMeshes();
             }
             else {
                 // Move to next valid mesh (skip deleted ones)
@@ -205,13 +265,154 @@ namespace Framework
         }
 
         dPressedLastFrame = dPressedNow;
+
+        static bool bPressedLastFrame = false;
+        bool bPressedNow = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
+        if (bPressedNow && !bPressedLastFrame) {
+            batchDemo = !batchDemo;
+            std::cout << "Batched mesh grid " << (batchDemo ? "on" : "off") << "\n";
+        }
+        bPressedLastFrame = bPressedNow;
+
+        static bool iPressedLastFrame = false;
+        bool iPressedNow = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+        if (iPressedNow && !iPressedLastFrame) {
+            instanceDemo = !instanceDemo;
+            std::cout << "Instanced mesh grid " << (instanceDemo ? "on" : "off") << "\n";
+        }
+        iPressedLastFrame = iPressedNow;
     }
 
-    void GraphicsSystem::SetCurrentMeshColor() {
-        if (!shader || currentMeshIndex < 0 || currentMeshIndex >= (int)meshColors.size()) return;
+    void GraphicsSystem::CreateDemoMeshes() {
+        meshes.clear();
+        meshColors.clear();
+        meshScales.clear();
 
-        GLuint shaderID = shader->GetID();
-        GLint colorLoc = glGetUniformLocation(shaderID, "uColor");
+        meshes.push_back(CreateTriangle());
+        meshes.push_back(CreateQuad());
+        meshes.push_back(CreateLine());
+        meshes.push_back(GetUnitCircle(40));   // shared; radius 0.5 through its scale
+        meshes.push_back(CreateWave(64));      // Dynamic; new vertices every frame
+
+        meshColors.push_back(glm::vec3(1.0f, 0.0f, 0.0f)); // Red
+        meshColors.push_back(glm::vec3(0.0f, 1.0f, 0.0f)); // Green
+        meshColors.push_back(glm::vec3(0.0f, 0.0f, 1.0f)); // Blue
+        meshColors.push_back(glm::vec3(1.0f, 1.0f, 0.0f)); // Yellow
+        meshColors.push_back(glm::vec3(1.0f, 1.0f, 1.0f)); // White (keeps its own colors)
+
+        meshScales = { 1.0f, 1.0f, 1.0f, 0.5f, 1.5f };
+
+        currentMeshIndex = 0;  // start with first mesh
+    }
+
+    void GraphicsSystem::SubmitInstance(Mesh* mesh, const MeshInstance& instance) {
+        if (mesh) instanceGroups[mesh].push_back(instance);
+    }
+
+    RenderCommand GraphicsSystem::MeshCommand(const Mesh& mesh, const Shader& program) const {
+        RenderCommand cmd;
+        cmd.vao = mesh.GetVAO();
+        cmd.program = program.GetID();
+        if (mesh.GetIndexType()) {
+            cmd.indexType = (mesh.GetIndexType() == GL_UNSIGNED_SHORT) ? IndexType::UInt16 : IndexType::UInt32;
+            cmd.baseVertex = mesh.GetDrawFirstVertex();
+            cmd.count = mesh.GetIndexCount();
+        }
+        else {
+            cmd.first = mesh.GetDrawFirstVertex();
+            cmd.count = mesh.GetVertexCount();
+        }
+        switch (mesh.GetDrawMode()) {
+        case GL_LINES:        cmd.primitive = Primitive::Lines; break;
+        case GL_TRIANGLE_FAN: cmd.primitive = Primitive::TriangleFan; break;
+        default:              cmd.primitive = Primitive::Triangles; break;
+        }
+        return cmd;
+    }
+
+    void GraphicsSystem::FlushInstances() {
+        RenderCommandBuffer::List& list = commands->GetList();
+        instancedShader->SetVec3("uColor", glm::vec3(1.0f));
+        for (auto it = instanceGroups.begin(); it != instanceGroups.end();) {
+            // Meshes not submitted this frame may have been deleted since
+            if (it->second.empty()) {
+                it = instanceGroups.erase(it);
+                continue;
+            }
+            it->first->SetInstances(it->second);
+            RenderCommand cmd = MeshCommand(*it->first, *instancedShader);
+            cmd.instances = static_cast<std::uint32_t>(it->second.size());
+            list.Draw(MakeSortKey(0, cmd.program, cmd.texture, 0.0f), cmd);
+            it->second.clear();   // keep the capacity for next frame
+            ++it;
+        }
+    }
+
+    void GraphicsSystem::DrawInstanceDemo() {
+        // Same grid as DrawBatchDemo, rotating, one instanced draw per mesh
+        const int cols = 32, rows = 24;
+        const float cellW = 2.0f / cols, cellH = 2.0f / rows;
+        const float angle = static_cast<float>(glfwGetTime());
+
+        int i = 0;
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x, ++i) {
+                Mesh* mesh = meshes.empty() ? nullptr : meshes[i % meshes.size()];
+                if (!mesh) continue;
+
+                const glm::vec3& color = meshColors[i % meshColors.size()];
+                MeshInstance instance;
+                instance.x = -1.0f + (x + 0.5f) * cellW;
+                instance.y = -1.0f + (y + 0.5f) * cellH;
+                instance.scaleX = instance.scaleY = 0.4f * cellH * meshScales[i % meshScales.size()];
+                instance.rotation = angle + 0.1f * i;
+                instance.r = color.r;
+                instance.g = color.g;
+                instance.b = color.b;
+                SubmitInstance(mesh, instance);
+            }
+        }
+        FlushInstances();
+    }
+
+    void GraphicsSystem::DrawBatchDemo() {
+        // 32 x 24 grid cycling through the live meshes: one draw per
+        // primitive type instead of one per mesh.
+        const int cols = 32, rows = 24;
+        const float cellW = 2.0f / cols, cellH = 2.0f / rows;
+
+        BatchState state;
+        state.program = shader->GetID();
+        shader->SetVec3("uColor", glm::vec3(1.0f));
+
+        spriteBatch->Begin();
+        int i = 0;
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x, ++i) {
+                const Mesh* mesh = meshes.empty() ? nullptr : meshes[i % meshes.size()];
+                if (!mesh) continue;
+
+                Topology topology = Topology::Triangles;
+                if (mesh->GetDrawMode() == GL_TRIANGLE_FAN) topology = Topology::TriangleFan;
+                else if (mesh->GetDrawMode() == GL_LINES) topology = Topology::Lines;
+
+                const float cx = -1.0f + (x + 0.5f) * cellW, cy = -1.0f + (y + 0.5f) * cellH;
+                const float scale = 0.4f * cellH * meshScales[i % meshScales.size()];
+                if (mesh->GetIndexCount() > 0) {
+                    spriteBatch->SubmitIndexed(state, mesh->GetVertices().data(), mesh->GetIndices().data(),
+                        mesh->GetIndexCount(), topology, cx, cy, scale);
+                }
+                else {
+                    spriteBatch->SubmitVertices(state, mesh->GetVertices().data(), mesh->GetVertexCount(), topology,
+                        cx, cy, scale);
+                }
+            }
+        }
+        spriteBatch->End();
+    }
+
+    glm::vec3 GraphicsSystem::GetCurrentMeshColor() {
+        if (currentMeshIndex < 0 || currentMeshIndex >= (int)meshColors.size()) return glm::vec3(1.0f);
 
         glm::vec3 baseColor = meshColors[currentMeshIndex];
         glm::vec3 targetColor = glm::vec3(1.0f) - baseColor; // Invert color as a target, just for demo
@@ -220,11 +421,8 @@ namespace Framework
             colorLerpTime += colorLerpSpeed * 0.016f; // assuming 60 FPS or pass dt
             if (colorLerpTime > 1.0f) colorLerpTime = 0.0f;
 
-            glm::vec3 result = glm::mix(baseColor, targetColor, colorLerpTime);
-            glUniform3f(colorLoc, result.r, result.g, result.b);
-        }
-        else {
-            glUniform3f(colorLoc, baseColor.r, baseColor.g, baseColor.b);
+            return glm::mix(baseColor, targetColor, colorLerpTime);
         }
+        return baseColor;
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "Interface.h"
 #include <glm/glm.hpp>
+#include <unordered_map>
 
 // Forward declarations
 struct GLFWwindow;
@@ -8,6 +9,15 @@ struct GLFWwindow;
 namespace Framework {
     class Shader;
     class Mesh;
+    class GLRenderBackend;
+    class SpriteBatch;
+    class RenderCommandBuffer;
+    class UniformBuffer;
+    class ShaderHotReload;
+    class AssetManager;
+    class GLAssetUploader;
+    struct RenderCommand;
+    struct MeshInstance;
 }
 
 namespace Framework {
@@ -19,25 +29,59 @@ namespace Framework {
         virtual void Initialize() override;
         virtual void Update(float dt) override;
         virtual void SendEngineMessage(Message* message) override;
+        virtual const char* GetName() const override { return "Graphics"; }
 
         void SetWindow(GLFWwindow* window) { this->window = window; }
 
+        // Queue one instance of 'mesh' for this frame. Instances of the same
+        // mesh are drawn together with one instanced draw call.
+        void SubmitInstance(Mesh* mesh, const MeshInstance& instance);
+
     private:
         void BeginFrame();
         void EndFrame();
         void ProcessInput();
 
-        void SetCurrentMeshColor();
+        void CreateDemoMeshes();
+        glm::vec3 GetCurrentMeshColor();
+        RenderCommand MeshCommand(const Mesh& mesh, const Shader& program) const;
+        void DrawBatchDemo();
+        void DrawInstanceDemo();
+        void FlushInstances();
 
         GLFWwindow* window;
 
         Shader* shader;
 
+        // Rebuilds shaders whose files change; swaps at the start of Update
+        ShaderHotReload* shaderReload = nullptr;
+
         Mesh* triangleMesh;
-        std::vector<Mesh*> meshes;
+        std::vector<Mesh*> meshes;            // shared ones (IsSharedMesh) are not ours to delete
         std::vector<glm::vec3> meshColors;
+        std::vector<float> meshScales;        // applied through the instance / batch transform
         int currentMeshIndex = 0;
 
+        // Textures and meshes load on workers and upload a budget per frame
+        AssetManager* assets = nullptr;
+        GLAssetUploader* assetUploader = nullptr;
+
+        // Draws are recorded here and executed in key order at the end of Update
+        RenderCommandBuffer* commands = nullptr;
+
+        // FrameData block shared by every program (binding 0)
+        UniformBuffer* frameUniforms = nullptr;
+
+        // Batched path: B toggles a grid of every mesh drawn through SpriteBatch
+        GLRenderBackend* renderBackend = nullptr;
+        SpriteBatch* spriteBatch = nullptr;
+        bool batchDemo = false;
+
+        // Instanced path: I toggles the same grid drawn with one call per mesh
+        Shader* instancedShader = nullptr;
+        std::unordered_map<Mesh*, std::vector<MeshInstance>> instanceGroups;
+        bool instanceDemo = false;
+
         // Interpolation
         float colorLerpTime = 0.0f;
         float colorLerpSpeed = 0.25f;
@@ -0,0 +1,50 @@
+#include "Graphics/Image.h"
+#include "PackFile.h"
+#include <algorithm>
+#include <thread>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_TGA
+#define STBI_ONLY_BMP
+#include "stb_image.h"
+
+namespace Framework {
+
+    namespace {
+        bool TakePixels(stbi_uc* pixels, int width, int height, Image& image, std::string* error) {
+            if (!pixels) {
+                if (error) *error = stbi_failure_reason();
+                return false;
+            }
+            image.width = width;
+            image.height = height;
+            image.pixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * 4);
+            stbi_image_free(pixels);
+            return true;
+        }
+    }
+
+    bool LoadImage(const std::string& path, Image& image, std::string* error) {
+        std::vector<unsigned char> scratch;
+        std::span<const unsigned char> packed;
+        if (PackFile::ReadMounted(path, scratch, packed)) return DecodeImage(packed.data(), packed.size(), image, error);
+
+        int width = 0, height = 0, channels = 0;
+        stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        return TakePixels(pixels, width, height, image, error);
+    }
+
+    bool DecodeImage(const unsigned char* data, std::size_t size, Image& image, std::string* error) {
+        int width = 0, height = 0, channels = 0;
+        stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+        return TakePixels(pixels, width, height, image, error);
+    }
+
+    unsigned DefaultDecodeWorkers() {
+        const unsigned cores = std::thread::hardware_concurrency();
+        return std::clamp(cores > 1 ? cores - 1 : 1u, 1u, 4u);
+    }
+
+}
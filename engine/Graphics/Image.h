@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Image decoding (stb_image; PNG, JPEG, TGA, BMP), no GL involved, so it
+// runs on loader threads and in headless tools.
+
+namespace Framework {
+
+    // Decoded RGBA8 pixels, rows top to bottom.
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+    };
+
+    // Reads 'path' from a mounted PackFile if one holds it, else from disk.
+    bool LoadImage(const std::string& path, Image& image, std::string* error = nullptr);
+    bool DecodeImage(const unsigned char* data, std::size_t size, Image& image, std::string* error = nullptr);
+
+    // Loader threads to start when the caller asks for 0: one core stays
+    // with the main thread, 1 to 4 in all.
+    unsigned DefaultDecodeWorkers();
+
+}
@@ -0,0 +1,146 @@
+#include "Lz4.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Framework {
+
+    namespace {
+        constexpr std::size_t kMinMatch = 4;
+        constexpr std::size_t kLastLiterals = 5;    // a block always ends in at least 5 literals
+        constexpr std::size_t kMatchStartLimit = 12; // no match may start in the last 12 bytes
+        constexpr std::size_t kMaxOffset = 65535;
+        constexpr int kHashBits = 12;
+
+        std::uint32_t Read32(const unsigned char* p) {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        std::uint32_t Hash(std::uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - kHashBits);
+        }
+
+        // 15 in the token nibble, then 255s and a final remainder byte
+        unsigned char* WriteLength(unsigned char* op, std::size_t length) {
+            for (length -= 15; length >= 255; length -= 255) *op++ = 255;
+            *op++ = static_cast<unsigned char>(length);
+            return op;
+        }
+
+        unsigned char* WriteSequence(unsigned char* op, const unsigned char* literals, std::size_t literalCount,
+            std::size_t offset, std::size_t matchLength) {
+            unsigned char* token = op++;
+            *token = static_cast<unsigned char>((literalCount >= 15 ? 15 : literalCount) << 4);
+            if (literalCount >= 15) op = WriteLength(op, literalCount);
+            if (literalCount) std::memcpy(op, literals, literalCount);
+            op += literalCount;
+            if (matchLength == 0) return op;   // the closing literals-only sequence
+
+            *op++ = static_cast<unsigned char>(offset);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+            const std::size_t extra = matchLength - kMinMatch;
+            *token |= static_cast<unsigned char>(extra >= 15 ? 15 : extra);
+            if (extra >= 15) op = WriteLength(op, extra);
+            return op;
+        }
+
+        // Adds the bytes of a 4-bit length continuation, false if the input ends first
+        bool ReadLength(const unsigned char*& ip, const unsigned char* end, std::size_t& length) {
+            unsigned char b;
+            do {
+                if (ip >= end) return false;
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+            return true;
+        }
+    }
+
+    std::size_t Lz4CompressBound(std::size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    std::size_t Lz4Compress(const unsigned char* src, std::size_t size, unsigned char* dst) {
+        unsigned char* op = dst;
+        std::size_t anchor = 0;
+
+        if (size > kMatchStartLimit) {
+            // Last position seen for each 4-byte hash; stale entries are
+            // rejected by comparing the bytes
+            std::vector<std::uint32_t> table(std::size_t(1) << kHashBits, 0);
+            const std::size_t matchStartLimit = size - kMatchStartLimit;
+            const std::size_t matchEndLimit = size - kLastLiterals;
+
+            std::size_t ip = 1;
+            table[Hash(Read32(src))] = 0;
+            while (ip < matchStartLimit) {
+                const std::uint32_t sequence = Read32(src + ip);
+                const std::uint32_t h = Hash(sequence);
+                const std::size_t ref = table[h];
+                table[h] = static_cast<std::uint32_t>(ip);
+
+                if (ip - ref > kMaxOffset || Read32(src + ref) != sequence) {
+                    // Step faster through data that does not compress
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                std::size_t length = kMinMatch;
+                while (ip + length < matchEndLimit && src[ref + length] == src[ip + length]) ++length;
+
+                op = WriteSequence(op, src + anchor, ip - anchor, ip - ref, length);
+                ip += length;
+                anchor = ip;
+                if (ip - 2 < matchStartLimit) table[Hash(Read32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 2);
+            }
+        }
+
+        op = WriteSequence(op, src + anchor, size - anchor, 0, 0);
+        return static_cast<std::size_t>(op - dst);
+    }
+
+    long long Lz4Decompress(const unsigned char* src, std::size_t size, unsigned char* dst, std::size_t capacity) {
+        const unsigned char* ip = src;
+        const unsigned char* const end = src + size;
+        unsigned char* op = dst;
+        unsigned char* const outEnd = dst + capacity;
+
+        if (size == 0) return -1;
+        for (;;) {
+            const unsigned char token = *ip++;
+
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !ReadLength(ip, end, literals)) return -1;
+            if (literals > static_cast<std::size_t>(end - ip) || literals > static_cast<std::size_t>(outEnd - op)) return -1;
+            if (literals) std::memcpy(op, ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == end) break;   // the last sequence has no match
+
+            if (end - ip < 2) return -1;
+            const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(op - dst)) return -1;
+
+            std::size_t length = token & 15;
+            if (length == 15 && !ReadLength(ip, end, length)) return -1;
+            length += kMinMatch;
+            if (length > static_cast<std::size_t>(outEnd - op)) return -1;
+
+            const unsigned char* match = op - offset;
+            if (offset >= length) {
+                std::memcpy(op, match, length);
+                op += length;
+            }
+            else {
+                // Overlapping copy repeats the last 'offset' bytes
+                for (std::size_t i = 0; i < length; ++i) *op++ = match[i];
+            }
+            if (ip >= end) return -1;   // a block must end with literals
+        }
+        return static_cast<long long>(op - dst);
+    }
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+// LZ4 block compression (the raw block format, no frame header), small
+// enough to keep in-tree for the pack files. Output is byte compatible
+// with the reference liblz4 LZ4_compress_default / LZ4_decompress_safe,
+// so archives can be inspected with stock tools. The compressor is the
+// simple greedy single-hash variant: a little less ratio than liblz4,
+// same decode speed, and decoding is what runs at load time.
+
+namespace Framework {
+
+    // Worst-case compressed size of 'size' input bytes.
+    std::size_t Lz4CompressBound(std::size_t size);
+
+    // Compress into 'dst' (at least Lz4CompressBound(size) bytes). Returns
+    // the compressed size.
+    std::size_t Lz4Compress(const unsigned char* src, std::size_t size, unsigned char* dst);
+
+    // Decode a block into 'dst'. Returns the decoded size, or -1 if the
+    // block is malformed or does not fit in 'capacity'. Never reads or
+    // writes out of bounds, whatever the input.
+    long long Lz4Decompress(const unsigned char* src, std::size_t size, unsigned char* dst, std::size_t capacity);
+
+}
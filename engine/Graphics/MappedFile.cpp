@@ -0,0 +1,59 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Framework {
+
+    bool MappedFile::Open(const std::string& path) {
+        Close();
+
+#if defined(_WIN32)
+        HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (f == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(f, &fileSize) || fileSize.QuadPart == 0) { CloseHandle(f); return false; }
+        HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m) { CloseHandle(f); return false; }
+        void* base = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+        if (!base) { CloseHandle(m); CloseHandle(f); return false; }
+        file = f;
+        mapping = m;
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+        void* base = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   // the mapping keeps the file alive
+        if (base == MAP_FAILED) return false;
+        size = static_cast<std::size_t>(st.st_size);
+#endif
+        data = static_cast<const unsigned char*>(base);
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if (!data) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mapping));
+        CloseHandle(static_cast<HANDLE>(file));
+        file = mapping = nullptr;
+#else
+        ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are read on first touch,
+// so opening is cheap and a loader can hand pointers into the file
+// straight to the GPU upload without copying it into a buffer first.
+
+namespace Framework {
+
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // False if the file is missing, empty or cannot be mapped.
+        bool Open(const std::string& path);
+        void Close();
+
+        bool IsOpen() const { return data != nullptr; }
+        const unsigned char* GetData() const { return data; }
+        std::size_t GetSize() const { return size; }
+
+    private:
+        const unsigned char* data = nullptr;
+        std::size_t size = 0;
+#if defined(_WIN32)
+        void* file = nullptr;
+        void* mapping = nullptr;
+#endif
+    };
+
+}
@@ -1,62 +1,334 @@
 #include "Mesh.h"
+#include "GLState.h"
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
 
 namespace Framework {
 
-    Mesh::Mesh(const std::vector<float>& vertices, GLenum drawMode)
-        : VAO(0), VBO(0), vertices(vertices), drawMode(drawMode)
+    namespace {
+        // Dynamic meshes with copies drawn since the last FenceSubmittedDraws()
+        std::vector<const Mesh*> drawnDynamic;
+    }
+
+    std::size_t VertexStride(VertexFormat format) {
+        switch (format) {
+        case VertexFormat::Float2Rgba8: return 2 * sizeof(float) + 4;
+        case VertexFormat::Half2Rgba8:  return 2 * sizeof(std::uint16_t) + 4;
+        default:                        return 6 * sizeof(float);
+        }
+    }
+
+    Mesh::Mesh(const std::vector<float>& vertices, GLenum drawMode, MeshUsage usage, VertexFormat format)
+        : Mesh(vertices.data(), vertices.size() / 6, drawMode, usage, format)
     {
-        // Now each vertex is 6 floats (3 position + 3 color)
-        vertexCount = static_cast<unsigned int>(vertices.size() / 6);
+    }
+
+    Mesh::Mesh(const float* source, std::size_t count, GLenum drawMode, MeshUsage usage, VertexFormat format)
+        : VAO(0), VBO(0), drawMode(drawMode), usage(usage),
+          format(format), stride(VertexStride(format))
+    {
+        // The source is always 6 floats per vertex (3 position + 3 color)
+        vertexCount = source ? static_cast<unsigned int>(count) : 0;
+        const GLsizeiptr bytes = vertexCount * stride;
+        if (usage != MeshUsage::StaticNoShadow) {
+            vertices.assign(source, source + vertexCount * 6);
+        }
+
+        // Packed copy of the vertices in the GPU format
+        const void* initial = source;
+        if (format != VertexFormat::Float3Color3) {
+            packScratch.resize(bytes);
+            Pack(source, vertexCount, packScratch.data());
+            initial = packScratch.data();
+        }
 
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
 
         Bind();
 
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
-            vertices.data(), GL_STATIC_DRAW);
+        if (usage == MeshUsage::Dynamic && GLEW_ARB_buffer_storage && bytes > 0) {
+            // One persistent, coherent mapping for the mesh's lifetime
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, bytes * kRegions, nullptr, flags);
+            mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes * kRegions, flags));
+            for (int r = 0; mapped && r < kRegions; ++r) {
+                std::memcpy(mapped + r * bytes, initial, bytes);
+            }
+            if (!mapped) {
+                // Immutable storage cannot be orphaned, which the unmapped
+                // path in UpdateRange() relies on: start over with a
+                // glBufferData buffer
+                GLState::DeleteBuffer(VBO);
+                glGenBuffers(1, &VBO);
+                Bind();
+                glBufferData(GL_ARRAY_BUFFER, bytes, initial, GL_STREAM_DRAW);
+            }
+        }
+        else if (usage == MeshUsage::StaticNoShadow && GLEW_ARB_buffer_storage) {
+            glBufferStorage(GL_ARRAY_BUFFER, bytes, initial, GL_DYNAMIC_STORAGE_BIT);
+        }
+        else {
+            glBufferData(GL_ARRAY_BUFFER, bytes, initial,
+                usage == MeshUsage::Dynamic ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+        }
 
-        // Position attribute (location = 0)
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+        SetupAttributes();
+
+        Unbind();
+
+        packScratch.clear();
+        packScratch.shrink_to_fit();
+    }
 
-        // Color attribute (location = 1)
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    void Mesh::SetupAttributes() const {
+        // Position (location = 0) and color (location = 1). Shaders declare
+        // vec3 for both: a missing z reads as 0 and alpha is ignored.
+        const GLsizei s = static_cast<GLsizei>(stride);
+        switch (format) {
+        case VertexFormat::Float2Rgba8:
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, (void*)0);
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, s, (void*)(2 * sizeof(float)));
+            break;
+        case VertexFormat::Half2Rgba8:
+            glVertexAttribPointer(0, 2, GL_HALF_FLOAT, GL_FALSE, s, (void*)0);
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, s, (void*)(2 * sizeof(std::uint16_t)));
+            break;
+        default:
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, s, (void*)0);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, s, (void*)(3 * sizeof(float)));
+            break;
+        }
+        glEnableVertexAttribArray(0);
         glEnableVertexAttribArray(1);
+    }
 
-        Unbind();
+    void Mesh::Pack(const float* src, std::size_t count, unsigned char* dst) const {
+        if (format == VertexFormat::Float3Color3) {
+            std::memcpy(dst, src, count * stride);
+            return;
+        }
+
+        auto unorm8 = [](float c) {
+            return static_cast<unsigned char>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+        for (std::size_t i = 0; i < count; ++i, src += 6, dst += stride) {
+            std::size_t colorOffset;
+            if (format == VertexFormat::Half2Rgba8) {
+                const std::uint16_t xy[2] = { glm::packHalf1x16(src[0]), glm::packHalf1x16(src[1]) };
+                std::memcpy(dst, xy, sizeof(xy));
+                colorOffset = sizeof(xy);
+            }
+            else {
+                std::memcpy(dst, src, 2 * sizeof(float));
+                colorOffset = 2 * sizeof(float);
+            }
+            const unsigned char rgba[4] = { unorm8(src[3]), unorm8(src[4]), unorm8(src[5]), 255 };
+            std::memcpy(dst + colorOffset, rgba, sizeof(rgba));
+        }
+    }
+
+    void Mesh::SetIndices(const std::uint32_t* newIndices, std::size_t count) {
+        if (EBO || !newIndices || count == 0) return;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (newIndices[i] >= vertexCount) {
+                std::cerr << "Mesh::SetIndices: index out of range\n";
+                return;
+            }
+        }
+        indexCount = static_cast<unsigned int>(count);
+        if (usage != MeshUsage::StaticNoShadow) {
+            indices.assign(newIndices, newIndices + count);
+        }
+
+        glGenBuffers(1, &EBO);
+        GLState::BindVertexArray(VAO);   // the element buffer binding is VAO state
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        if (vertexCount <= 0x10000) {
+            std::vector<std::uint16_t> narrow(newIndices, newIndices + count);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, narrow.size() * sizeof(std::uint16_t), narrow.data(), GL_STATIC_DRAW);
+            indexType = GL_UNSIGNED_SHORT;
+        }
+        else {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(std::uint32_t), newIndices, GL_STATIC_DRAW);
+            indexType = GL_UNSIGNED_INT;
+        }
     }
 
     Mesh::~Mesh() {
-        glDeleteVertexArrays(1, &VAO);
-        glDeleteBuffers(1, &VBO);
+        if (unfenced) drawnDynamic.erase(std::find(drawnDynamic.begin(), drawnDynamic.end(), this));
+        for (GLsync fence : fences) {
+            if (fence) glDeleteSync(fence);
+        }
+        GLState::DeleteVertexArray(VAO);
+        GLState::DeleteBuffer(VBO);   // also unmaps a persistent mapping
+        if (EBO) GLState::DeleteBuffer(EBO);
+        if (instanceVBO) GLState::DeleteBuffer(instanceVBO);
+    }
+
+    unsigned int Mesh::GetDrawFirstVertex() const {
+        if (!mapped) return 0;
+        regionInUse = true;
+        if (!unfenced) drawnDynamic.push_back(this);
+        unfenced |= 1u << region;
+        return static_cast<unsigned int>(region) * vertexCount;
+    }
+
+    void Mesh::FenceSubmittedDraws() {
+        for (const Mesh* mesh : drawnDynamic) {
+            for (int r = 0; r < kRegions; ++r) {
+                if (!(mesh->unfenced & (1u << r))) continue;
+                // The new fence follows every draw of this copy, old or new
+                if (mesh->fences[r]) glDeleteSync(mesh->fences[r]);
+                mesh->fences[r] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+            mesh->unfenced = 0;
+        }
+        drawnDynamic.clear();
     }
 
     void Mesh::Draw() const {
-        Bind();
-        glDrawArrays(drawMode, 0, vertexCount);  // Use specified mode
-        Unbind();
+        // The VAO is all a draw needs; it stays bound so drawing the same
+        // mesh again costs no bind at all
+        GLState::BindVertexArray(VAO);
+        if (indexType) {
+            glDrawElementsBaseVertex(drawMode, GetIndexCount(), indexType, nullptr, GetDrawFirstVertex());
+            return;
+        }
+        glDrawArrays(drawMode, GetDrawFirstVertex(), vertexCount);  // Use specified mode
+    }
+
+    void Mesh::SetInstances(const MeshInstance* instances, std::size_t count) {
+        instanceCount = instances ? count : 0;
+        if (instanceCount == 0) return;
+
+        if (!instanceVBO) {
+            glGenBuffers(1, &instanceVBO);
+            GLState::BindVertexArray(VAO);
+            GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+            // Instance attributes (locations 2-5), advanced once per instance
+            const GLsizei stride = sizeof(MeshInstance);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshInstance, x));
+            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshInstance, scaleX));
+            glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshInstance, rotation));
+            glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshInstance, r));
+            for (GLuint loc = 2; loc <= 5; ++loc) {
+                glEnableVertexAttribArray(loc);
+                glVertexAttribDivisor(loc, 1);
+            }
+        }
+        else {
+            GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        }
+
+        // Re-specify the store every upload (orphaning) so the driver never
+        // stalls on instances the GPU is still reading from the last frame
+        if (instanceCount > instanceCapacity) {
+            instanceCapacity = instanceCapacity ? instanceCapacity : 64;
+            while (instanceCapacity < instanceCount) instanceCapacity *= 2;
+        }
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(MeshInstance), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instanceCount * sizeof(MeshInstance), instances);
+    }
+
+    void Mesh::DrawInstanced() const {
+        if (instanceCount == 0) return;
+        GLState::BindVertexArray(VAO);
+        if (indexType) {
+            glDrawElementsInstancedBaseVertex(drawMode, GetIndexCount(), indexType, nullptr,
+                static_cast<GLsizei>(instanceCount), GetDrawFirstVertex());
+            return;
+        }
+        glDrawArraysInstanced(drawMode, GetDrawFirstVertex(), vertexCount, static_cast<GLsizei>(instanceCount));
     }
 
     void Mesh::UpdateVertices(const std::vector<float>& newVertices) {
-        if (newVertices.size() != vertices.size()) {
+        if (newVertices.size() != static_cast<std::size_t>(vertexCount) * 6) {
             std::cerr << "Mesh::UpdateVertices: size mismatch\n";
             return;
         }
+        UpdateRange(0, newVertices.data(), vertexCount);
+    }
 
-        vertices = newVertices;
-        Bind();
-        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-        Unbind();
+    void Mesh::UpdateRange(unsigned int firstVertex, const float* data, unsigned int count) {
+        if (!data || count == 0) return;
+        if (firstVertex + count > vertexCount) {
+            std::cerr << "Mesh::UpdateRange: range out of bounds\n";
+            return;
+        }
+
+        if (!vertices.empty()) {
+            std::memcpy(vertices.data() + static_cast<std::size_t>(firstVertex) * 6, data, count * 6 * sizeof(float));
+        }
+
+        if (mapped) {
+            if (regionInUse) AdvanceRegion();
+
+            // Every copy now lags the CPU copy on this range; bring the one
+            // being written up to date (this update plus any it missed while
+            // the GPU was reading it)
+            const std::size_t last = static_cast<std::size_t>(firstVertex) + count;
+            for (int r = 0; r < kRegions; ++r) {
+                if (staleEnd[r] == staleBegin[r]) {
+                    staleBegin[r] = firstVertex;
+                    staleEnd[r] = last;
+                }
+                else {
+                    staleBegin[r] = std::min<std::size_t>(staleBegin[r], firstVertex);
+                    staleEnd[r] = std::max(staleEnd[r], last);
+                }
+            }
+            unsigned char* dst = mapped + static_cast<std::size_t>(region) * vertexCount * stride;
+            Pack(vertices.data() + staleBegin[region] * 6, staleEnd[region] - staleBegin[region],
+                dst + staleBegin[region] * stride);
+            staleBegin[region] = staleEnd[region] = 0;
+            return;
+        }
+
+        GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
+        if (usage == MeshUsage::Dynamic) {
+            // No persistent mapping: orphan so the draws in flight keep the
+            // old storage, then upload everything
+            firstVertex = 0;
+            count = vertexCount;
+            data = vertices.data();
+            glBufferData(GL_ARRAY_BUFFER, vertexCount * stride, nullptr, GL_STREAM_DRAW);
+        }
+        const void* upload = data;
+        if (format != VertexFormat::Float3Color3) {
+            packScratch.resize(count * stride);
+            Pack(data, count, packScratch.data());
+            upload = packScratch.data();
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, firstVertex * stride, count * stride, upload);
+    }
+
+    void Mesh::AdvanceRegion() {
+        // The current copy keeps its draws; FenceSubmittedDraws() fences it
+        // once they have been issued
+        region = (region + 1) % kRegions;
+        regionInUse = false;
+
+        // With three copies the GPU is normally long done with this one.
+        // (Only more than two updates between recording a draw and
+        // FenceSubmittedDraws() reach a copy whose draw is still unissued;
+        // that draw then shows the newer vertices.)
+        if (fences[region]) {
+            if (GLState::WaitAndDeleteFence(fences[region])) ++fenceWaits;
+            fences[region] = nullptr;
+        }
     }
 
     void Mesh::Bind() const {
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        GLState::BindVertexArray(VAO);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
     }
 
     void Mesh::Unbind() const {
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GLState::BindVertexArray(0);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
     }
 }
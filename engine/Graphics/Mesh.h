@@ -5,23 +5,137 @@
 
 namespace Framework {
 
+    // Per-instance data for DrawInstanced(): 2D transform (offset, scale,
+    // rotation in radians) and a color multiplied with the vertex color.
+    // Read by shaders/instanced.vert at locations 2..5.
+    struct MeshInstance {
+        float x = 0.0f, y = 0.0f;
+        float scaleX = 1.0f, scaleY = 1.0f;
+        float rotation = 0.0f;
+        float r = 1.0f, g = 1.0f, b = 1.0f;
+    };
+
+    // How a mesh's vertices are stored and updated.
+    //   Static          GL_STATIC_DRAW buffer plus a CPU copy (GetVertices()).
+    //   StaticNoShadow  Immutable buffer, no CPU copy; GetVertices() is empty.
+    //                   For geometry that is only drawn.
+    //   Dynamic         Three copies of the vertices in one persistently mapped
+    //                   buffer. Each update writes the copy the GPU is not
+    //                   reading (guarded by a fence), so updating never waits
+    //                   on draws still in flight. For trails, debug lines, ...
+    //                   Needs Mesh::FenceSubmittedDraws() once per frame.
+    enum class MeshUsage {
+        Static,
+        StaticNoShadow,
+        Dynamic,
+    };
+
+    // GPU layout of a mesh's vertices. Meshes are always built and updated
+    // from 6 floats per vertex (position xyz + color rgb); the 2D formats drop
+    // z (the shaders read it back as 0) and pack the color into RGBA8.
+    //   Float3Color3  24 bytes
+    //   Float2Rgba8   12 bytes
+    //   Half2Rgba8     8 bytes, half-float positions (about 3 decimal digits)
+    enum class VertexFormat : std::uint8_t {
+        Float3Color3,
+        Float2Rgba8,
+        Half2Rgba8,
+    };
+
+    std::size_t VertexStride(VertexFormat format);
+
     class Mesh {
     public:
-        Mesh(const std::vector<float>& vertices, GLenum drawMode = GL_TRIANGLES);
+        Mesh(const std::vector<float>& vertices, GLenum drawMode = GL_TRIANGLES, MeshUsage usage = MeshUsage::Static,
+            VertexFormat format = VertexFormat::Float3Color3);
+        // From 'vertexCount' * 6 floats anywhere in memory (e.g. a mapped file);
+        // StaticNoShadow uploads them without any intermediate copy.
+        Mesh(const float* vertices, std::size_t vertexCount, GLenum drawMode = GL_TRIANGLES,
+            MeshUsage usage = MeshUsage::Static, VertexFormat format = VertexFormat::Float3Color3);
         ~Mesh();
 
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+
         void Draw() const;
+
+        // Upload per-instance data, then draw every instance with one call.
+        void SetInstances(const MeshInstance* instances, std::size_t count);
+        void SetInstances(const std::vector<MeshInstance>& instances) { SetInstances(instances.data(), instances.size()); }
+        void DrawInstanced() const;
+        std::size_t GetInstanceCount() const { return instanceCount; }
+
+        // Replace all vertices (same count) or 'count' vertices starting at
+        // 'firstVertex' (6 floats each). Only the given range is uploaded.
         void UpdateVertices(const std::vector<float>& newVertices);
+        void UpdateRange(unsigned int firstVertex, const float* data, unsigned int count);
+
+        // Draw through an index buffer (16-bit when the vertices allow it).
+        // Indices are fixed once set; vertex updates keep working.
+        void SetIndices(const std::uint32_t* indices, std::size_t count);
+        void SetIndices(const std::vector<std::uint32_t>& indices) { SetIndices(indices.data(), indices.size()); }
         void Bind() const;
         void Unbind() const;
 
         unsigned int GetVertexCount() const { return vertexCount; }
+        const std::vector<float>& GetVertices() const { return vertices; }
+        GLenum GetDrawMode() const { return drawMode; }
+        VertexFormat GetFormat() const { return format; }
+        const std::vector<std::uint32_t>& GetIndices() const { return indices; }   // empty for StaticNoShadow
+        unsigned int GetIndexCount() const { return indexCount; }
+        GLenum GetIndexType() const { return indexType; }   // 0 when not indexed
+        GLuint GetVAO() const { return VAO; }
+        MeshUsage GetUsage() const { return usage; }
+
+        // First vertex to draw from. Dynamic meshes draw from the copy last
+        // written; calling this marks that copy as in use by the GPU, so the
+        // next update moves to another one. 0 for static meshes.
+        unsigned int GetDrawFirstVertex() const;
+
+        // Fence every Dynamic copy handed out by GetDrawFirstVertex() since
+        // the last call. Call once the draws using them have been issued
+        // (after RenderCommandBuffer::Execute), not when they are recorded:
+        // a fence placed earlier could signal before the draw has read the
+        // copy. A copy is not written again until its fence has passed.
+        static void FenceSubmittedDraws();
+
+        // Updates that had to wait for the GPU to release a copy (should stay 0).
+        std::size_t GetFenceWaits() const { return fenceWaits; }
 
     private:
         GLuint VAO, VBO;
         std::vector<float> vertices;
         unsigned int vertexCount;
         GLenum drawMode;
+        MeshUsage usage;
+        VertexFormat format;
+        std::size_t stride;
+
+        void SetupAttributes() const;
+        void Pack(const float* src, std::size_t count, unsigned char* dst) const;
+
+        GLuint EBO = 0;
+        std::vector<std::uint32_t> indices;       // CPU copy, like 'vertices'
+        unsigned int indexCount = 0;
+        GLenum indexType = 0;
+        std::vector<unsigned char> packScratch;   // packed upload staging
+
+        // Dynamic streaming state
+        static constexpr int kRegions = 3;
+        void AdvanceRegion();
+        unsigned char* mapped = nullptr;        // persistent mapping of all regions
+        int region = 0;                         // copy written by updates / read by draws
+        mutable bool regionInUse = false;       // drawn since the last update
+        mutable unsigned unfenced = 0;          // bit per copy drawn since the last FenceSubmittedDraws()
+        mutable GLsync fences[kRegions] = {};
+        std::size_t staleBegin[kRegions] = {};  // vertex range each copy is behind the CPU copy
+        std::size_t staleEnd[kRegions] = {};
+        std::size_t fenceWaits = 0;
+
+        // Created on the first SetInstances(); grows by doubling
+        GLuint instanceVBO = 0;
+        std::size_t instanceCapacity = 0;
+        std::size_t instanceCount = 0;
     };
 
 }
\ No newline at end of file
@@ -1,72 +1,159 @@
 #include "MeshFactory.h"
+#include "ObjLoader.h"
+#include <chrono>
+#include <unordered_map>
 
 namespace Framework {
 
-    Mesh* CreateTriangle() {
+    namespace {
+        // Unit circle vertices per segment count: center plus segments + 1
+        // rim points, 6 floats each. The trig runs once per segment count.
+        const std::vector<float>& UnitCircleVertices(int segments) {
+            static std::unordered_map<int, std::vector<float>> cache;
+
+            std::vector<float>& vertices = cache[segments];
+            if (!vertices.empty()) return vertices;
+
+            vertices.reserve((segments + 2) * 6);
+
+            // Center of the circle (white)
+            vertices.insert(vertices.end(), { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f });
+
+            // Circle edge points with rainbow gradient
+            for (int i = 0; i <= segments; ++i) {
+                float angle = glm::two_pi<float>() * static_cast<float>(i) / segments;
+
+                // Generate color based on angle (HSL to RGB approximation)
+                float r = (glm::cos(angle) + 1.0f) / 2.0f;
+                float g = (glm::cos(angle + glm::two_pi<float>() / 3.0f) + 1.0f) / 2.0f;
+                float b = (glm::cos(angle + 2.0f * glm::two_pi<float>() / 3.0f) + 1.0f) / 2.0f;
+
+                vertices.insert(vertices.end(), { glm::cos(angle), glm::sin(angle), 0.0f, r, g, b });
+            }
+            return vertices;
+        }
+
+        // Two vertices per segment (GL_LINES), 6 floats each
+        void WaveVertices(int segments, float time, std::vector<float>& vertices) {
+            vertices.clear();
+            vertices.reserve(segments * 12);
+            for (int i = 0; i < segments; ++i) {
+                for (int end = 0; end < 2; ++end) {
+                    const float t = static_cast<float>(i + end) / segments;
+                    const float y = 0.25f * glm::sin(2.0f * glm::two_pi<float>() * t - 3.0f * time);
+                    vertices.insert(vertices.end(), { t - 0.5f, y, 0.0f, t, 1.0f - t, 1.0f });
+                }
+            }
+        }
+
+        const std::vector<float> kQuadVertices = {
+             // Position           // Color
+            -0.5f,  0.5f, 0.0f,    1.0f, 0.0f, 0.0f,  // Top Left - Red
+             0.5f,  0.5f, 0.0f,    0.0f, 1.0f, 0.0f,  // Top Right - Green
+            -0.5f, -0.5f, 0.0f,    0.0f, 0.0f, 1.0f,  // Bottom Left - Blue
+             0.5f, -0.5f, 0.0f,    1.0f, 1.0f, 0.0f   // Bottom Right - Yellow
+        };
+        const std::vector<std::uint32_t> kQuadIndices = { 0, 1, 2,  1, 3, 2 };
+
+        Mesh* unitQuad = nullptr;
+        std::unordered_map<int, Mesh*> unitCircles;
+    }
+
+    Mesh* CreateTriangle(VertexFormat format) {
         std::vector<float> vertices = {
              // Position          // Color
              0.0f,  0.8f, 0.0f,   1.0f, 0.0f, 0.0f,  // red
             -0.8f, -0.8f, 0.0f,   0.0f, 1.0f, 0.0f,  // green
              0.8f, -0.8f, 0.0f,   0.0f, 0.0f, 1.0f   // blue
         };
-        return new Mesh(vertices, GL_TRIANGLES);
+        return new Mesh(vertices, GL_TRIANGLES, MeshUsage::Static, format);
     }
 
-    Mesh* CreateQuad() {
-        std::vector<float> vertices = {
-             // Position           // Color
-            -0.5f,  0.5f, 0.0f,    1.0f, 0.0f, 0.0f,  // Top Left - Red
-             0.5f,  0.5f, 0.0f,    0.0f, 1.0f, 0.0f,  // Top Right - Green
-            -0.5f, -0.5f, 0.0f,    0.0f, 0.0f, 1.0f,  // Bottom Left - Blue
-
-             0.5f,  0.5f, 0.0f,    0.0f, 1.0f, 0.0f,  // Top Right - Green
-             0.5f, -0.5f, 0.0f,    1.0f, 1.0f, 0.0f,  // Bottom Right - Yellow
-            -0.5f, -0.5f, 0.0f,    0.0f, 0.0f, 1.0f   // Bottom Left - Blue
-        };
-        return new Mesh(vertices, GL_TRIANGLES);
+    Mesh* CreateQuad(VertexFormat format) {
+        Mesh* mesh = new Mesh(kQuadVertices, GL_TRIANGLES, MeshUsage::Static, format);
+        mesh->SetIndices(kQuadIndices);
+        return mesh;
     }
 
-    Mesh* CreateLine() {
+    Mesh* CreateLine(VertexFormat format) {
         std::vector<float> vertices = {
             // Position         // Color
            -0.5f, 0.0f, 0.0f,   1.0f, 0.0f, 1.0f,  // Magenta
             0.5f, 0.0f, 0.0f,   0.0f, 1.0f, 1.0f   // Cyan
         };
-        return new Mesh(vertices, GL_LINES);
+        return new Mesh(vertices, GL_LINES, MeshUsage::Static, format);
     }
 
-    Mesh* CreateCircle(int segments, float radius) {
+    Mesh* CreateCircle(int segments, float radius, VertexFormat format) {
+        std::vector<float> vertices = UnitCircleVertices(segments);
+        for (std::size_t i = 0; i < vertices.size(); i += 6) {
+            vertices[i] *= radius;
+            vertices[i + 1] *= radius;
+        }
+        return new Mesh(vertices, GL_TRIANGLE_FAN, MeshUsage::Static, format);
+    }
+
+    Mesh* CreateWave(int segments, VertexFormat format) {
         std::vector<float> vertices;
+        WaveVertices(segments, 0.0f, vertices);
+        return new Mesh(vertices, GL_LINES, MeshUsage::Dynamic, format);
+    }
+
+    void UpdateWave(Mesh& wave, float time) {
+        static std::vector<float> vertices;   // reused every frame
+        WaveVertices(static_cast<int>(wave.GetVertexCount() / 2), time, vertices);
+        wave.UpdateVertices(vertices);
+    }
+
+    Mesh* LoadObjMesh(const std::string& path, MeshUsage usage) {
+        const auto start = std::chrono::steady_clock::now();
 
-        // Center of the circle (white)
-        vertices.push_back(0.0f); // x
-        vertices.push_back(0.0f); // y
-        vertices.push_back(0.0f); // z
-        vertices.push_back(1.0f); // r
-        vertices.push_back(1.0f); // g
-        vertices.push_back(1.0f); // b
-
-
-        // Circle edge points with rainbow gradient
-        for (int i = 0; i <= segments; ++i) {
-            float angle = glm::two_pi<float>() * static_cast<float>(i) / segments;
-            float x = radius * glm::cos(angle);
-            float y = radius * glm::sin(angle);
-
-            // Generate color based on angle (HSL to RGB approximation)
-            float r = (glm::cos(angle) + 1.0f) / 2.0f;
-            float g = (glm::cos(angle + glm::two_pi<float>() / 3.0f) + 1.0f) / 2.0f;
-            float b = (glm::cos(angle + 2.0f * glm::two_pi<float>() / 3.0f) + 1.0f) / 2.0f;
-
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(0.0f);
-            vertices.push_back(r);
-            vertices.push_back(g);
-            vertices.push_back(b);
+        ObjMesh obj;
+        std::string error;
+        if (!ObjLoader::Load(path, obj, &error)) {
+            std::cerr << "LoadObjMesh: " << error << "\n";
+            return nullptr;
         }
+        Mesh* mesh = new Mesh(obj.vertices, obj.vertexCount, GL_TRIANGLES, usage, VertexFormat::Float3Color3);
+        mesh->SetIndices(obj.indices, obj.indexCount);
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "LoadObjMesh: " << path << " (" << obj.vertexCount << " vertices, " << obj.indexCount / 3
+                  << " triangles) " << (obj.fromCache ? "from cache" : "parsed") << " in " << ms << " ms\n";
+        return mesh;
+    }
+
+    Mesh* GetUnitQuad() {
+        if (!unitQuad) {
+            unitQuad = new Mesh(kQuadVertices, GL_TRIANGLES, MeshUsage::Static, VertexFormat::Float2Rgba8);
+            unitQuad->SetIndices(kQuadIndices);
+        }
+        return unitQuad;
+    }
+
+    Mesh* GetUnitCircle(int segments) {
+        Mesh*& mesh = unitCircles[segments];
+        if (!mesh) {
+            mesh = new Mesh(UnitCircleVertices(segments), GL_TRIANGLE_FAN, MeshUsage::Static,
+                VertexFormat::Float2Rgba8);
+        }
+        return mesh;
+    }
+
+    bool IsSharedMesh(const Mesh* mesh) {
+        if (!mesh) return false;
+        if (mesh == unitQuad) return true;
+        for (const auto& entry : unitCircles) {
+            if (entry.second == mesh) return true;
+        }
+        return false;
+    }
 
-        return new Mesh(vertices, GL_TRIANGLE_FAN);
+    void ReleaseSharedMeshes() {
+        delete unitQuad;
+        unitQuad = nullptr;
+        for (auto& entry : unitCircles) delete entry.second;
+        unitCircles.clear();
     }
 
 }
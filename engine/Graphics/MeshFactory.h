@@ -5,8 +5,29 @@
 
 namespace Framework {
 
-    Mesh* CreateTriangle();
-    Mesh* CreateQuad();
-    Mesh* CreateLine();
-    Mesh* CreateCircle(int segments, float radius);
+    // Every shape is flat, so the default layout is the compact 2D one
+    // (12 bytes per vertex instead of 24). The caller owns the result.
+    Mesh* CreateTriangle(VertexFormat format = VertexFormat::Float2Rgba8);
+    Mesh* CreateQuad(VertexFormat format = VertexFormat::Float2Rgba8);     // 4 vertices, indexed
+    Mesh* CreateLine(VertexFormat format = VertexFormat::Float2Rgba8);
+    Mesh* CreateCircle(int segments, float radius, VertexFormat format = VertexFormat::Float2Rgba8);
+
+    // Sine wave across [-0.5, 0.5] drawn as 'segments' lines. The mesh is
+    // MeshUsage::Dynamic; UpdateWave() moves it along once per frame.
+    Mesh* CreateWave(int segments, VertexFormat format = VertexFormat::Float2Rgba8);
+    void UpdateWave(Mesh& wave, float time);
+
+    // Indexed mesh from an OBJ file (see ObjLoader), nullptr on failure.
+    // A warm cache goes from the mapped cache file straight to the GPU.
+    Mesh* LoadObjMesh(const std::string& path, MeshUsage usage = MeshUsage::StaticNoShadow);
+
+    // Shared unit geometry (quad of side 1, circle of radius 1), built once
+    // per shape and owned by the factory. Size and place it with a transform
+    // (e.g. MeshInstance) instead of creating a buffer per object. They keep
+    // a CPU copy, so SpriteBatch can merge them too. Do not delete;
+    // ReleaseSharedMeshes() frees them before the GL context goes.
+    Mesh* GetUnitQuad();
+    Mesh* GetUnitCircle(int segments);
+    bool IsSharedMesh(const Mesh* mesh);   // one of the above
+    void ReleaseSharedMeshes();
 }
@@ -1 +1,300 @@
-#include "Graphics/ObjLoader.h"
\ No newline at end of file
+#include "Graphics/ObjLoader.h"
+#include "Graphics/PackFile.h"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace Framework {
+
+    namespace {
+        std::string cacheDirectory = "mesh_cache";
+        bool cacheEnabled = true;
+
+        constexpr char kCacheMagic[4] = { 'O', 'B', 'J', 'B' };
+        constexpr std::uint32_t kCacheVersion = 1;
+
+        // Followed by vertexCount * 6 floats, then indexCount uint32 indices
+        struct CacheHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint64_t sourceSize;
+            std::int64_t sourceTime;
+            std::uint32_t vertexCount;
+            std::uint32_t indexCount;
+        };
+        static_assert(sizeof(CacheHeader) == 32, "cache header layout");
+
+        // ----- parsing helpers; 'p' always stays within [p, end] -----
+
+        void SkipSpaces(const char*& p, const char* end) {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        }
+
+        void SkipLine(const char*& p, const char* end) {
+            const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+            p = nl ? static_cast<const char*>(nl) + 1 : end;
+        }
+
+        bool AtLineEnd(const char* p, const char* end) {
+            return p >= end || *p == '\n' || *p == '#';
+        }
+
+        bool ParseFloat(const char*& p, const char* end, float& value) {
+            SkipSpaces(p, end);
+            if (p < end && *p == '+') ++p;
+            const auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+
+        bool ParseIndex(const char*& p, const char* end, long& value) {
+            const auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+
+        // 1-based or negative (relative) OBJ index to 0-based, -1 if invalid
+        long Resolve(long index, std::size_t count) {
+            if (index > 0) return (static_cast<std::size_t>(index) <= count) ? index - 1 : -1;
+            if (index < 0) return (static_cast<std::size_t>(-index) <= count) ? static_cast<long>(count) + index : -1;
+            return -1;
+        }
+
+        bool SourceStamp(const std::string& path, std::uint64_t& size, std::int64_t& time) {
+            std::error_code ec;
+            size = static_cast<std::uint64_t>(fs::file_size(path, ec));
+            if (ec) return false;
+            time = static_cast<std::int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+            return !ec;
+        }
+
+        bool ReadCache(const std::string& cachePath, std::uint64_t sourceSize, std::int64_t sourceTime, ObjMesh& out) {
+            if (!out.cache.Open(cachePath)) return false;
+
+            CacheHeader header;
+            if (out.cache.GetSize() < sizeof(header)) return false;
+            std::memcpy(&header, out.cache.GetData(), sizeof(header));
+            const std::size_t expected = sizeof(header) + static_cast<std::size_t>(header.vertexCount) * 6 * sizeof(float)
+                + static_cast<std::size_t>(header.indexCount) * sizeof(std::uint32_t);
+            if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion
+                || header.sourceSize != sourceSize || header.sourceTime != sourceTime
+                || out.cache.GetSize() != expected) {
+                out.cache.Close();
+                return false;
+            }
+
+            // The header is 32 bytes and the mapping page aligned, so both
+            // arrays are suitably aligned in place
+            const unsigned char* body = out.cache.GetData() + sizeof(header);
+            out.vertices = reinterpret_cast<const float*>(body);
+            out.vertexCount = header.vertexCount;
+            out.indices = reinterpret_cast<const std::uint32_t*>(body + header.vertexCount * 6 * sizeof(float));
+            out.indexCount = header.indexCount;
+            out.fromCache = true;
+            return true;
+        }
+
+        void WriteCache(const std::string& cachePath, std::uint64_t sourceSize, std::int64_t sourceTime,
+            const ObjMeshData& data) {
+            std::error_code ec;
+            fs::create_directories(fs::path(cachePath).parent_path(), ec);
+
+            CacheHeader header{};
+            std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+            header.version = kCacheVersion;
+            header.sourceSize = sourceSize;
+            header.sourceTime = sourceTime;
+            header.vertexCount = static_cast<std::uint32_t>(data.vertices.size() / 6);
+            header.indexCount = static_cast<std::uint32_t>(data.indices.size());
+
+            // Write next to the final name and rename, so a crash mid-write
+            // never leaves a truncated cache behind
+            const std::string tmp = cachePath + ".tmp";
+            std::FILE* file = std::fopen(tmp.c_str(), "wb");
+            if (!file) return;
+            bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+            ok = ok && std::fwrite(data.vertices.data(), sizeof(float), data.vertices.size(), file) == data.vertices.size();
+            ok = ok && std::fwrite(data.indices.data(), sizeof(std::uint32_t), data.indices.size(), file) == data.indices.size();
+            ok = (std::fclose(file) == 0) && ok;
+            if (ok) fs::rename(tmp, cachePath, ec);
+            if (!ok || ec) fs::remove(tmp, ec);
+        }
+    }
+
+    void ObjLoader::SetCacheDirectory(const std::string& directory) {
+        cacheDirectory = directory;
+    }
+
+    void ObjLoader::SetCacheEnabled(bool enabled) {
+        cacheEnabled = enabled;
+    }
+
+    std::string ObjLoader::CachePath(const std::string& path) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(PackFile::Hash(path.data(), path.size())));
+        return (fs::path(cacheDirectory) / name).string();
+    }
+
+    bool ObjLoader::Parse(const char* text, std::size_t size, ObjMeshData& out, std::string* error) {
+        std::vector<float> positions, colors, normals;
+        bool hasColors = false;
+
+        // (position, normal + 1) -> output vertex
+        std::unordered_map<std::uint64_t, std::uint32_t> unique;
+        std::vector<std::uint32_t> corners;
+
+        out.vertices.clear();
+        out.indices.clear();
+
+        // Rough upper bounds from the file size avoid most regrowth
+        positions.reserve(size / 32 * 3);
+        unique.reserve(size / 32);
+
+        auto fail = [&](std::size_t line, const char* what) {
+            if (error) *error = "line " + std::to_string(line) + ": " + what;
+            return false;
+        };
+
+        const char* p = text;
+        const char* end = text + size;
+        for (std::size_t line = 1; p < end; ++line) {
+            SkipSpaces(p, end);
+            if (AtLineEnd(p, end)) {
+                SkipLine(p, end);
+                continue;
+            }
+
+            if (p + 1 < end && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+                p += 2;
+                float v[6];
+                int n = 0;
+                while (n < 6 && !AtLineEnd(p, end)) {
+                    if (!ParseFloat(p, end, v[n])) return fail(line, "bad number in v");
+                    ++n;
+                    SkipSpaces(p, end);
+                }
+                if (n < 3) return fail(line, "v needs 3 coordinates");
+                positions.insert(positions.end(), v, v + 3);
+                if (n == 6) {
+                    colors.insert(colors.end(), v + 3, v + 6);
+                    hasColors = true;
+                }
+                else {
+                    colors.insert(colors.end(), { 1.0f, 1.0f, 1.0f });
+                }
+            }
+            else if (p + 2 < end && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+                p += 3;
+                float n[3];
+                for (float& c : n) {
+                    if (!ParseFloat(p, end, c)) return fail(line, "bad number in vn");
+                }
+                normals.insert(normals.end(), n, n + 3);
+            }
+            else if (p + 1 < end && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+                p += 2;
+                corners.clear();
+                const std::size_t positionCount = positions.size() / 3;
+                const std::size_t normalCount = normals.size() / 3;
+                for (SkipSpaces(p, end); !AtLineEnd(p, end); SkipSpaces(p, end)) {
+                    long vi = 0, ti = 0, ni = 0;
+                    if (!ParseIndex(p, end, vi)) return fail(line, "bad index in f");
+                    if (p < end && *p == '/') {
+                        ++p;
+                        if (p < end && *p != '/' && !ParseIndex(p, end, ti)) return fail(line, "bad texture index in f");
+                        if (p < end && *p == '/') {
+                            ++p;
+                            if (!ParseIndex(p, end, ni)) return fail(line, "bad normal index in f");
+                        }
+                    }
+
+                    const long v = Resolve(vi, positionCount);
+                    const long n = ni ? Resolve(ni, normalCount) : -1;
+                    if (v < 0 || (ni && n < 0)) return fail(line, "index out of range");
+
+                    const std::uint64_t key = (static_cast<std::uint64_t>(v) << 32) | static_cast<std::uint32_t>(n + 1);
+                    auto [it, added] = unique.try_emplace(key, static_cast<std::uint32_t>(out.vertices.size() / 6));
+                    if (added) {
+                        const float* pos = &positions[v * 3];
+                        float color[3] = { 1.0f, 1.0f, 1.0f };
+                        if (hasColors) {
+                            std::memcpy(color, &colors[v * 3], sizeof(color));
+                        }
+                        else if (n >= 0) {
+                            for (int c = 0; c < 3; ++c) color[c] = normals[n * 3 + c] * 0.5f + 0.5f;
+                        }
+                        out.vertices.insert(out.vertices.end(), { pos[0], pos[1], pos[2], color[0], color[1], color[2] });
+                    }
+                    corners.push_back(it->second);
+                }
+                if (corners.size() < 3) return fail(line, "face needs 3 vertices");
+                for (std::size_t i = 2; i < corners.size(); ++i) {
+                    out.indices.insert(out.indices.end(), { corners[0], corners[i - 1], corners[i] });
+                }
+            }
+            SkipLine(p, end);
+        }
+
+        if (out.indices.empty()) {
+            if (error) *error = "no faces";
+            return false;
+        }
+        return true;
+    }
+
+    bool ObjLoader::Load(const std::string& path, ObjMesh& out, std::string* error) {
+        // A packed file has no modification time; its content hash stamps the cache instead
+        const PackEntry* entry = nullptr;
+        const PackFile* pack = PackFile::FindMounted(path, &entry);
+
+        std::uint64_t sourceSize = 0;
+        std::int64_t sourceTime = 0;
+        if (pack) {
+            sourceSize = entry->size;
+            sourceTime = static_cast<std::int64_t>(entry->contentHash);
+        }
+        else if (!SourceStamp(path, sourceSize, sourceTime)) {
+            if (error) *error = "cannot open " + path;
+            return false;
+        }
+
+        const std::string cachePath = CachePath(path);
+        if (cacheEnabled && ReadCache(cachePath, sourceSize, sourceTime, out)) return true;
+
+        MappedFile source;
+        std::vector<unsigned char> scratch;
+        std::span<const unsigned char> text;
+        if (pack) {
+            if (!pack->Read(*entry, scratch, text)) {
+                if (error) *error = "corrupt pack entry " + path;
+                return false;
+            }
+        }
+        else {
+            if (!source.Open(path)) {
+                if (error) *error = "cannot open " + path;
+                return false;
+            }
+            text = { source.GetData(), source.GetSize() };
+        }
+        if (!Parse(reinterpret_cast<const char*>(text.data()), text.size(), out.parsed, error)) {
+            if (error) *error = path + ": " + *error;
+            return false;
+        }
+        if (cacheEnabled) WriteCache(cachePath, sourceSize, sourceTime, out.parsed);
+
+        out.vertices = out.parsed.vertices.data();
+        out.vertexCount = static_cast<std::uint32_t>(out.parsed.vertices.size() / 6);
+        out.indices = out.parsed.indices.data();
+        out.indexCount = static_cast<std::uint32_t>(out.parsed.indices.size());
+        out.fromCache = false;
+        return true;
+    }
+
+}
@@ -1 +1,62 @@
 #pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Wavefront OBJ loader.
+//
+// Parsing works on the memory-mapped file with std::from_chars (no
+// iostreams, no per-line allocations). Supported: v (with optional
+// "r g b" vertex colors), vn, vt (skipped), and f with any of the
+// v, v/t, v//n, v/t/n forms, negative indices and polygons (fan
+// triangulated). Everything else (o, g, s, usemtl, ...) is ignored.
+//
+// Output matches Mesh: 6 floats per vertex (position + color) and a
+// triangle index list. The color is the vertex color if the file has one,
+// else the normal mapped to 0..1, else white. Corners sharing the same
+// position and normal become one vertex.
+//
+// Load() keeps a binary copy of the result in the cache directory
+// (<directory>/<FNV-1a of the path>.bin), stamped with the source's size
+// and modification time. A valid cache is memory-mapped and used as is:
+// the vertex and index pointers point straight into the file. A path
+// found in a mounted PackFile is read from the archive, and its cache is
+// stamped with the entry's size and content hash instead.
+
+namespace Framework {
+
+    struct ObjMeshData {
+        std::vector<float> vertices;          // 6 floats per vertex
+        std::vector<std::uint32_t> indices;   // triangles
+    };
+
+    // Result of Load(). The pointers refer either into the mapped cache
+    // file or into 'parsed', and stay valid while this object lives.
+    struct ObjMesh {
+        const float* vertices = nullptr;
+        std::uint32_t vertexCount = 0;
+        const std::uint32_t* indices = nullptr;
+        std::uint32_t indexCount = 0;
+        bool fromCache = false;
+
+        MappedFile cache;
+        ObjMeshData parsed;
+    };
+
+    class ObjLoader {
+    public:
+        static void SetCacheDirectory(const std::string& directory);   // default "mesh_cache"
+        static void SetCacheEnabled(bool enabled);
+
+        // Parse OBJ text. On failure 'error' says what and on which line.
+        static bool Parse(const char* text, std::size_t size, ObjMeshData& out, std::string* error = nullptr);
+
+        // Load 'path' from the cache if it is current, else parse the file
+        // and refresh the cache.
+        static bool Load(const std::string& path, ObjMesh& out, std::string* error = nullptr);
+
+        static std::string CachePath(const std::string& path);
+    };
+
+}
@@ -0,0 +1,268 @@
+#include "PackFile.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+namespace fs = std::filesystem;
+
+namespace Framework {
+
+    namespace {
+        // Newest last; searched back to front
+        std::vector<std::unique_ptr<PackFile>> mounted;
+
+        std::size_t AlignUp(std::size_t value, std::size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        // An LZ4 block expands at most about 255x (a run length costs one
+        // byte per 255), so a larger size in the table is corrupt and would
+        // only turn into a huge allocation in Read()
+        std::uint64_t Lz4MaxDecodedSize(std::uint64_t storedSize) {
+            return storedSize * 255 + 16;
+        }
+    }
+
+    // ===== PackFile =====
+
+    std::string PackFile::NormalizePath(std::string_view path) {
+        std::string result(path);
+        std::replace(result.begin(), result.end(), '\\', '/');
+        while (result.compare(0, 2, "./") == 0) result.erase(0, 2);
+        return result;
+    }
+
+    std::uint64_t PackFile::Hash(const void* data, std::size_t size, std::uint64_t h) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    bool PackFile::Open(const std::string& path) {
+        Close();
+        if (!file.Open(path)) return false;
+
+        const std::size_t fileSize = file.GetSize();
+        PackHeader header;
+        if (fileSize < sizeof(header)) {
+            Close();
+            return false;
+        }
+        std::memcpy(&header, file.GetData(), sizeof(header));
+
+        // Everything is checked once here so lookups and reads can trust
+        // the table; a truncated or foreign file is rejected outright
+        const std::uint64_t tocBytes = static_cast<std::uint64_t>(header.entryCount) * sizeof(PackEntry);
+        bool ok = std::memcmp(header.magic, kPackMagic, sizeof(kPackMagic)) == 0 && header.version == kPackVersion
+            && header.alignment >= 8 && (header.alignment & (header.alignment - 1)) == 0
+            && header.tocOffset % alignof(PackEntry) == 0
+            && header.tocOffset <= fileSize && tocBytes <= fileSize - header.tocOffset
+            && header.namesOffset <= fileSize;
+        if (ok) {
+            entries = { reinterpret_cast<const PackEntry*>(file.GetData() + header.tocOffset), header.entryCount };
+            names = { reinterpret_cast<const char*>(file.GetData() + header.namesOffset),
+                static_cast<std::size_t>(fileSize - header.namesOffset) };
+            for (std::size_t i = 0; ok && i < entries.size(); ++i) {
+                const PackEntry& e = entries[i];
+                ok = e.offset <= fileSize && e.storedSize <= fileSize - e.offset
+                    && static_cast<std::uint64_t>(e.nameOffset) + e.nameLength <= names.size()
+                    && ((e.flags & PackFlags::Lz4) ? e.size <= Lz4MaxDecodedSize(e.storedSize) : e.storedSize == e.size)
+                    && (i == 0 || entries[i - 1].pathHash <= e.pathHash);
+            }
+        }
+        if (!ok) Close();
+        return ok;
+    }
+
+    void PackFile::Close() {
+        entries = {};
+        names = {};
+        file.Close();
+    }
+
+    const PackEntry* PackFile::Find(std::string_view path) const {
+        const std::string name = NormalizePath(path);
+        const std::uint64_t hash = Hash(name.data(), name.size());
+        auto it = std::lower_bound(entries.begin(), entries.end(), hash,
+            [](const PackEntry& e, std::uint64_t h) { return e.pathHash < h; });
+        for (; it != entries.end() && it->pathHash == hash; ++it) {
+            if (GetName(*it) == name) return &*it;
+        }
+        return nullptr;
+    }
+
+    std::string_view PackFile::GetName(const PackEntry& entry) const {
+        return names.substr(entry.nameOffset, entry.nameLength);
+    }
+
+    std::span<const unsigned char> PackFile::GetStored(const PackEntry& entry) const {
+        return { file.GetData() + entry.offset, static_cast<std::size_t>(entry.storedSize) };
+    }
+
+    bool PackFile::Read(const PackEntry& entry, std::vector<unsigned char>& scratch,
+        std::span<const unsigned char>& out) const {
+        const std::span<const unsigned char> stored = GetStored(entry);
+        if (!(entry.flags & PackFlags::Lz4)) {
+            out = stored;
+            return true;
+        }
+
+        scratch.resize(static_cast<std::size_t>(entry.size));
+        const long long decoded = Lz4Decompress(stored.data(), stored.size(), scratch.data(), scratch.size());
+        if (decoded != static_cast<long long>(entry.size)) return false;
+        out = { scratch.data(), scratch.size() };
+        return true;
+    }
+
+    bool PackFile::Mount(const std::string& path) {
+        auto pack = std::make_unique<PackFile>();
+        if (!pack->Open(path)) return false;
+        mounted.push_back(std::move(pack));
+        return true;
+    }
+
+    void PackFile::UnmountAll() {
+        mounted.clear();
+    }
+
+    const PackFile* PackFile::FindMounted(std::string_view path, const PackEntry** entry) {
+        for (auto it = mounted.rbegin(); it != mounted.rend(); ++it) {
+            if (const PackEntry* found = (*it)->Find(path)) {
+                if (entry) *entry = found;
+                return it->get();
+            }
+        }
+        return nullptr;
+    }
+
+    bool PackFile::ReadMounted(std::string_view path, std::vector<unsigned char>& scratch,
+        std::span<const unsigned char>& out) {
+        if (mounted.empty()) return false;   // the common dev setup: loose files only
+        const PackEntry* entry = nullptr;
+        const PackFile* pack = FindMounted(path, &entry);
+        return pack && pack->Read(*entry, scratch, out);
+    }
+
+    // ===== PackWriter =====
+
+    PackWriter::PackWriter(std::uint32_t alignment)
+        : alignment(std::max<std::uint32_t>(alignment, 8))
+    {
+    }
+
+    void PackWriter::Add(std::string_view path, std::vector<unsigned char> data, bool compress) {
+        File f;
+        f.path = PackFile::NormalizePath(path);
+        f.contentHash = PackFile::Hash(data.data(), data.size());
+        f.size = data.size();
+        f.compressed = false;
+        if (compress && !data.empty()) {
+            std::vector<unsigned char> packed(Lz4CompressBound(data.size()));
+            packed.resize(Lz4Compress(data.data(), data.size(), packed.data()));
+            if (packed.size() <= data.size() - data.size() / 8) {
+                f.stored = std::move(packed);
+                f.compressed = true;
+            }
+        }
+        if (!f.compressed) f.stored = std::move(data);
+
+        auto it = std::find_if(files.begin(), files.end(), [&](const File& other) { return other.path == f.path; });
+        if (it != files.end()) *it = std::move(f);
+        else files.push_back(std::move(f));
+    }
+
+    std::size_t PackWriter::GetRawBytes() const {
+        std::size_t total = 0;
+        for (const File& f : files) total += static_cast<std::size_t>(f.size);
+        return total;
+    }
+
+    std::size_t PackWriter::GetStoredBytes() const {
+        std::size_t total = 0;
+        for (const File& f : files) total += f.stored.size();
+        return total;
+    }
+
+    bool PackWriter::Write(const std::string& path, std::string* error) const {
+        std::vector<const File*> order;
+        for (const File& f : files) order.push_back(&f);
+        std::vector<std::uint64_t> hashes(files.size());
+        for (std::size_t i = 0; i < files.size(); ++i) hashes[i] = PackFile::Hash(files[i].path.data(), files[i].path.size());
+        std::sort(order.begin(), order.end(), [&](const File* a, const File* b) {
+            return hashes[a - files.data()] < hashes[b - files.data()];
+        });
+
+        // Data in table order, so a loader walking one directory reads forward
+        std::vector<PackEntry> toc;
+        std::string names;
+        std::size_t offset = AlignUp(sizeof(PackHeader), alignment);
+        for (const File* f : order) {
+            PackEntry e{};
+            e.pathHash = hashes[f - files.data()];
+            e.contentHash = f->contentHash;
+            e.offset = offset;
+            e.storedSize = f->stored.size();
+            e.size = f->size;
+            e.nameOffset = static_cast<std::uint32_t>(names.size());
+            e.nameLength = static_cast<std::uint32_t>(f->path.size());
+            e.flags = f->compressed ? PackFlags::Lz4 : 0;
+            toc.push_back(e);
+            names += f->path;
+            offset = AlignUp(offset + f->stored.size(), alignment);
+        }
+
+        PackHeader header{};
+        std::memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+        header.version = kPackVersion;
+        header.entryCount = static_cast<std::uint32_t>(toc.size());
+        header.alignment = alignment;
+        header.tocOffset = offset;
+        header.namesOffset = offset + toc.size() * sizeof(PackEntry);
+
+        const std::string tmp = path + ".tmp";
+        std::FILE* out = std::fopen(tmp.c_str(), "wb");
+        if (!out) {
+            if (error) *error = "cannot create " + tmp;
+            return false;
+        }
+
+        static const unsigned char zeros[256] = {};
+        std::size_t written = 0;
+        auto put = [&](const void* data, std::size_t size) {
+            if (size && std::fwrite(data, 1, size, out) != size) return false;
+            written += size;
+            return true;
+        };
+        auto pad = [&](std::size_t to) {
+            while (written < to) {
+                if (!put(zeros, std::min(to - written, sizeof(zeros)))) return false;
+            }
+            return true;
+        };
+
+        bool ok = put(&header, sizeof(header));
+        for (std::size_t i = 0; ok && i < order.size(); ++i) {
+            ok = pad(static_cast<std::size_t>(toc[i].offset)) && put(order[i]->stored.data(), order[i]->stored.size());
+        }
+        ok = ok && pad(static_cast<std::size_t>(header.tocOffset))
+            && put(toc.data(), toc.size() * sizeof(PackEntry))
+            && put(names.data(), names.size());
+        ok = (std::fclose(out) == 0) && ok;
+
+        std::error_code ec;
+        if (ok) fs::rename(tmp, path, ec);
+        if (!ok || ec) {
+            fs::remove(tmp, ec);
+            if (error) *error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+}
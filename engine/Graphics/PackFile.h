@@ -0,0 +1,149 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Packed asset archive (.pak).
+//
+// One file instead of thousands: opening it is a single mmap, and lookups
+// are a binary search over a table of contents, so startup no longer pays
+// an open/stat/read per shader, image and mesh.
+//
+// Layout (little endian):
+//   PackHeader                  32 bytes
+//   entry data                  each entry starts on a multiple of 'alignment'
+//   PackEntry[entryCount]       at tocOffset, sorted by pathHash
+//   name table                  at namesOffset, the paths back to back
+//
+// Entries are stored raw or LZ4-compressed (PackFlags::Lz4), chosen per
+// entry by the packer. Raw entries are handed to loaders as spans straight
+// into the mapping, no copy at all; compressed ones are decoded into a
+// buffer the caller owns. Paths use '/' and are relative to the working
+// directory, as in the loose tree ("shaders/basic.vert").
+//
+// The tools/pack_assets tool writes archives with PackWriter.
+
+namespace Framework {
+
+    constexpr char kPackMagic[4] = { 'S', 'Q', 'P', 'K' };
+    constexpr std::uint32_t kPackVersion = 1;
+
+    struct PackHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t alignment;
+        std::uint64_t tocOffset;
+        std::uint64_t namesOffset;
+    };
+    static_assert(sizeof(PackHeader) == 32, "pack header layout");
+
+    namespace PackFlags {
+        constexpr std::uint32_t Lz4 = 1u << 0;
+    }
+
+    struct PackEntry {
+        std::uint64_t pathHash;       // PackFile::Hash of the normalized path
+        std::uint64_t contentHash;    // of the uncompressed bytes; a stable stamp for derived caches
+        std::uint64_t offset;         // from the start of the file
+        std::uint64_t storedSize;
+        std::uint64_t size;           // uncompressed
+        std::uint32_t nameOffset;     // into the name table
+        std::uint32_t nameLength;
+        std::uint32_t flags;          // PackFlags
+        std::uint32_t reserved;
+    };
+    static_assert(sizeof(PackEntry) == 56, "pack entry layout");
+
+    class PackFile {
+    public:
+        PackFile() = default;
+
+        PackFile(const PackFile&) = delete;
+        PackFile& operator=(const PackFile&) = delete;
+
+        // False (and closed) if the file is missing or not a valid archive.
+        bool Open(const std::string& path);
+        void Close();
+        bool IsOpen() const { return file.IsOpen(); }
+
+        // nullptr if 'path' is not in the archive.
+        const PackEntry* Find(std::string_view path) const;
+
+        std::span<const PackEntry> GetEntries() const { return entries; }
+        std::string_view GetName(const PackEntry& entry) const;
+
+        // The entry's bytes as stored, inside the mapping.
+        std::span<const unsigned char> GetStored(const PackEntry& entry) const;
+
+        // The uncompressed contents: the mapping itself for raw entries,
+        // else decoded into 'scratch'. 'out' stays valid while the archive
+        // is open and 'scratch' untouched. Safe from any thread.
+        bool Read(const PackEntry& entry, std::vector<unsigned char>& scratch,
+            std::span<const unsigned char>& out) const;
+
+        // ----- archives mounted for the whole run -----
+        //
+        // Loaders look here first and fall back to the loose file. Mount
+        // at startup, before any loader thread starts; lookups are then
+        // lock-free. Later mounts take precedence (patch archives).
+        static bool Mount(const std::string& path);
+        static void UnmountAll();
+
+        // First mounted archive holding 'path', or nullptr.
+        static const PackFile* FindMounted(std::string_view path, const PackEntry** entry = nullptr);
+
+        // Read 'path' from the mounted archives. False if no archive has it.
+        static bool ReadMounted(std::string_view path, std::vector<unsigned char>& scratch,
+            std::span<const unsigned char>& out);
+
+        // '\' to '/', leading "./" dropped.
+        static std::string NormalizePath(std::string_view path);
+
+        // 64-bit FNV-1a; pass a previous result as 'h' to hash several
+        // pieces as one. Also keys the OBJ and program binary caches.
+        static constexpr std::uint64_t kHashBasis = 1469598103934665603ull;
+        static std::uint64_t Hash(const void* data, std::size_t size, std::uint64_t h = kHashBasis);
+
+    private:
+        MappedFile file;
+        std::span<const PackEntry> entries;
+        std::string_view names;
+    };
+
+    // Builds an archive in memory and writes it in one go (offline tools).
+    class PackWriter {
+    public:
+        // 'alignment' (a power of two, at least 8) for the start of every
+        // entry; 16 keeps float / index arrays usable in place.
+        explicit PackWriter(std::uint32_t alignment = 16);
+
+        // Add 'data' under 'path'. With 'compress' the entry is stored LZ4
+        // compressed if that saves at least 1/8 of it, else raw. Adding a
+        // path twice replaces the first.
+        void Add(std::string_view path, std::vector<unsigned char> data, bool compress);
+
+        std::size_t GetEntryCount() const { return files.size(); }
+        std::size_t GetRawBytes() const;
+        std::size_t GetStoredBytes() const;
+
+        // Written next to 'path' and renamed, so readers never see half a file.
+        bool Write(const std::string& path, std::string* error = nullptr) const;
+
+    private:
+        struct File {
+            std::string path;
+            std::uint64_t contentHash;
+            std::uint64_t size;
+            std::vector<unsigned char> stored;
+            bool compressed;
+        };
+
+        std::uint32_t alignment;
+        std::vector<File> files;
+    };
+
+}
@@ -0,0 +1,216 @@
+#include "Precompiled.h"
+#include "ProgramCache.h"
+#include "Shader.h"
+#include "PackFile.h"
+#include "GL/glew.h"
+#include "GL/gl.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+namespace Framework {
+
+    namespace {
+        namespace fs = std::filesystem;
+
+        struct BinaryHeader {
+            char magic[4];                // "GLPB"
+            std::uint32_t version;
+            std::uint64_t key;
+            std::uint32_t format;         // binaryFormat from glGetProgramBinary
+            std::uint32_t length;         // bytes following the header
+        };
+        constexpr std::uint32_t kBinaryVersion = 1;
+
+        std::string s_directory = "shader_cache";
+        int s_enabled = -1;               // -1 = not probed yet
+        std::uint64_t s_driverHash = 0;
+        ProgramCacheStats s_stats;
+
+        // PackFile::Hash of the length, then the characters, so ("ab", "c")
+        // and ("a", "bc") differ
+        std::uint64_t HashString(std::string_view s, std::uint64_t h) {
+            const std::uint64_t n = s.size();
+            h = PackFile::Hash(&n, sizeof(n), h);
+            return PackFile::Hash(s.data(), s.size(), h);
+        }
+
+        const char* GLString(GLenum name) {
+            const GLubyte* s = glGetString(name);
+            return s ? reinterpret_cast<const char*>(s) : "";
+        }
+
+        // Probe the driver once: binary support and its identity.
+        void Probe() {
+            if (s_enabled >= 0) return;
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            s_enabled = formats > 0 ? 1 : 0;
+
+            std::uint64_t h = PackFile::kHashBasis;
+            h = HashString(GLString(GL_VENDOR), h);
+            h = HashString(GLString(GL_RENDERER), h);
+            h = HashString(GLString(GL_VERSION), h);
+            s_driverHash = h;
+        }
+
+        fs::path PathFor(std::uint64_t key) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+            return fs::path(s_directory) / name;
+        }
+    }
+
+    void ProgramCache::SetDirectory(const std::string& directory) {
+        s_directory = directory;
+    }
+
+    void ProgramCache::SetEnabled(bool enabled) {
+        Probe();
+        if (!enabled) s_enabled = 0;
+    }
+
+    bool ProgramCache::IsEnabled() {
+        Probe();
+        return s_enabled == 1;
+    }
+
+    const ProgramCacheStats& ProgramCache::GetStats() {
+        return s_stats;
+    }
+
+    std::uint64_t ProgramCache::MakeKey(const std::string& vertexSrc, const std::string& fragmentSrc) {
+        Probe();
+        std::uint64_t h = PackFile::Hash(&s_driverHash, sizeof(s_driverHash));
+        h = HashString(vertexSrc, h);
+        return HashString(fragmentSrc, h);
+    }
+
+    unsigned ProgramCache::Load(std::uint64_t key) {
+        if (!IsEnabled()) return 0;
+
+        const fs::path path = PathFor(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            ++s_stats.misses;
+            return 0;
+        }
+
+        BinaryHeader header{};
+        std::vector<char> blob;
+        bool valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            && std::memcmp(header.magic, "GLPB", 4) == 0
+            && header.version == kBinaryVersion
+            && header.key == key
+            && header.length > 0;
+        if (valid) {
+            blob.resize(header.length);
+            valid = static_cast<bool>(file.read(blob.data(), header.length));
+        }
+        file.close();
+
+        GLuint program = 0;
+        if (valid) {
+            program = glCreateProgram();
+            glProgramBinary(program, header.format, blob.data(), static_cast<GLsizei>(blob.size()));
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+
+        if (!program) {
+            std::cerr << "ProgramCache: discarding unusable binary " << path.string() << "\n";
+            std::error_code ec;
+            fs::remove(path, ec);
+            ++s_stats.rejected;
+            ++s_stats.misses;
+            return 0;
+        }
+
+        ++s_stats.hits;
+        return program;
+    }
+
+    bool ProgramCache::Store(std::uint64_t key, unsigned program) {
+        if (!IsEnabled()) return false;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return false;
+
+        std::vector<char> blob(static_cast<std::size_t>(length));
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, length, &written, &format, blob.data());
+        if (written <= 0) return false;
+
+        BinaryHeader header{};
+        std::memcpy(header.magic, "GLPB", 4);
+        header.version = kBinaryVersion;
+        header.key = key;
+        header.format = format;
+        header.length = static_cast<std::uint32_t>(written);
+
+        // Write next to the final name and rename, so a crash mid-write never
+        // leaves a truncated file under a valid key
+        std::error_code ec;
+        fs::create_directories(s_directory, ec);
+        const fs::path path = PathFor(key);
+        fs::path tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(blob.data(), written);
+            if (!out) return false;
+        }
+        fs::rename(tmp, path, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            return false;
+        }
+        ++s_stats.stores;
+        return true;
+    }
+
+    int ProgramCache::Precompile(const std::string& shaderDir) {
+        std::vector<std::pair<std::string, std::string>> programs;
+
+        const fs::path manifest = fs::path(shaderDir) / "programs.txt";
+        std::ifstream list(manifest);
+        if (list) {
+            std::string line;
+            while (std::getline(list, line)) {
+                std::istringstream words(line);
+                std::string vert, frag;
+                if (!(words >> vert) || vert[0] == '#') continue;
+                if (!(words >> frag)) continue;
+                programs.emplace_back((fs::path(shaderDir) / vert).string(), (fs::path(shaderDir) / frag).string());
+            }
+        }
+        else {
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(shaderDir, ec)) {
+                if (entry.path().extension() != ".vert") continue;
+                fs::path frag = entry.path();
+                frag.replace_extension(".frag");
+                if (fs::exists(frag)) programs.emplace_back(entry.path().string(), frag.string());
+            }
+        }
+
+        int linked = 0;
+        for (const auto& [vert, frag] : programs) {
+            Shader shader(vert, frag);
+            if (shader.IsLinked()) ++linked;
+        }
+        std::cout << "ProgramCache: " << linked << "/" << programs.size() << " programs ready ("
+            << s_stats.hits << " already cached, " << s_stats.stores << " written)\n";
+        return linked;
+    }
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// On-disk cache of linked program binaries (glGetProgramBinary /
+// glProgramBinary), so a warm start skips compiling and linking.
+//
+// Key: 64-bit FNV-1a of the vertex and fragment sources plus the driver's
+// GL_VENDOR, GL_RENDERER and GL_VERSION strings. A driver update therefore
+// changes every key, and old files are simply never read again.
+// File: <directory>/<key as 16 hex digits>.bin, a small header (magic,
+// version, key, binary format, length) followed by the driver's blob.
+//
+// Load() returns 0 on any mismatch (no file, wrong header, or the driver
+// refusing the binary); the caller then compiles from source and calls
+// Store(). A rejected file is deleted so it is not retried every launch.
+//
+// Needs a current GL context. Disabled automatically when the driver
+// reports no program binary formats.
+
+namespace Framework {
+
+    struct ProgramCacheStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t rejected = 0;     // file found but unusable
+        std::size_t stores = 0;
+    };
+
+    class ProgramCache {
+    public:
+        static void SetDirectory(const std::string& directory);   // default "shader_cache"
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        static std::uint64_t MakeKey(const std::string& vertexSrc, const std::string& fragmentSrc);
+
+        // Linked program from the cache, or 0.
+        static unsigned Load(std::uint64_t key);
+
+        // Save a linked program. It should have been linked with
+        // GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+        static bool Store(std::uint64_t key, unsigned program);
+
+        // Build every program listed in <shaderDir>/programs.txt (lines of
+        // "<vertex> <fragment>", '#' comments) so their binaries land in the
+        // cache. Without the manifest, pairs X.vert with X.frag. Returns the
+        // number of programs that linked.
+        static int Precompile(const std::string& shaderDir);
+
+        static const ProgramCacheStats& GetStats();
+    };
+
+}
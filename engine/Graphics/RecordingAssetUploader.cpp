@@ -0,0 +1,40 @@
+#include "RecordingAssetUploader.h"
+
+namespace Framework {
+
+    IAssetUploader::AssetId RecordingAssetUploader::CreateTexture(const std::string& name, const Image& image, bool) {
+        objects.push_back({ name, true, true, image.pixels.size() });
+        return static_cast<AssetId>(objects.size());
+    }
+
+    void RecordingAssetUploader::DestroyTexture(AssetId id) {
+        Destroy(id);
+    }
+
+    TextureRegion RecordingAssetUploader::GetTextureRegion(AssetId id) const {
+        TextureRegion region;
+        if (id != 0 && id <= objects.size() && objects[id - 1].alive) region.texture = id;
+        return region;
+    }
+
+    IAssetUploader::AssetId RecordingAssetUploader::CreateMesh(const std::string& name, const ObjMesh& mesh) {
+        const std::size_t bytes = mesh.vertexCount * 6 * sizeof(float) + mesh.indexCount * sizeof(std::uint32_t);
+        objects.push_back({ name, false, true, bytes });
+        return static_cast<AssetId>(objects.size());
+    }
+
+    void RecordingAssetUploader::DestroyMesh(AssetId id) {
+        Destroy(id);
+    }
+
+    void RecordingAssetUploader::Destroy(AssetId id) {
+        if (id != 0 && id <= objects.size()) objects[id - 1].alive = false;
+    }
+
+    std::size_t RecordingAssetUploader::GetLiveCount() const {
+        std::size_t live = 0;
+        for (const Object& o : objects) live += o.alive ? 1 : 0;
+        return live;
+    }
+
+}
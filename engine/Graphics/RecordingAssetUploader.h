@@ -0,0 +1,41 @@
+#pragma once
+#include "AssetUploader.h"
+#include <string>
+#include <vector>
+
+namespace Framework {
+
+    // IAssetUploader that creates nothing on a GPU and records what it was
+    // asked to do. Used by tools/bench_asset_streaming.
+    class RecordingAssetUploader : public IAssetUploader {
+    public:
+        struct Object {
+            std::string name;       // the path it was loaded from
+            bool isTexture = false;
+            bool alive = false;
+            std::size_t bytes = 0;
+        };
+
+        AssetId CreateTexture(const std::string& name, const Image& image, bool allowAtlas) override;
+        void DestroyTexture(AssetId id) override;
+        TextureRegion GetTextureRegion(AssetId id) const override;
+
+        AssetId CreateMesh(const std::string& name, const ObjMesh& mesh) override;
+        void DestroyMesh(AssetId id) override;
+        Mesh* GetMesh(AssetId) const override { return nullptr; }
+
+        void Flush() override { ++flushes; }
+
+        // Every object ever created, index = id - 1 (ids are never reused)
+        const std::vector<Object>& GetObjects() const { return objects; }
+        std::size_t GetLiveCount() const;
+        std::size_t GetFlushCount() const { return flushes; }
+
+    private:
+        void Destroy(AssetId id);
+
+        std::vector<Object> objects;
+        std::size_t flushes = 0;
+    };
+
+}
@@ -0,0 +1,138 @@
+#include "RecordingRenderBackend.h"
+#include <cstdio>
+
+namespace Framework {
+
+    namespace {
+        const char* CallName(RecordingRenderBackend::Call call) {
+            switch (call) {
+            case RecordingRenderBackend::Call::CreateVertexBuffer: return "CreateVertexBuffer";
+            case RecordingRenderBackend::Call::DestroyBuffer:      return "DestroyBuffer";
+            case RecordingRenderBackend::Call::CreateVertexArray:  return "CreateVertexArray";
+            case RecordingRenderBackend::Call::DestroyVertexArray: return "DestroyVertexArray";
+            case RecordingRenderBackend::Call::OrphanBuffer:       return "OrphanBuffer";
+            case RecordingRenderBackend::Call::MapBufferRange:     return "MapBufferRange";
+            case RecordingRenderBackend::Call::UnmapBuffer:        return "UnmapBuffer";
+            case RecordingRenderBackend::Call::UseProgram:         return "UseProgram";
+            case RecordingRenderBackend::Call::BindTexture:        return "BindTexture";
+            case RecordingRenderBackend::Call::BindVertexArray:    return "BindVertexArray";
+            case RecordingRenderBackend::Call::DrawArrays:         return "DrawArrays";
+            case RecordingRenderBackend::Call::DrawArraysInstanced: return "DrawArraysInstanced";
+            case RecordingRenderBackend::Call::DrawElements:       return "DrawElements";
+            case RecordingRenderBackend::Call::SetUniform3f:       return "SetUniform3f";
+            }
+            return "?";
+        }
+    }
+
+    void RecordingRenderBackend::Add(Call call, std::size_t a, std::size_t b, std::size_t c) {
+        records.push_back({ call, a, b, c });
+    }
+
+    unsigned RecordingRenderBackend::CreateVertexBuffer(std::size_t bytes) {
+        const unsigned name = nextName++;
+        buffers[name].assign(bytes, 0);
+        Add(Call::CreateVertexBuffer, bytes);
+        return name;
+    }
+
+    void RecordingRenderBackend::DestroyBuffer(unsigned buffer) {
+        buffers.erase(buffer);
+        Add(Call::DestroyBuffer, buffer);
+    }
+
+    unsigned RecordingRenderBackend::CreateVertexArray(unsigned buffer, const VertexAttrib*,
+        std::size_t attribCount, std::size_t stride) {
+        const unsigned name = nextName++;
+        Add(Call::CreateVertexArray, buffer, attribCount, stride);
+        return name;
+    }
+
+    void RecordingRenderBackend::DestroyVertexArray(unsigned vao) {
+        Add(Call::DestroyVertexArray, vao);
+    }
+
+    void RecordingRenderBackend::OrphanBuffer(unsigned buffer, std::size_t bytes) {
+        buffers[buffer].assign(bytes, 0);
+        ++counters.orphans;
+        Add(Call::OrphanBuffer, buffer, bytes);
+    }
+
+    void* RecordingRenderBackend::MapBufferRange(unsigned buffer, std::size_t offset, std::size_t bytes) {
+        Add(Call::MapBufferRange, buffer, offset, bytes);
+        auto it = buffers.find(buffer);
+        if (it == buffers.end() || offset + bytes > it->second.size()) return nullptr;
+        counters.bytesMapped += bytes;
+        return it->second.data() + offset;
+    }
+
+    void RecordingRenderBackend::UnmapBuffer(unsigned buffer) {
+        Add(Call::UnmapBuffer, buffer);
+    }
+
+    void RecordingRenderBackend::UseProgram(unsigned program) {
+        ++counters.programBinds;
+        Add(Call::UseProgram, program);
+    }
+
+    void RecordingRenderBackend::BindTexture(unsigned unit, unsigned texture) {
+        ++counters.textureBinds;
+        Add(Call::BindTexture, unit, texture);
+    }
+
+    void RecordingRenderBackend::BindVertexArray(unsigned vao) {
+        ++counters.vertexArrayBinds;
+        Add(Call::BindVertexArray, vao);
+    }
+
+    void RecordingRenderBackend::DrawArrays(Primitive primitive, std::size_t first, std::size_t count) {
+        ++counters.drawCalls;
+        counters.verticesDrawn += count;
+        Add(Call::DrawArrays, static_cast<std::size_t>(primitive), first, count);
+    }
+
+    void RecordingRenderBackend::DrawArraysInstanced(Primitive, std::size_t first, std::size_t count,
+        std::size_t instances) {
+        ++counters.drawCalls;
+        counters.verticesDrawn += count * instances;
+        counters.instancesDrawn += instances;
+        Add(Call::DrawArraysInstanced, first, count, instances);
+    }
+
+    void RecordingRenderBackend::DrawElements(Primitive, IndexType, std::size_t, std::size_t count,
+        std::size_t baseVertex, std::size_t instances) {
+        const std::size_t n = instances ? instances : 1;
+        ++counters.drawCalls;
+        counters.indicesDrawn += count * n;
+        counters.verticesDrawn += count * n;
+        if (instances) counters.instancesDrawn += instances;
+        Add(Call::DrawElements, count, baseVertex, instances);
+    }
+
+    void RecordingRenderBackend::SetUniform3f(int location, float, float, float) {
+        if (location < 0) return;
+        ++counters.uniformUploads;
+        Add(Call::SetUniform3f, static_cast<std::size_t>(location));
+    }
+
+    const std::vector<unsigned char>* RecordingRenderBackend::GetBufferData(unsigned buffer) const {
+        auto it = buffers.find(buffer);
+        return (it == buffers.end()) ? nullptr : &it->second;
+    }
+
+    void RecordingRenderBackend::Reset() {
+        records.clear();
+        counters = Counters{};
+    }
+
+    std::string RecordingRenderBackend::Dump() const {
+        std::string out;
+        char line[128];
+        for (const Record& r : records) {
+            std::snprintf(line, sizeof(line), "%s %zu %zu %zu\n", CallName(r.call), r.a, r.b, r.c);
+            out += line;
+        }
+        return out;
+    }
+
+}
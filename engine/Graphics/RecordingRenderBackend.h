@@ -0,0 +1,80 @@
+#pragma once
+#include "RenderBackend.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Framework {
+
+    // IRenderBackend that records every call instead of talking to a GPU.
+    // Buffers are backed by CPU memory, so mapped writes really happen and
+    // can be inspected. Used by tools/bench_sprite_batch and for checking
+    // draw-call counts in CI.
+    class RecordingRenderBackend : public IRenderBackend {
+    public:
+        enum class Call : std::uint8_t {
+            CreateVertexBuffer, DestroyBuffer, CreateVertexArray, DestroyVertexArray,
+            OrphanBuffer, MapBufferRange, UnmapBuffer,
+            UseProgram, BindTexture, BindVertexArray, DrawArrays,
+            DrawArraysInstanced, DrawElements, SetUniform3f,
+        };
+
+        struct Record {
+            Call call;
+            std::size_t a, b, c;    // call arguments, in declaration order
+        };
+
+        struct Counters {
+            std::size_t drawCalls = 0;
+            std::size_t verticesDrawn = 0;
+            std::size_t bytesMapped = 0;      // bytes handed out by MapBufferRange
+            std::size_t orphans = 0;
+            std::size_t programBinds = 0;
+            std::size_t textureBinds = 0;
+            std::size_t vertexArrayBinds = 0;
+            std::size_t instancesDrawn = 0;
+            std::size_t uniformUploads = 0;
+            std::size_t indicesDrawn = 0;
+        };
+
+        unsigned CreateVertexBuffer(std::size_t bytes) override;
+        void DestroyBuffer(unsigned buffer) override;
+
+        unsigned CreateVertexArray(unsigned buffer, const VertexAttrib* attribs,
+            std::size_t attribCount, std::size_t stride) override;
+        void DestroyVertexArray(unsigned vao) override;
+
+        void OrphanBuffer(unsigned buffer, std::size_t bytes) override;
+        void* MapBufferRange(unsigned buffer, std::size_t offset, std::size_t bytes) override;
+        void UnmapBuffer(unsigned buffer) override;
+
+        void UseProgram(unsigned program) override;
+        void BindTexture(unsigned unit, unsigned texture) override;
+        void BindVertexArray(unsigned vao) override;
+        void DrawArrays(Primitive primitive, std::size_t first, std::size_t count) override;
+        void DrawArraysInstanced(Primitive primitive, std::size_t first, std::size_t count,
+            std::size_t instances) override;
+        void DrawElements(Primitive primitive, IndexType type, std::size_t first, std::size_t count,
+            std::size_t baseVertex, std::size_t instances) override;
+        void SetUniform3f(int location, float x, float y, float z) override;
+
+        const std::vector<Record>& GetRecords() const { return records; }
+        const Counters& GetCounters() const { return counters; }
+        const std::vector<unsigned char>* GetBufferData(unsigned buffer) const;
+
+        // Forget recorded calls and counters (buffers are kept).
+        void Reset();
+
+        // One line per recorded call, e.g. "DrawArrays 0 0 6".
+        std::string Dump() const;
+
+    private:
+        void Add(Call call, std::size_t a = 0, std::size_t b = 0, std::size_t c = 0);
+
+        std::vector<Record> records;
+        Counters counters;
+        std::unordered_map<unsigned, std::vector<unsigned char>> buffers;
+        unsigned nextName = 1;
+    };
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// The small set of GPU operations the batched renderers need. GLRenderBackend
+// forwards them to OpenGL; RecordingRenderBackend only records them, so batch
+// counts and upload sizes can be checked on machines without a GPU.
+// Handles are plain GL-style names (0 = none).
+
+namespace Framework {
+
+    enum class Primitive : std::uint8_t {
+        Triangles,
+        Lines,
+        TriangleFan,
+    };
+
+    enum class IndexType : std::uint8_t {
+        None,
+        UInt16,
+        UInt32,
+    };
+
+    // One float vertex attribute: 'components' floats at 'offset' bytes.
+    struct VertexAttrib {
+        unsigned location;
+        int components;
+        std::size_t offset;
+    };
+
+    class IRenderBackend {
+    public:
+        virtual ~IRenderBackend() = default;
+
+        // Dynamic vertex buffer of 'bytes' bytes, contents undefined.
+        virtual unsigned CreateVertexBuffer(std::size_t bytes) = 0;
+        virtual void DestroyBuffer(unsigned buffer) = 0;
+
+        // Vertex array reading interleaved float attributes from 'buffer'.
+        virtual unsigned CreateVertexArray(unsigned buffer, const VertexAttrib* attribs,
+            std::size_t attribCount, std::size_t stride) = 0;
+        virtual void DestroyVertexArray(unsigned vao) = 0;
+
+        // Give the buffer new storage so the GPU can keep reading the old one.
+        virtual void OrphanBuffer(unsigned buffer, std::size_t bytes) = 0;
+
+        // Write-only mapping of a range the GPU is known not to be using
+        // (no synchronization). Returns nullptr on failure.
+        virtual void* MapBufferRange(unsigned buffer, std::size_t offset, std::size_t bytes) = 0;
+        virtual void UnmapBuffer(unsigned buffer) = 0;
+
+        virtual void UseProgram(unsigned program) = 0;
+        virtual void BindTexture(unsigned unit, unsigned texture) = 0;
+        virtual void BindVertexArray(unsigned vao) = 0;
+        virtual void DrawArrays(Primitive primitive, std::size_t first, std::size_t count) = 0;
+        virtual void DrawArraysInstanced(Primitive primitive, std::size_t first, std::size_t count,
+            std::size_t instances) = 0;
+
+        // 'count' indices from the element buffer of the bound vertex array,
+        // starting at index 'first', each offset by 'baseVertex'. 'instances'
+        // 0 is a plain draw.
+        virtual void DrawElements(Primitive primitive, IndexType type, std::size_t first, std::size_t count,
+            std::size_t baseVertex, std::size_t instances) = 0;
+
+        // vec3 uniform of the program in use; location -1 is ignored.
+        virtual void SetUniform3f(int location, float x, float y, float z) = 0;
+    };
+
+}
@@ -0,0 +1,154 @@
+#include "RenderCommandBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Framework {
+
+    namespace {
+        std::atomic<std::uint64_t> s_nextBufferId{ 1 };
+    }
+
+    std::uint64_t MakeSortKey(std::uint8_t layer, unsigned program, unsigned texture, float depth,
+        std::uint8_t user) {
+        const float d = std::clamp(depth, 0.0f, 1.0f);
+        const auto depthBits = static_cast<std::uint64_t>(d * 16777215.0f);
+        return (static_cast<std::uint64_t>(layer) << 56)
+            | (static_cast<std::uint64_t>(program & 0xFFF) << 44)
+            | (static_cast<std::uint64_t>(texture & 0xFFF) << 32)
+            | (depthBits << 8)
+            | user;
+    }
+
+    RenderCommandBuffer::RenderCommandBuffer()
+        : id(s_nextBufferId.fetch_add(1))
+    {
+    }
+
+    RenderCommandBuffer::List& RenderCommandBuffer::GetList() {
+        struct Cache {
+            std::uint64_t buffer = 0;
+            std::uint64_t frame = 0;
+            List* list = nullptr;
+        };
+        thread_local Cache cache;
+
+        const std::uint64_t now = frame.load(std::memory_order_acquire);
+        if (cache.buffer == id && cache.frame == now && cache.list) {
+            return *cache.list;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (listsInUse == lists.size()) {
+            lists.push_back(std::make_unique<List>());
+        }
+        List* list = lists[listsInUse++].get();
+        cache = { id, now, list };
+        return *list;
+    }
+
+    void RenderCommandBuffer::Clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < listsInUse; ++i) {
+            lists[i]->keys.clear();
+            lists[i]->commands.clear();
+        }
+        listsInUse = 0;
+        frame.fetch_add(1, std::memory_order_release);
+    }
+
+    void RenderCommandBuffer::Sort() {
+        // LSD radix sort on the key, 8 bits per pass. All histograms are
+        // built in one read; a byte that is equal in every key (common for
+        // layer / unused bits) skips its pass. Stable, so equal keys keep
+        // submission order.
+        const std::size_t n = entries.size();
+        std::size_t counts[8][256] = {};
+        for (const SortEntry& e : entries) {
+            for (int b = 0; b < 8; ++b) ++counts[b][(e.key >> (b * 8)) & 0xFF];
+        }
+
+        scratch.resize(n);
+        SortEntry* src = entries.data();
+        SortEntry* dst = scratch.data();
+        for (int b = 0; b < 8; ++b) {
+            std::size_t* c = counts[b];
+            if (c[(src[0].key >> (b * 8)) & 0xFF] == n) continue;
+
+            std::size_t offset = 0;
+            for (int i = 0; i < 256; ++i) {
+                const std::size_t count = c[i];
+                c[i] = offset;
+                offset += count;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                const SortEntry& e = src[i];
+                dst[c[(e.key >> (b * 8)) & 0xFF]++] = e;
+            }
+            std::swap(src, dst);
+            ++stats.sortPasses;
+        }
+        if (src != entries.data()) {
+            std::memcpy(entries.data(), src, n * sizeof(SortEntry));
+        }
+    }
+
+    void RenderCommandBuffer::Execute(IRenderBackend& backend) {
+        stats = RenderCommandStats{};
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+            for (std::size_t l = 0; l < listsInUse; ++l) {
+                const List& list = *lists[l];
+                for (std::size_t i = 0; i < list.commands.size(); ++i) {
+                    entries.push_back({ list.keys[i], &list.commands[i] });
+                }
+            }
+        }
+        stats.commands = entries.size();
+
+        if (!entries.empty()) {
+            Sort();
+
+            unsigned program = 0, texture = 0, vao = 0;
+            bool first = true;
+            for (const SortEntry& e : entries) {
+                const RenderCommand& cmd = *e.command;
+                if (first || cmd.program != program) {
+                    backend.UseProgram(cmd.program);
+                    program = cmd.program;
+                    ++stats.programChanges;
+                }
+                if (first || cmd.texture != texture) {
+                    backend.BindTexture(0, cmd.texture);
+                    texture = cmd.texture;
+                    ++stats.textureChanges;
+                }
+                if (first || cmd.vao != vao) {
+                    backend.BindVertexArray(cmd.vao);
+                    vao = cmd.vao;
+                    ++stats.vertexArrayChanges;
+                }
+                first = false;
+
+                if (cmd.colorLocation >= 0) {
+                    backend.SetUniform3f(cmd.colorLocation, cmd.color[0], cmd.color[1], cmd.color[2]);
+                }
+                if (cmd.indexType != IndexType::None) {
+                    backend.DrawElements(cmd.primitive, cmd.indexType, cmd.first, cmd.count, cmd.baseVertex,
+                        cmd.instances);
+                }
+                else if (cmd.instances > 0) {
+                    backend.DrawArraysInstanced(cmd.primitive, cmd.first, cmd.count, cmd.instances);
+                }
+                else {
+                    backend.DrawArrays(cmd.primitive, cmd.first, cmd.count);
+                }
+            }
+            backend.BindVertexArray(0);
+        }
+
+        Clear();
+    }
+
+}
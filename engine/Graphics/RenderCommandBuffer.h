@@ -0,0 +1,107 @@
+#pragma once
+#include "RenderBackend.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Render command buffer. Systems describe draws as small RenderCommands
+// with a 64-bit sort key instead of calling GL inline; the GL thread then
+// sorts all commands of the frame by key and executes them in one pass,
+// binding program / texture / vertex array only when they change.
+//
+// Recording is thread safe: each thread records into its own list (see
+// GetList()), so scene traversal can be split across workers without
+// locks per command. Execute() must not run while any thread records.
+//
+// Key layout (high bits sort first):
+//   63..56  layer    (8 bits)
+//   55..44  program  (12 bits)
+//   43..32  texture  (12 bits)
+//   31..8   depth    (24 bits, 0 = near; invert for back-to-front)
+//    7..0   free for the caller (e.g. sub-pass order)
+// Program and texture names are only truncated for ordering; the command
+// itself carries the full values. Equal keys keep submission order.
+
+namespace Framework {
+
+    struct RenderCommand {
+        unsigned vao = 0;
+        unsigned program = 0;
+        unsigned texture = 0;               // 0 = no texture
+        Primitive primitive = Primitive::Triangles;
+        IndexType indexType = IndexType::None;
+        std::uint32_t first = 0;            // first vertex, or first index when indexed
+        std::uint32_t count = 0;            // vertices, or indices when indexed
+        std::uint32_t baseVertex = 0;       // added to every index
+        std::uint32_t instances = 0;        // 0 = plain draw, else instanced
+        int colorLocation = -1;             // vec3 uniform set before the draw, -1 = none
+        float color[3] = { 1.0f, 1.0f, 1.0f };
+    };
+
+    struct RenderCommandStats {
+        std::size_t commands = 0;
+        std::size_t programChanges = 0;
+        std::size_t textureChanges = 0;
+        std::size_t vertexArrayChanges = 0;
+        std::size_t sortPasses = 0;         // radix passes actually run (of 8)
+    };
+
+    std::uint64_t MakeSortKey(std::uint8_t layer, unsigned program, unsigned texture, float depth,
+        std::uint8_t user = 0);
+
+    class RenderCommandBuffer {
+    public:
+        // Commands recorded by one thread during one frame.
+        class List {
+        public:
+            void Draw(std::uint64_t key, const RenderCommand& command) {
+                keys.push_back(key);
+                commands.push_back(command);
+            }
+            std::size_t Size() const { return commands.size(); }
+
+        private:
+            friend class RenderCommandBuffer;
+            std::vector<std::uint64_t> keys;
+            std::vector<RenderCommand> commands;
+        };
+
+        RenderCommandBuffer();
+
+        RenderCommandBuffer(const RenderCommandBuffer&) = delete;
+        RenderCommandBuffer& operator=(const RenderCommandBuffer&) = delete;
+
+        // The calling thread's list for the current frame. The first call
+        // on a thread per frame takes a lock; later calls do not.
+        List& GetList();
+
+        // Sort every recorded command by key, run them on 'backend' and
+        // start a new frame. Call on the GL thread after recording is done.
+        void Execute(IRenderBackend& backend);
+
+        // Drop everything recorded this frame without drawing.
+        void Clear();
+
+        const RenderCommandStats& GetStats() const { return stats; }
+
+    private:
+        struct SortEntry {
+            std::uint64_t key;
+            const RenderCommand* command;
+        };
+
+        void Sort();
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<List>> lists;   // reused across frames
+        std::size_t listsInUse = 0;
+
+        const std::uint64_t id;                      // tells thread-local caches of two buffers apart
+        std::atomic<std::uint64_t> frame{ 0 };
+
+        std::vector<SortEntry> entries, scratch;
+        RenderCommandStats stats;
+    };
+
+}
@@ -1,25 +1,37 @@
 #include "Precompiled.h"
 #include "Shader.h"
+#include "GLState.h"
+#include "ProgramCache.h"
+#include "PackFile.h"
 #include "GL/glew.h"
 #include "GL/gl.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 
 namespace Framework {
 
-    Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
-        std::cout << "\n\n==============================================\n";
-        std::cout << "    VERTEX & FRAGMENT SHADER SRC FILES\n";
-        std::cout << "==============================================\n\n";
-
+    Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath)
+    {
         std::string vertexSrc = LoadFile(vertexPath);
-        std::cout << "Vertex Shader Source:\n" << vertexSrc << "\n";
-
         std::string fragmentSrc = LoadFile(fragmentPath);
-        std::cout << "Fragment Shader Source:\n" << fragmentSrc << "\n";
+
+        // Warm start: the linked binary from a previous run, if the sources
+        // and driver are unchanged
+        const std::uint64_t key = ProgramCache::MakeKey(vertexSrc, fragmentSrc);
+        id = ProgramCache::Load(key);
+        if (id) {
+            linked = true;
+            std::cout << "Shader " << vertexPath << " + " << fragmentPath << ": loaded from program cache\n";
+            Reflect();
+            return;
+        }
 
         unsigned int vs = Compile(GL_VERTEX_SHADER, vertexSrc);
         unsigned int fs = Compile(GL_FRAGMENT_SHADER, fragmentSrc);
 
         id = glCreateProgram();
+        glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glAttachShader(id, vs);
         glAttachShader(id, fs);
         glLinkProgram(id);
@@ -32,36 +44,194 @@ namespace Framework {
             std::cerr << "Shader link failed:\n" << infoLog << "\n";
         }
 
+        glDetachShader(id, vs);
+        glDetachShader(id, fs);
         glDeleteShader(vs);
         glDeleteShader(fs);
+
+        linked = success != 0;
+        if (linked) {
+            std::cout << "Shader " << vertexPath << " + " << fragmentPath << ": compiled and linked\n";
+            ProgramCache::Store(key, id);
+            Reflect();
+        }
     }
 
     Shader::~Shader() {
-        glDeleteProgram(id);
+        GLState::DeleteProgram(id);
     }
 
     void Shader::Bind() const {
-        glUseProgram(id);
+        GLState::UseProgram(id);
     }
 
     void Shader::Unbind() const {
-        glUseProgram(0);
+        GLState::UseProgram(0);
     }
 
     unsigned int Shader::GetID() const {
         return id;
     }
 
-    std::string Shader::LoadFile(const std::string& path) {
-        std::ifstream file(path);
+    void Shader::Reflect() {
+        GLint count = 0;
+        glGetProgramInterfaceiv(id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+
+        const GLenum props[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX };
+        std::string name;
+        for (GLint i = 0; i < count; ++i) {
+            GLint values[5] = {};
+            glGetProgramResourceiv(id, GL_UNIFORM, i, 5, props, 5, nullptr, values);
+
+            // Members of uniform blocks have no location; they live in a UniformBuffer
+            if (values[4] != -1 || values[3] < 0) continue;
+
+            name.resize(values[0] > 0 ? values[0] : 1);
+            glGetProgramResourceName(id, GL_UNIFORM, i, values[0], nullptr, name.data());
+            name.resize(std::strlen(name.c_str()));
+
+            // "uLights[0]" is also reachable as "uLights"
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+                name.resize(name.size() - 3);
+            }
+
+            Uniform u;
+            u.location = values[3];
+            u.type = static_cast<unsigned>(values[1]);
+            u.arraySize = values[2];
+            uniformIndex.emplace(name, static_cast<int>(uniforms.size()));
+            uniforms.push_back(u);
+        }
+
+        glGetProgramInterfaceiv(id, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const GLenum prop = GL_NAME_LENGTH;
+            GLint length = 0;
+            glGetProgramResourceiv(id, GL_UNIFORM_BLOCK, i, 1, &prop, 1, nullptr, &length);
+            name.resize(length > 0 ? length : 1);
+            glGetProgramResourceName(id, GL_UNIFORM_BLOCK, i, length, nullptr, name.data());
+            name.resize(std::strlen(name.c_str()));
+            blockIndex.emplace(name, i);
+        }
+    }
+
+    Shader::Uniform* Shader::Find(std::string_view name) {
+        auto it = uniformIndex.find(name);
+        return (it == uniformIndex.end()) ? nullptr : &uniforms[it->second];
+    }
+
+    int Shader::GetUniformLocation(std::string_view name) const {
+        auto it = uniformIndex.find(name);
+        return (it == uniformIndex.end()) ? -1 : uniforms[it->second].location;
+    }
+
+    int Shader::GetUniformBlockIndex(std::string_view name) const {
+        auto it = blockIndex.find(name);
+        return (it == blockIndex.end()) ? -1 : it->second;
+    }
+
+    bool Shader::Changed(Uniform& u, const void* value, std::size_t words) {
+        if (u.words == words && std::memcmp(u.last, value, words * 4) == 0) {
+            ++uniformStats.skipped;
+            return false;
+        }
+        std::memcpy(u.last, value, words * 4);
+        u.words = static_cast<std::uint8_t>(words);
+        ++uniformStats.uploads;
+        return true;
+    }
+
+    void Shader::SetInt(std::string_view name, int value) {
+        Uniform* u = Find(name);
+        if (u && Changed(*u, &value, 1)) glProgramUniform1i(id, u->location, value);
+    }
+
+    void Shader::SetFloat(std::string_view name, float value) {
+        Uniform* u = Find(name);
+        if (u && Changed(*u, &value, 1)) glProgramUniform1f(id, u->location, value);
+    }
+
+    void Shader::SetVec2(std::string_view name, const glm::vec2& value) {
+        Uniform* u = Find(name);
+        if (u && Changed(*u, glm::value_ptr(value), 2)) glProgramUniform2fv(id, u->location, 1, glm::value_ptr(value));
+    }
+
+    void Shader::SetVec3(std::string_view name, const glm::vec3& value) {
+        Uniform* u = Find(name);
+        if (u && Changed(*u, glm::value_ptr(value), 3)) glProgramUniform3fv(id, u->location, 1, glm::value_ptr(value));
+    }
+
+    void Shader::SetVec4(std::string_view name, const glm::vec4& value) {
+        Uniform* u = Find(name);
+        if (u && Changed(*u, glm::value_ptr(value), 4)) glProgramUniform4fv(id, u->location, 1, glm::value_ptr(value));
+    }
+
+    void Shader::SetMat4(std::string_view name, const glm::mat4& value) {
+        Uniform* u = Find(name);
+        if (u && Changed(*u, glm::value_ptr(value), 16)) glProgramUniformMatrix4fv(id, u->location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+
+    void Shader::ReplaceProgram(unsigned int program) {
+        // Remember what was set on the old program
+        std::vector<std::pair<std::string, Uniform>> values;
+        for (const auto& [name, index] : uniformIndex) {
+            if (uniforms[index].words > 0) values.emplace_back(name, uniforms[index]);
+        }
+
+        GLState::DeleteProgram(id);
+        id = program;
+        linked = true;
+        uniforms.clear();
+        uniformIndex.clear();
+        blockIndex.clear();
+        Reflect();
+
+        for (const auto& [name, old] : values) {
+            Uniform* u = Find(name);
+            if (!u || u->type != old.type) continue;
+            std::memcpy(u->last, old.last, sizeof(old.last));
+            u->words = old.words;
+            Upload(*u);
+        }
+    }
+
+    void Shader::Upload(const Uniform& u) {
+        const auto* f = reinterpret_cast<const GLfloat*>(u.last);
+        const auto* i = reinterpret_cast<const GLint*>(u.last);
+        switch (u.type) {
+        case GL_FLOAT:      glProgramUniform1fv(id, u.location, 1, f); break;
+        case GL_FLOAT_VEC2: glProgramUniform2fv(id, u.location, 1, f); break;
+        case GL_FLOAT_VEC3: glProgramUniform3fv(id, u.location, 1, f); break;
+        case GL_FLOAT_VEC4: glProgramUniform4fv(id, u.location, 1, f); break;
+        case GL_FLOAT_MAT4: glProgramUniformMatrix4fv(id, u.location, 1, GL_FALSE, f); break;
+        default:            if (u.words == 1) glProgramUniform1iv(id, u.location, 1, i); break;  // int, bool, samplers
+        }
+    }
+
+    bool Shader::BindUniformBlock(std::string_view name, unsigned binding) {
+        const int block = GetUniformBlockIndex(name);
+        if (block < 0) return false;
+        glUniformBlockBinding(id, static_cast<GLuint>(block), binding);
+        return true;
+    }
+
+    std::string Shader::LoadFile(const std::string& path, bool allowPack) {
+        std::vector<unsigned char> scratch;
+        std::span<const unsigned char> packed;
+        if (allowPack && PackFile::ReadMounted(path, scratch, packed)) {
+            return std::string(reinterpret_cast<const char*>(packed.data()), packed.size());
+        }
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
         if (!file) {
             std::cerr << "ERROR: Failed to open shader file: " << path << std::endl;
             return "";
         }
 
-        std::stringstream ss;
-        ss << file.rdbuf();
-        return ss.str();
+        std::string source(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(source.data(), static_cast<std::streamsize>(source.size()));
+        return source;
     }
 
     unsigned int Shader::Compile(unsigned int type, const std::string& source) {
@@ -1,8 +1,19 @@
 #pragma once
 #include "Precompiled.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <glm/glm.hpp>
 
 namespace Framework {
 
+    // Counts of uniform uploads made and skipped because the value was
+    // unchanged, since the program was linked.
+    struct UniformStats {
+        std::size_t uploads = 0;
+        std::size_t skipped = 0;
+    };
+
     class Shader {
     public:
         Shader(const std::string& vertexPath, const std::string& fragmentPath);
@@ -12,12 +23,72 @@ namespace Framework {
         void Unbind() const;
 
         unsigned int GetID() const;
+        bool IsLinked() const { return linked; }
+        const std::string& GetVertexPath() const { return vertexPath; }
+        const std::string& GetFragmentPath() const { return fragmentPath; }
+
+        // Take ownership of a newly linked program (hot reload) and delete
+        // the old one. Uniforms are reflected again, and values set through
+        // this Shader are uploaded to the new program where the name and
+        // type still match.
+        void ReplaceProgram(unsigned int program);
+
+        // From a mounted PackFile if one holds 'path', else the loose file.
+        // Hot reload passes 'allowPack' false: it watches the loose files.
+        static std::string LoadFile(const std::string& path, bool allowPack = true);
+
+        // Active uniforms are reflected once at link time. Lookups hash the
+        // name into that table (no driver call); -1 = not an active uniform.
+        int GetUniformLocation(std::string_view name) const;
+        int GetUniformBlockIndex(std::string_view name) const;
+
+        // Typed setters. They write through glProgramUniform*, so the
+        // program does not need to be bound, and skip the upload when the
+        // value equals the last one set through this Shader. Unknown names
+        // are ignored. Do not mix with raw glUniform* calls on the same
+        // uniform, or the cached value goes stale.
+        void SetInt(std::string_view name, int value);
+        void SetFloat(std::string_view name, float value);
+        void SetVec2(std::string_view name, const glm::vec2& value);
+        void SetVec3(std::string_view name, const glm::vec3& value);
+        void SetVec4(std::string_view name, const glm::vec4& value);
+        void SetMat4(std::string_view name, const glm::mat4& value);
+
+        // Point a uniform block at a UniformBuffer binding. Only needed for
+        // blocks declared without layout(binding = N).
+        bool BindUniformBlock(std::string_view name, unsigned binding);
+
+        const UniformStats& GetUniformStats() const { return uniformStats; }
 
     private:
+        struct Uniform {
+            int location = -1;
+            unsigned type = 0;              // GL_FLOAT_VEC3, ...
+            int arraySize = 1;
+            std::uint8_t words = 0;         // 32-bit words last uploaded, 0 = never
+            std::uint32_t last[16] = {};
+        };
+
+        struct NameHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+        };
+        using NameTable = std::unordered_map<std::string, int, NameHash, std::equal_to<>>;
+
         unsigned int id;
+        bool linked = false;
+        std::string vertexPath, fragmentPath;
+
+        std::vector<Uniform> uniforms;
+        NameTable uniformIndex;             // name -> index into uniforms
+        NameTable blockIndex;               // name -> uniform block index
+        UniformStats uniformStats;
 
-        std::string LoadFile(const std::string& path);
         unsigned int Compile(unsigned int type, const std::string& source);
+        void Reflect();
+        Uniform* Find(std::string_view name);
+        bool Changed(Uniform& u, const void* value, std::size_t words);
+        void Upload(const Uniform& u);
     };
 
 }
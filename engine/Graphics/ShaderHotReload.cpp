@@ -0,0 +1,248 @@
+#include "Precompiled.h"
+#include "ShaderHotReload.h"
+#include "Shader.h"
+#include "ProgramCache.h"
+#include "GL/glew.h"
+#include "GL/gl.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Framework {
+
+    namespace {
+        namespace fs = std::filesystem;
+
+        constexpr double kPollInterval = 0.5;   // seconds, when there is no inotify
+
+        std::string Normalize(const std::string& path) {
+            return fs::path(path).lexically_normal().generic_string();
+        }
+
+        std::int64_t WriteTime(const std::string& path) {
+            std::error_code ec;
+            const auto t = fs::last_write_time(path, ec);
+            return ec ? 0 : static_cast<std::int64_t>(t.time_since_epoch().count());
+        }
+
+        double Now() {
+            using namespace std::chrono;
+            return duration<double>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        void PrintShaderLog(unsigned shader, const char* stage) {
+            GLint ok = 0;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+            if (ok) return;
+            char infoLog[1024];
+            glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+            std::cerr << stage << " shader compile error:\n" << infoLog << "\n";
+        }
+    }
+
+    ShaderHotReload::ShaderHotReload() {
+        // Let the driver compile on as many threads as it likes
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+            parallelCompile = true;
+        }
+        else if (GLEW_ARB_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+            parallelCompile = true;
+        }
+
+#if defined(__linux__)
+        notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+        std::cout << "ShaderHotReload: watching with " << (notifyFd >= 0 ? "inotify" : "polling")
+            << ", " << (parallelCompile ? "parallel" : "synchronous") << " compile\n";
+    }
+
+    ShaderHotReload::~ShaderHotReload() {
+        for (Build& build : builds) CancelBuild(build);
+#if defined(__linux__)
+        if (notifyFd >= 0) close(notifyFd);
+#endif
+    }
+
+    void ShaderHotReload::Watch(Shader* shader) {
+        if (!shader || std::find(shaders.begin(), shaders.end(), shader) != shaders.end()) return;
+        shaders.push_back(shader);
+        AddWatch(shader->GetVertexPath());
+        AddWatch(shader->GetFragmentPath());
+    }
+
+    void ShaderHotReload::Unwatch(Shader* shader) {
+        shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+        for (auto it = builds.begin(); it != builds.end();) {
+            if (it->shader == shader) {
+                CancelBuild(*it);
+                it = builds.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    void ShaderHotReload::AddWatch(const std::string& path) {
+        const std::string key = Normalize(path);
+        if (files.count(key)) return;
+        files[key] = WriteTime(key);
+
+#if defined(__linux__)
+        if (notifyFd < 0) return;
+        std::string dir = fs::path(key).parent_path().generic_string();
+        if (dir.empty()) dir = ".";
+        for (const auto& [wd, watched] : watchDirs) {
+            if (watched == dir) return;
+        }
+        // Editors often save via a temp file + rename, hence IN_MOVED_TO
+        const int wd = inotify_add_watch(notifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd >= 0) watchDirs[wd] = dir;
+#endif
+    }
+
+    void ShaderHotReload::CollectChanges(std::vector<std::string>& changed) {
+#if defined(__linux__)
+        if (notifyFd >= 0) {
+            alignas(inotify_event) char buffer[4096];
+            for (;;) {
+                const ssize_t n = read(notifyFd, buffer, sizeof(buffer));
+                if (n <= 0) break;   // EAGAIN: nothing more queued
+                for (ssize_t offset = 0; offset < n;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+
+                    auto dir = watchDirs.find(event->wd);
+                    if (dir == watchDirs.end() || event->len == 0) continue;
+                    const std::string path = Normalize(dir->second + "/" + event->name);
+                    if (files.count(path)) changed.push_back(path);
+                }
+            }
+            return;
+        }
+#endif
+        const double now = Now();
+        if (now < nextPoll) return;
+        nextPoll = now + kPollInterval;
+        for (auto& [path, time] : files) {
+            const std::int64_t t = WriteTime(path);
+            if (t != time) {
+                time = t;
+                changed.push_back(path);
+            }
+        }
+    }
+
+    void ShaderHotReload::Update() {
+        std::vector<std::string> changed;
+        CollectChanges(changed);
+
+        if (!changed.empty()) {
+            for (Shader* shader : shaders) {
+                const bool hit = std::any_of(changed.begin(), changed.end(), [&](const std::string& path) {
+                    return path == Normalize(shader->GetVertexPath()) || path == Normalize(shader->GetFragmentPath());
+                });
+                if (hit) StartBuild(shader);
+            }
+        }
+
+        for (auto it = builds.begin(); it != builds.end();) {
+            if (Finished(*it)) {
+                FinishBuild(*it);
+                it = builds.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    void ShaderHotReload::StartBuild(Shader* shader) {
+        // A newer save replaces a build still in flight
+        for (auto it = builds.begin(); it != builds.end(); ++it) {
+            if (it->shader == shader) {
+                CancelBuild(*it);
+                builds.erase(it);
+                break;
+            }
+        }
+
+        const std::string vertexSrc = Shader::LoadFile(shader->GetVertexPath(), false);
+        const std::string fragmentSrc = Shader::LoadFile(shader->GetFragmentPath(), false);
+        if (vertexSrc.empty() || fragmentSrc.empty()) return;   // mid-save; the next event retries
+
+        std::cout << "ShaderHotReload: rebuilding " << shader->GetVertexPath() << " + " << shader->GetFragmentPath() << "\n";
+
+        // Nothing here waits on the driver: status is only queried once the
+        // build reports completion
+        Build build;
+        build.shader = shader;
+        build.cacheKey = ProgramCache::MakeKey(vertexSrc, fragmentSrc);
+
+        const char* src = vertexSrc.c_str();
+        build.vs = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(build.vs, 1, &src, nullptr);
+        glCompileShader(build.vs);
+
+        src = fragmentSrc.c_str();
+        build.fs = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(build.fs, 1, &src, nullptr);
+        glCompileShader(build.fs);
+
+        build.program = glCreateProgram();
+        glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glAttachShader(build.program, build.vs);
+        glAttachShader(build.program, build.fs);
+        glLinkProgram(build.program);
+
+        builds.push_back(build);
+    }
+
+    bool ShaderHotReload::Finished(const Build& build) const {
+        if (!parallelCompile) return true;
+        GLint done = 0;
+        glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &done);
+        return done != 0;
+    }
+
+    void ShaderHotReload::FinishBuild(Build& build) {
+        GLint linked = 0;
+        glGetProgramiv(build.program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            PrintShaderLog(build.vs, "Vertex");
+            PrintShaderLog(build.fs, "Fragment");
+            char infoLog[1024];
+            glGetProgramInfoLog(build.program, sizeof(infoLog), nullptr, infoLog);
+            std::cerr << "ShaderHotReload: " << build.shader->GetVertexPath() << " + " << build.shader->GetFragmentPath()
+                << " failed, keeping the old program\n" << infoLog << "\n";
+            CancelBuild(build);
+            ++failures;
+            return;
+        }
+
+        glDetachShader(build.program, build.vs);
+        glDetachShader(build.program, build.fs);
+        glDeleteShader(build.vs);
+        glDeleteShader(build.fs);
+
+        ProgramCache::Store(build.cacheKey, build.program);
+        build.shader->ReplaceProgram(build.program);
+        ++reloads;
+        std::cout << "ShaderHotReload: swapped in " << build.shader->GetVertexPath() << " + " << build.shader->GetFragmentPath() << "\n";
+    }
+
+    void ShaderHotReload::CancelBuild(Build& build) {
+        if (build.vs) glDeleteShader(build.vs);
+        if (build.fs) glDeleteShader(build.fs);
+        if (build.program) glDeleteProgram(build.program);
+        build = Build{};
+    }
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Shader hot reload. Watches the source files of registered Shaders and,
+// when one changes, builds a new program in the background and swaps it
+// in at the start of a frame. If the new sources fail to compile or link,
+// the errors are printed and the old program stays in use.
+//
+// Watching: inotify on Linux (non-blocking read each Update), elsewhere the
+// files' modification times are polled twice a second. Both catch editors
+// that save by writing a temp file and renaming it.
+//
+// Building: with GL_KHR/ARB_parallel_shader_compile the driver compiles
+// on its own threads and Update() only polls GL_COMPLETION_STATUS, so the
+// frame never waits on the compiler. Without it the build runs inside the
+// Update() that noticed the change (one hitch per save, debug only).
+//
+// GraphicsSystem creates one in debug builds (STRUCTSQUAD_SHADER_RELOAD=1
+// or =0 overrides that). All calls on the GL thread. Update() belongs at frame start, before any
+// draw is recorded, so a frame never mixes old and new program names.
+
+namespace Framework {
+
+    class Shader;
+
+    class ShaderHotReload {
+    public:
+        ShaderHotReload();
+        ~ShaderHotReload();
+
+        ShaderHotReload(const ShaderHotReload&) = delete;
+        ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+
+        void Watch(Shader* shader);
+        void Unwatch(Shader* shader);
+
+        // Pick up file changes, start builds, swap in finished programs.
+        void Update();
+
+        std::size_t GetReloadCount() const { return reloads; }
+        std::size_t GetFailureCount() const { return failures; }
+
+    private:
+        struct Build {
+            Shader* shader = nullptr;
+            unsigned program = 0;
+            unsigned vs = 0, fs = 0;
+            std::uint64_t cacheKey = 0;
+        };
+
+        void StartBuild(Shader* shader);
+        bool Finished(const Build& build) const;
+        void FinishBuild(Build& build);
+        void CancelBuild(Build& build);
+        void CollectChanges(std::vector<std::string>& changed);
+        void AddWatch(const std::string& path);
+
+        std::vector<Shader*> shaders;
+        std::vector<Build> builds;
+        bool parallelCompile = false;
+        std::size_t reloads = 0;
+        std::size_t failures = 0;
+
+        // Watched files: path -> last write time (polling) and, with
+        // inotify, watched directory descriptor -> directory path
+        std::unordered_map<std::string, std::int64_t> files;
+        std::unordered_map<int, std::string> watchDirs;
+        int notifyFd = -1;
+        double nextPoll = 0.0;
+    };
+
+}
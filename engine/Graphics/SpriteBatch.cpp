@@ -0,0 +1,211 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+
+namespace Framework {
+
+    namespace {
+        const VertexAttrib kBatchAttribs[] = {
+            { 0, 3, offsetof(BatchVertex, x) },
+            { 1, 3, offsetof(BatchVertex, r) },
+            { 2, 2, offsetof(BatchVertex, u) },
+        };
+
+        // Idle buckets are pruned in Begin() once there are more than this many.
+        constexpr std::size_t kMaxIdleBuckets = 256;
+
+        // Two-word sort key: (layer, program), (texture, primitive). The layer's
+        // sign bit is flipped so negative layers sort first.
+        std::pair<std::uint64_t, std::uint64_t> SortKey(const BatchState& s) {
+            return {
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(s.layer) ^ 0x80000000u) << 32) | s.program,
+                (static_cast<std::uint64_t>(s.texture) << 8) | static_cast<std::uint64_t>(s.primitive)
+            };
+        }
+    }
+
+    SpriteBatch::SpriteBatch(IRenderBackend& backend, std::size_t initialVertices)
+        : backend(backend), capacity(std::max<std::size_t>(initialVertices, 6))
+    {
+        vbo = backend.CreateVertexBuffer(capacity * sizeof(BatchVertex));
+        vao = backend.CreateVertexArray(vbo, kBatchAttribs, std::size(kBatchAttribs), sizeof(BatchVertex));
+    }
+
+    SpriteBatch::~SpriteBatch() {
+        backend.DestroyVertexArray(vao);
+        backend.DestroyBuffer(vbo);
+    }
+
+    void SpriteBatch::Begin() {
+        // Forget states that have not been drawn for a frame once they pile up
+        // (e.g. after a level change), so End() does not walk stale buckets.
+        if (buckets.size() > kMaxIdleBuckets) {
+            buckets.erase(std::remove_if(buckets.begin(), buckets.end(),
+                [](const Bucket& b) { return !b.usedLastFrame && b.vertices.empty(); }), buckets.end());
+            bucketIndex.clear();
+            for (std::size_t i = 0; i < buckets.size(); ++i) {
+                bucketIndex[{ buckets[i].sortHi, buckets[i].sortLo }] = static_cast<std::uint32_t>(i);
+            }
+            lastBucket = 0;
+        }
+        for (Bucket& b : buckets) {
+            b.usedLastFrame = !b.vertices.empty();
+            b.vertices.clear();
+        }
+        stats = BatchStats{};
+    }
+
+    std::vector<BatchVertex>& SpriteBatch::BucketFor(const BatchState& state) {
+        const auto key = SortKey(state);
+        if (lastBucket < buckets.size() && buckets[lastBucket].sortHi == key.first && buckets[lastBucket].sortLo == key.second) {
+            return buckets[lastBucket].vertices;
+        }
+        auto it = bucketIndex.find(key);
+        if (it == bucketIndex.end()) {
+            it = bucketIndex.emplace(key, static_cast<std::uint32_t>(buckets.size())).first;
+            Bucket b;
+            b.state = state;
+            b.sortHi = key.first;
+            b.sortLo = key.second;
+            buckets.push_back(std::move(b));
+        }
+        lastBucket = it->second;
+        return buckets[lastBucket].vertices;
+    }
+
+    void SpriteBatch::Submit(const BatchState& state, const BatchVertex* vertices, std::size_t count) {
+        if (!vertices || count == 0) return;
+        ++stats.submissions;
+        std::vector<BatchVertex>& dst = BucketFor(state);
+        dst.insert(dst.end(), vertices, vertices + count);
+    }
+
+    void SpriteBatch::SubmitQuad(const BatchState& state, float cx, float cy, float w, float h,
+        float r, float g, float b) {
+        const float x0 = cx - w * 0.5f, x1 = cx + w * 0.5f;
+        const float y0 = cy - h * 0.5f, y1 = cy + h * 0.5f;
+        BatchState s = state;
+        s.primitive = Primitive::Triangles;
+        ++stats.submissions;
+        std::vector<BatchVertex>& dst = BucketFor(s);
+        dst.push_back({ x0, y1, 0.0f, r, g, b, 0.0f, 1.0f });
+        dst.push_back({ x1, y1, 0.0f, r, g, b, 1.0f, 1.0f });
+        dst.push_back({ x0, y0, 0.0f, r, g, b, 0.0f, 0.0f });
+        dst.push_back({ x1, y1, 0.0f, r, g, b, 1.0f, 1.0f });
+        dst.push_back({ x1, y0, 0.0f, r, g, b, 1.0f, 0.0f });
+        dst.push_back({ x0, y0, 0.0f, r, g, b, 0.0f, 0.0f });
+    }
+
+    template <typename Fetch>
+    void SpriteBatch::Append(BatchState state, Topology topology, std::size_t count, const Fetch& at) {
+        if (topology == Topology::TriangleFan && count < 3) return;
+
+        state.primitive = (topology == Topology::Lines) ? Primitive::Lines : Primitive::Triangles;
+        ++stats.submissions;
+        std::vector<BatchVertex>& dst = BucketFor(state);
+        if (topology == Topology::TriangleFan) {
+            for (std::size_t i = 1; i + 1 < count; ++i) {
+                dst.push_back(at(0));
+                dst.push_back(at(i));
+                dst.push_back(at(i + 1));
+            }
+        }
+        else {
+            const std::size_t per = (topology == Topology::Lines) ? 2 : 3;
+            const std::size_t whole = count / per * per;   // drop an incomplete primitive
+            for (std::size_t i = 0; i < whole; ++i) dst.push_back(at(i));
+        }
+    }
+
+    void SpriteBatch::SubmitVertices(BatchState state, const float* vertices6, std::size_t vertexCount,
+        Topology topology, float x, float y, float scale) {
+        if (!vertices6 || vertexCount == 0) return;
+
+        Append(state, topology, vertexCount, [&](std::size_t i) {
+            const float* v = vertices6 + i * 6;
+            return BatchVertex{ x + v[0] * scale, y + v[1] * scale, v[2], v[3], v[4], v[5], 0.0f, 0.0f };
+        });
+    }
+
+    void SpriteBatch::SubmitIndexed(BatchState state, const float* vertices6, const std::uint32_t* indices,
+        std::size_t indexCount, Topology topology, float x, float y, float scale) {
+        if (!vertices6 || !indices || indexCount == 0) return;
+
+        Append(state, topology, indexCount, [&](std::size_t i) {
+            const float* v = vertices6 + static_cast<std::size_t>(indices[i]) * 6;
+            return BatchVertex{ x + v[0] * scale, y + v[1] * scale, v[2], v[3], v[4], v[5], 0.0f, 0.0f };
+        });
+    }
+
+    void SpriteBatch::Grow(std::size_t vertices) {
+        while (capacity < vertices) capacity *= 2;
+        backend.OrphanBuffer(vbo, capacity * sizeof(BatchVertex));
+        ++stats.orphans;
+        writeVertex = 0;
+    }
+
+    void SpriteBatch::End() {
+        // Non-empty buckets in draw order. Buckets are per state, so this
+        // sorts a handful of entries, not one per sprite.
+        order.clear();
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            if (buckets[i].vertices.empty()) continue;
+            order.push_back(static_cast<std::uint32_t>(i));
+            total += buckets[i].vertices.size();
+        }
+        if (total == 0) return;
+        std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+            return std::tie(buckets[a].sortHi, buckets[a].sortLo) < std::tie(buckets[b].sortHi, buckets[b].sortLo);
+        });
+
+        // Room for the whole frame in the unused tail of the buffer, else orphan.
+        if (total > capacity) {
+            Grow(total);
+        }
+        else if (writeVertex + total > capacity) {
+            backend.OrphanBuffer(vbo, capacity * sizeof(BatchVertex));
+            ++stats.orphans;
+            writeVertex = 0;
+        }
+
+        const std::size_t bytes = total * sizeof(BatchVertex);
+        auto* dst = static_cast<BatchVertex*>(backend.MapBufferRange(vbo, writeVertex * sizeof(BatchVertex), bytes));
+        if (!dst) return;
+        for (std::uint32_t idx : order) {
+            const std::vector<BatchVertex>& v = buckets[idx].vertices;
+            std::memcpy(dst, v.data(), v.size() * sizeof(BatchVertex));
+            dst += v.size();
+        }
+        backend.UnmapBuffer(vbo);
+        stats.bytesUploaded = bytes;
+        stats.vertices = total;
+
+        // One draw per bucket; program/texture only rebound when they change.
+        backend.BindVertexArray(vao);
+        const BatchState* bound = nullptr;
+        std::size_t first = writeVertex;
+        for (std::uint32_t idx : order) {
+            const Bucket& b = buckets[idx];
+            if (!bound || b.state.program != bound->program) {
+                backend.UseProgram(b.state.program);
+                ++stats.programChanges;
+            }
+            if (!bound || b.state.texture != bound->texture) {
+                backend.BindTexture(0, b.state.texture);
+                ++stats.textureChanges;
+            }
+            bound = &b.state;
+            backend.DrawArrays(b.state.primitive, first, b.vertices.size());
+            ++stats.drawCalls;
+            first += b.vertices.size();
+        }
+        backend.BindVertexArray(0);
+
+        writeVertex += total;
+    }
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "RenderBackend.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Batched 2D renderer. Everything submitted between Begin() and End() is
+// appended to a per-state bucket (program, texture, primitive, layer), so
+// no per-submission record is kept and nothing is sorted per sprite. End()
+// orders the few buckets by (layer, program, texture, primitive), copies
+// them back to back into a single streaming vertex buffer, and issues one
+// draw call per non-empty bucket.
+//
+// Streaming: each End() maps the next free range of the buffer without
+// synchronization. When the buffer is full it is orphaned (fresh storage,
+// the GPU keeps the old one) and writing restarts at 0, so the CPU never
+// waits for the GPU. A frame larger than the buffer grows it.
+
+namespace Framework {
+
+    // Same position/color layout as Mesh (locations 0 and 1), plus a texture
+    // coordinate at location 2.
+    struct BatchVertex {
+        float x, y, z;
+        float r, g, b;
+        float u, v;
+    };
+
+    // Render state of a submission. Submissions with equal state are drawn
+    // together; lower layers are drawn first.
+    struct BatchState {
+        unsigned program = 0;
+        unsigned texture = 0;              // 0 = untextured
+        Primitive primitive = Primitive::Triangles;
+        int layer = 0;
+    };
+
+    enum class Topology : std::uint8_t {
+        Triangles,
+        TriangleFan,    // converted to triangles on submit
+        Lines,
+    };
+
+    struct BatchStats {
+        std::size_t submissions = 0;
+        std::size_t drawCalls = 0;
+        std::size_t vertices = 0;
+        std::size_t bytesUploaded = 0;
+        std::size_t programChanges = 0;
+        std::size_t textureChanges = 0;
+        std::size_t orphans = 0;
+    };
+
+    class SpriteBatch {
+    public:
+        explicit SpriteBatch(IRenderBackend& backend, std::size_t initialVertices = 64 * 1024);
+        ~SpriteBatch();
+
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+        void Begin();
+
+        // Raw vertices; 'count' must be a multiple of 3 (triangles) or 2 (lines).
+        void Submit(const BatchState& state, const BatchVertex* vertices, std::size_t count);
+
+        // Axis-aligned quad centered at (cx, cy), uv 0..1.
+        void SubmitQuad(const BatchState& state, float cx, float cy, float w, float h,
+            float r, float g, float b);
+
+        // Mesh-style vertices (6 floats: position + color), placed at
+        // (x, y) and scaled by 'scale'. The primitive in 'state' is derived
+        // from 'topology'.
+        void SubmitVertices(BatchState state, const float* vertices6, std::size_t vertexCount,
+            Topology topology, float x = 0.0f, float y = 0.0f, float scale = 1.0f);
+
+        // Same, for indexed meshes: 'indexCount' indices into 'vertices6'.
+        void SubmitIndexed(BatchState state, const float* vertices6, const std::uint32_t* indices,
+            std::size_t indexCount, Topology topology, float x = 0.0f, float y = 0.0f, float scale = 1.0f);
+
+        // Sort, upload and draw everything submitted since Begin().
+        void End();
+
+        // Stats of the last End().
+        const BatchStats& GetStats() const { return stats; }
+        std::size_t GetCapacity() const { return capacity; }
+
+    private:
+        struct Bucket {
+            BatchState state;
+            std::uint64_t sortHi, sortLo;       // (layer, program), (texture, primitive)
+            std::vector<BatchVertex> vertices;  // kept across frames for its capacity
+            bool usedLastFrame = true;
+        };
+
+        std::vector<BatchVertex>& BucketFor(const BatchState& state);
+        void Grow(std::size_t vertices);
+        template <typename Fetch>
+        void Append(BatchState state, Topology topology, std::size_t count, const Fetch& at);
+
+        IRenderBackend& backend;
+        unsigned vbo = 0;
+        unsigned vao = 0;
+        std::size_t capacity = 0;       // vertices
+        std::size_t writeVertex = 0;    // next free vertex in the buffer
+
+        struct KeyHash {
+            std::size_t operator()(const std::pair<std::uint64_t, std::uint64_t>& k) const {
+                return std::hash<std::uint64_t>()(k.first * 0x9E3779B97F4A7C15ull ^ k.second);
+            }
+        };
+
+        std::vector<Bucket> buckets;
+        std::unordered_map<std::pair<std::uint64_t, std::uint64_t>, std::uint32_t, KeyHash> bucketIndex;
+        std::vector<std::uint32_t> order;   // bucket indices, sorted in End()
+        std::size_t lastBucket = 0;         // most submissions repeat the previous state
+        BatchStats stats;
+    };
+
+}
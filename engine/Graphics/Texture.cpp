@@ -1 +1,399 @@
-#include "Graphics/Texture.h"
\ No newline at end of file
+#include "Precompiled.h"
+#include "Graphics/Texture.h"
+#include "GLState.h"
+#include "GL/glew.h"
+#include "GL/gl.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Framework {
+
+    namespace {
+        int AlignUp(int value, int alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Transparent black over a rectangle of every level ('x', 'y', 'width'
+        // and 'height' multiples of 1 << (levels - 1), so each level is exact)
+        void ClearRect(const Texture& texture, int x, int y, int width, int height) {
+            const bool clearTexture = GLEW_VERSION_4_4 || GLEW_ARB_clear_texture;
+            std::vector<unsigned char> zeros;
+            if (!clearTexture) {
+                zeros.resize(static_cast<std::size_t>(width) * height * 4, 0);
+                GLState::BindTexture(0, GL_TEXTURE_2D, texture.GetID());
+            }
+            for (int level = 0; level < texture.GetLevels(); ++level) {
+                const int w = std::max(1, width >> level), h = std::max(1, height >> level);
+                if (clearTexture) {
+                    glClearTexSubImage(texture.GetID(), level, x >> level, y >> level, 0, w, h, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                }
+                else {
+                    glTexSubImage2D(GL_TEXTURE_2D, level, x >> level, y >> level, w, h, GL_RGBA, GL_UNSIGNED_BYTE,
+                        zeros.data());
+                }
+            }
+        }
+
+        // The next mip level down: a 2x2 box filter, odd edges repeat their
+        // last row / column
+        Image Downsample(const Image& src) {
+            Image dst;
+            dst.width = std::max(1, (src.width + 1) / 2);
+            dst.height = std::max(1, (src.height + 1) / 2);
+            dst.pixels.resize(static_cast<std::size_t>(dst.width) * dst.height * 4);
+            for (int y = 0; y < dst.height; ++y) {
+                const int y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+                for (int x = 0; x < dst.width; ++x) {
+                    const int x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+                    const unsigned char* a = &src.pixels[(static_cast<std::size_t>(y0) * src.width + x0) * 4];
+                    const unsigned char* b = &src.pixels[(static_cast<std::size_t>(y0) * src.width + x1) * 4];
+                    const unsigned char* c = &src.pixels[(static_cast<std::size_t>(y1) * src.width + x0) * 4];
+                    const unsigned char* d = &src.pixels[(static_cast<std::size_t>(y1) * src.width + x1) * 4];
+                    unsigned char* out = &dst.pixels[(static_cast<std::size_t>(y) * dst.width + x) * 4];
+                    for (int i = 0; i < 4; ++i) out[i] = static_cast<unsigned char>((a[i] + b[i] + c[i] + d[i] + 2) / 4);
+                }
+            }
+            return dst;
+        }
+    }
+
+    // ===== Texture =====
+
+    int Texture::LevelCount(int width, int height) {
+        int levels = 1;
+        for (int size = std::max(width, height); size > 1; size /= 2) ++levels;
+        return levels;
+    }
+
+    Texture::Texture(int width, int height, int requestedLevels)
+        : width(width), height(height),
+          levels(requestedLevels > 0 ? std::min(requestedLevels, LevelCount(width, height)) : LevelCount(width, height))
+    {
+        assert(levels >= 1);   // glTexStorage2D allocates nothing for 0
+        glGenTextures(1, &id);
+        GLState::BindTexture(0, GL_TEXTURE_2D, id);
+        glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    Texture::~Texture() {
+        GLState::DeleteTexture(id);
+    }
+
+    void Texture::GenerateMipmaps() {
+        if (levels <= 1) return;
+        GLState::BindTexture(0, GL_TEXTURE_2D, id);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    // ===== TextureLoader =====
+
+    TextureLoader::TextureLoader(unsigned workerCount, int atlasSize, int maxAtlasSprite)
+        : workerCount(workerCount), atlasSize(atlasSize),
+          maxAtlasSprite(std::min(maxAtlasSprite, atlasSize - kAtlasBlock))
+    {
+        if (this->workerCount == 0) this->workerCount = DefaultDecodeWorkers();
+    }
+
+    void TextureLoader::StartWorkers() {
+        for (unsigned i = 0; i < workerCount; ++i) {
+            workers.emplace_back(&TextureLoader::WorkerMain, this);
+        }
+    }
+
+    TextureLoader::~TextureLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            jobs.clear();
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+
+        for (Staging& s : staging) {
+            if (s.fence) glDeleteSync(static_cast<GLsync>(s.fence));
+            if (s.buffer) GLState::DeleteBuffer(s.buffer);
+        }
+    }
+
+    void TextureLoader::WorkerMain() {
+        for (;;) {
+            std::pair<TextureId, std::string> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            Decoded result{ job.first, Image{}, false };
+            std::string error;
+            result.ok = LoadImage(job.second, result.image, &error);
+            if (!result.ok) {
+                std::cerr << "TextureLoader: " << job.second << ": " << error << "\n";
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            done.push_back(std::move(result));
+        }
+    }
+
+    TextureLoader::TextureId TextureLoader::Load(const std::string& path, bool allowAtlas) {
+        TextureId id;
+        auto it = byPath.find(path);
+        if (it != byPath.end()) {
+            id = it->second;
+            Entry& entry = entries[id - 1];
+            if (!entry.released) return id;
+            entry.released = false;
+            entry.allowAtlas = allowAtlas;
+            entry.state = TextureState::Pending;
+        }
+        else {
+            Entry entry;
+            entry.path = path;
+            entry.allowAtlas = allowAtlas;
+            entries.push_back(std::move(entry));
+            id = static_cast<TextureId>(entries.size());
+            byPath.emplace(path, id);
+        }
+        ++pending;
+
+        if (workers.empty()) StartWorkers();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.emplace_back(id, path);
+        }
+        wake.notify_one();
+        return id;
+    }
+
+    TextureLoader::TextureId TextureLoader::Insert(const std::string& name, const Image& image, bool allowAtlas) {
+        TextureId id;
+        auto it = byPath.find(name);
+        if (it != byPath.end()) {
+            id = it->second;
+            if (!entries[id - 1].released) return id;
+            entries[id - 1].released = false;
+        }
+        else {
+            Entry entry;
+            entry.path = name;
+            entries.push_back(std::move(entry));
+            id = static_cast<TextureId>(entries.size());
+            byPath.emplace(name, id);
+        }
+
+        Entry& entry = entries[id - 1];
+        entry.allowAtlas = allowAtlas;
+        if (image.width <= 0 || image.height <= 0 || image.pixels.size() < static_cast<std::size_t>(image.width) * image.height * 4) {
+            entry.state = TextureState::Failed;
+            ++stats.failures;
+            return id;
+        }
+        Place(entry, image);
+        return id;
+    }
+
+    void TextureLoader::Release(TextureId id) {
+        if (id == 0 || id > entries.size()) return;
+        Entry& entry = entries[id - 1];
+        if (entry.state == TextureState::Pending || entry.released) return;   // still being decoded / already freed
+
+        // A texture being freed may still sit in the mipmap list
+        if (entry.texture) {
+            dirty.erase(std::remove(dirty.begin(), dirty.end(), entry.texture.get()), dirty.end());
+            entry.texture.reset();
+        }
+        if (entry.cell.page >= 0) {
+            freeCells.push_back(entry.cell);
+            entry.cell = AtlasCell{};
+        }
+        entry.region = TextureRegion{};
+        entry.state = TextureState::Failed;
+        entry.released = true;
+    }
+
+    TextureState TextureLoader::GetState(TextureId id) const {
+        if (id == 0 || id > entries.size()) return TextureState::Failed;
+        return entries[id - 1].state;
+    }
+
+    TextureRegion TextureLoader::GetRegion(TextureId id) const {
+        if (id == 0 || id > entries.size()) return TextureRegion{};
+        return entries[id - 1].region;
+    }
+
+    void TextureLoader::Update(std::size_t budgetBytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Decoded& d : done) ready.push_back(std::move(d));
+            done.clear();
+        }
+
+        std::size_t spent = 0;
+        while (!ready.empty() && (spent == 0 || spent < budgetBytes)) {
+            Decoded d = std::move(ready.front());
+            ready.pop_front();
+            --pending;
+
+            Entry& entry = entries[d.id - 1];
+            if (!d.ok || d.image.width <= 0 || d.image.height <= 0) {
+                entry.state = TextureState::Failed;
+                ++stats.failures;
+                continue;
+            }
+            Place(entry, d.image);
+            spent += d.image.pixels.size();
+        }
+
+        // One mipmap rebuild per touched texture, however many uploads it got
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+        for (Texture* texture : dirty) {
+            texture->GenerateMipmaps();
+            ++stats.mipmapBuilds;
+        }
+        dirty.clear();
+    }
+
+    bool TextureLoader::PackSprite(int width, int height, AtlasCell& cell) {
+        // Whole blocks plus a block of gutter, so every level keeps the
+        // sprite on texels of its own
+        const int cellWidth = AlignUp(width, kAtlasBlock) + kAtlasBlock;
+        const int cellHeight = AlignUp(height, kAtlasBlock) + kAtlasBlock;
+        if (cellWidth > atlasSize || cellHeight > atlasSize) return false;
+
+        // Smallest released cell that fits. It keeps its full size, so it
+        // goes back to the list whole when this sprite is released in turn.
+        auto best = freeCells.end();
+        for (auto it = freeCells.begin(); it != freeCells.end(); ++it) {
+            if (it->width >= cellWidth && it->height >= cellHeight
+                && (best == freeCells.end() || it->width * it->height < best->width * best->height)) {
+                best = it;
+            }
+        }
+        if (best != freeCells.end()) {
+            cell = *best;
+            freeCells.erase(best);
+            ClearRect(*pages[cell.page].texture, cell.x, cell.y, cell.width, cell.height);   // the old sprite
+            ++stats.atlasCellsReused;
+            return true;
+        }
+
+        cell.width = cellWidth;
+        cell.height = cellHeight;
+
+        // First page with room, else a new page
+        for (std::size_t i = 0; i < pages.size(); ++i) {
+            if (pages[i].packer.Pack(cellWidth, cellHeight, cell.x, cell.y)) {
+                cell.page = static_cast<int>(i);
+                return true;
+            }
+        }
+
+        AtlasPage page{ std::make_unique<Texture>(atlasSize, atlasSize, kAtlasLevels), SkylinePacker(atlasSize, atlasSize) };
+        if (!page.packer.Pack(cellWidth, cellHeight, cell.x, cell.y)) return false;
+        ClearRect(*page.texture, 0, 0, atlasSize, atlasSize);   // storage starts undefined; gutters must be transparent
+
+        pages.push_back(std::move(page));
+        cell.page = static_cast<int>(pages.size()) - 1;
+        ++stats.atlasPages;
+        return true;
+    }
+
+    void TextureLoader::Place(Entry& entry, const Image& image) {
+        TextureRegion& region = entry.region;
+        region.width = image.width;
+        region.height = image.height;
+
+        AtlasCell cell;
+        const bool small = image.width <= maxAtlasSprite && image.height <= maxAtlasSprite;
+        if (entry.allowAtlas && small && PackSprite(image.width, image.height, cell)) {
+            // Cells are block aligned, so level l starts exactly at (x >> l, y >> l)
+            Texture& page = *pages[cell.page].texture;
+            Upload(page, 0, cell.x, cell.y, image);
+            Image level = image;
+            for (int l = 1; l < page.GetLevels(); ++l) {
+                level = Downsample(level);
+                Upload(page, l, cell.x >> l, cell.y >> l, level);
+            }
+
+            const float size = static_cast<float>(atlasSize);
+            entry.cell = cell;
+            region.texture = page.GetID();
+            region.u0 = cell.x / size;
+            region.v0 = cell.y / size;
+            region.u1 = (cell.x + image.width) / size;
+            region.v1 = (cell.y + image.height) / size;
+            ++stats.atlasSprites;
+        }
+        else {
+            // Too big, not allowed in the atlas, or no page could take it
+            entry.texture = std::make_unique<Texture>(image.width, image.height);
+            Upload(*entry.texture, 0, 0, 0, image);
+            dirty.push_back(entry.texture.get());
+            region.texture = entry.texture->GetID();
+        }
+        entry.state = TextureState::Ready;
+    }
+
+    void TextureLoader::Upload(Texture& texture, int level, int x, int y, const Image& image) {
+        const std::size_t bytes = image.pixels.size();
+
+        // Lower levels are a third of the bytes at most: straight from memory,
+        // so a sprite's chain does not cycle the staging ring onto a fresh fence
+        if (level > 0) {
+            GLState::BindTexture(0, GL_TEXTURE_2D, texture.GetID());
+            glTexSubImage2D(GL_TEXTURE_2D, level, x, y, image.width, image.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                image.pixels.data());
+            ++stats.uploads;
+            stats.bytesUploaded += bytes;
+            return;
+        }
+
+        // With three buffers in rotation the GPU is normally long done with this one
+        Staging& s = staging[nextStaging];
+        nextStaging = (nextStaging + 1) % kStagingBuffers;
+        if (s.fence) {
+            if (GLState::WaitAndDeleteFence(s.fence)) ++stats.stagingWaits;
+            s.fence = nullptr;
+        }
+
+        if (!s.buffer) glGenBuffers(1, &s.buffer);
+        GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, s.buffer);
+        if (bytes > s.capacity) {
+            s.capacity = std::max(bytes, s.capacity * 2);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, s.capacity, nullptr, GL_STREAM_DRAW);
+        }
+
+        // The fence above says the GPU is done reading: no driver sync needed
+        void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            std::memcpy(dst, image.pixels.data(), bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+            GLState::BindTexture(0, GL_TEXTURE_2D, texture.GetID());
+            glTexSubImage2D(GL_TEXTURE_2D, level, x, y, image.width, image.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);   // client-memory uploads elsewhere expect none
+
+        if (!dst) {
+            // Mapping failed; upload straight from memory instead
+            GLState::BindTexture(0, GL_TEXTURE_2D, texture.GetID());
+            glTexSubImage2D(GL_TEXTURE_2D, level, x, y, image.width, image.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                image.pixels.data());
+        }
+
+        ++stats.uploads;
+        stats.bytesUploaded += bytes;
+    }
+
+}
@@ -1 +1,199 @@
 #pragma once
+#include "AtlasPacker.h"
+#include "Image.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Texture subsystem.
+//
+// TextureLoader::Load() queues a file for decoding on worker threads
+// (LoadImage, always RGBA8) and returns an id at once. Update(), called
+// once per frame on the GL thread, uploads whatever has been decoded:
+//   - Small images (up to maxAtlasSprite on both sides) are packed into
+//     shared atlas pages with a SkylinePacker, so sprites from many files
+//     share one texture and batch into one draw.
+//   - Larger images get a texture of their own.
+// Uploads go through a ring of pixel-unpack buffers guarded by fences: the
+// copy into the buffer never waits on the GPU, and glTexSubImage2D reads
+// from the buffer asynchronously. A per-frame byte budget spreads a burst
+// of loads over several frames.
+//
+// Mipmaps: atlas pages have a short chain (kAtlasLevels). Sprites sit on
+// kAtlasBlock-aligned cells with a kAtlasBlock gutter, so at every level a
+// sprite covers whole texels of its own and never blends with its
+// neighbours; each sprite's levels are box-filtered on the CPU and
+// uploaded to its own rectangle, so placing a sprite never rebuilds the
+// page. Standalone textures rebuild their full chain once at the end of
+// Update().
+//
+// Until an image is ready its region is empty (texture 0).
+
+namespace Framework {
+
+    // Immutable RGBA8 2D texture with a full mip chain (or one level).
+    class Texture {
+    public:
+        // 'requestedLevels' 0 = the full mip chain; more than the full chain
+        // is clamped to it.
+        Texture(int width, int height, int requestedLevels = 0);
+        ~Texture();
+
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        unsigned GetID() const { return id; }
+        int GetWidth() const { return width; }
+        int GetHeight() const { return height; }
+        int GetLevels() const { return levels; }
+
+        // Rebuild levels 1.. from level 0.
+        void GenerateMipmaps();
+
+        static int LevelCount(int width, int height);
+
+    private:
+        unsigned id = 0;
+        int width, height, levels;
+    };
+
+    // Where an image ended up: a texture and the uv rectangle inside it.
+    struct TextureRegion {
+        unsigned texture = 0;
+        float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+        int width = 0, height = 0;
+    };
+
+    enum class TextureState : std::uint8_t {
+        Pending,
+        Ready,
+        Failed,
+    };
+
+    struct TextureLoaderStats {
+        std::size_t uploads = 0;
+        std::size_t bytesUploaded = 0;
+        std::size_t stagingWaits = 0;     // uploads that waited on a staging buffer fence (should stay 0)
+        std::size_t mipmapBuilds = 0;
+        std::size_t atlasPages = 0;
+        std::size_t atlasSprites = 0;
+        std::size_t atlasCellsReused = 0;   // sprites placed in a released cell
+        std::size_t failures = 0;
+    };
+
+    class TextureLoader {
+    public:
+        using TextureId = std::uint32_t;   // 0 = invalid
+
+        // 'workers' 0 picks one per spare core (at most 4). Workers start
+        // with the first Load().
+        explicit TextureLoader(unsigned workers = 0, int atlasSize = 2048, int maxAtlasSprite = 256);
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        // Queue 'path' for loading. Loading the same path again returns
+        // the same id. 'allowAtlas' false always gives the image its own
+        // texture (e.g. for wrapping). GL thread.
+        TextureId Load(const std::string& path, bool allowAtlas = true);
+
+        // Upload an image decoded elsewhere right away. 'name' works like a
+        // path for sharing. GL thread.
+        TextureId Insert(const std::string& name, const Image& image, bool allowAtlas = true);
+
+        // Free an image: its own texture is deleted, its atlas cell goes to
+        // a free list that later sprites are packed into first. The id
+        // stays reserved for the name, so loading it again reuses the id
+        // rather than growing the table. GL thread.
+        void Release(TextureId id);
+
+        TextureState GetState(TextureId id) const;
+        TextureRegion GetRegion(TextureId id) const;
+
+        // Upload decoded images, about 'budgetBytes' per call (at least one
+        // image). GL thread, once per frame.
+        void Update(std::size_t budgetBytes = 8u << 20);
+
+        // Images queued or decoded but not yet uploaded.
+        std::size_t GetPendingCount() const { return pending; }
+
+        const TextureLoaderStats& GetStats() const { return stats; }
+
+    private:
+        // A block-aligned rectangle of an atlas page, gutter included
+        struct AtlasCell {
+            int page = -1;
+            int x = 0, y = 0, width = 0, height = 0;
+        };
+
+        struct Entry {
+            std::string path;
+            bool allowAtlas = true;
+            bool released = false;              // freed; the id waits for its name to come back
+            TextureState state = TextureState::Pending;
+            TextureRegion region;
+            std::unique_ptr<Texture> texture;   // own texture when not atlased
+            AtlasCell cell;                     // when atlased
+        };
+
+        struct Decoded {
+            TextureId id;
+            Image image;
+            bool ok;
+        };
+
+        struct AtlasPage {
+            std::unique_ptr<Texture> texture;
+            SkylinePacker packer;
+        };
+
+        // Pixel-unpack buffers the uploads go through, reused round-robin
+        struct Staging {
+            unsigned buffer = 0;
+            std::size_t capacity = 0;
+            void* fence = nullptr;              // GLsync of the last upload from it
+        };
+        static constexpr int kStagingBuffers = 3;
+
+        void StartWorkers();
+        void WorkerMain();
+        void Place(Entry& entry, const Image& image);
+        bool PackSprite(int width, int height, AtlasCell& cell);
+        void Upload(Texture& texture, int level, int x, int y, const Image& image);
+
+        std::vector<Entry> entries;             // index = id - 1
+        std::unordered_map<std::string, TextureId> byPath;
+        std::size_t pending = 0;
+
+        // Worker side, guarded by 'mutex'
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::pair<TextureId, std::string>> jobs;
+        std::vector<Decoded> done;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+        unsigned workerCount;
+
+        std::deque<Decoded> ready;              // decoded, waiting for upload budget
+
+        std::vector<AtlasPage> pages;
+        std::vector<AtlasCell> freeCells;       // released, cleared on reuse
+        int atlasSize, maxAtlasSprite;
+        static constexpr int kAtlasLevels = 4;
+        static constexpr int kAtlasBlock = 1 << (kAtlasLevels - 1);   // one texel at the smallest level
+
+        Staging staging[kStagingBuffers];
+        int nextStaging = 0;
+        std::vector<Texture*> dirty;            // standalone textures that need mipmaps rebuilt
+
+        TextureLoaderStats stats;
+    };
+
+}
@@ -0,0 +1,34 @@
+#include "UniformBuffer.h"
+#include "GLState.h"
+#include "GL/glew.h"
+#include "GL/gl.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Framework {
+
+    UniformBuffer::UniformBuffer(std::size_t bytes, unsigned binding)
+        : binding(binding), shadow(bytes, 0)
+    {
+        glCreateBuffers(1, &id);
+        glNamedBufferData(id, static_cast<GLsizeiptr>(bytes), shadow.data(), GL_DYNAMIC_DRAW);
+        Bind();
+    }
+
+    UniformBuffer::~UniformBuffer() {
+        GLState::DeleteBuffer(id);
+    }
+
+    void UniformBuffer::Update(const void* data, std::size_t bytes) {
+        bytes = std::min(bytes, shadow.size());
+        if (std::memcmp(shadow.data(), data, bytes) == 0) return;
+
+        std::memcpy(shadow.data(), data, bytes);
+        glNamedBufferSubData(id, 0, static_cast<GLsizeiptr>(bytes), data);
+    }
+
+    void UniformBuffer::Bind() const {
+        GLState::BindBufferBase(GL_UNIFORM_BUFFER, binding, id);
+    }
+
+}
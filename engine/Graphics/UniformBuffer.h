@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Framework {
+
+    // Per-frame data shared by every program, std140 layout. Matches
+    //   layout(std140, binding = 0) uniform FrameData { mat4 uViewProj; vec4 uTime; };
+    // in the shaders. Keep members vec4/mat4-sized so C++ and std140 agree.
+    struct FrameData {
+        glm::mat4 viewProj = glm::mat4(1.0f);
+        glm::vec4 time = glm::vec4(0.0f);     // x = seconds since start, y = frame dt
+    };
+    static_assert(sizeof(FrameData) == 80, "FrameData must match the std140 FrameData block");
+
+    constexpr unsigned kFrameDataBinding = 0;
+
+    // Uniform buffer bound to a fixed binding point. Update() uploads only
+    // when the bytes differ from the last upload, so setting the same frame
+    // data again costs a memcmp, not a buffer write.
+    class UniformBuffer {
+    public:
+        UniformBuffer(std::size_t bytes, unsigned binding);
+        ~UniformBuffer();
+
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+        void Update(const void* data, std::size_t bytes);
+        template <typename T> void Update(const T& data) { Update(&data, sizeof(T)); }
+
+        // Re-attach to the binding point (after something else used it).
+        void Bind() const;
+
+        unsigned GetID() const { return id; }
+        unsigned GetBinding() const { return binding; }
+
+    private:
+        unsigned id = 0;
+        unsigned binding;
+        std::vector<unsigned char> shadow;    // last uploaded contents
+    };
+
+}
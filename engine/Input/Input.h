@@ -39,6 +39,7 @@ namespace Framework
         virtual void Initialize() override;
         virtual void Update(float dt) override;
         virtual void SendEngineMessage(Message* message) override;
+        virtual const char* GetName() const override { return "Input"; }
 
         // Input query functions
         bool IsKeyDown(KeyCode key);
@@ -10,4 +10,7 @@ public:
     virtual void Initialize() = 0;
     virtual void Update(float dt) = 0;
     virtual void SendEngineMessage(Message* message) = 0;
+
+    // Display name, also used as this system's profiling category.
+    virtual const char* GetName() const { return "Other"; }
 };
\ No newline at end of file
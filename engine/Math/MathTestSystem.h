@@ -20,6 +20,7 @@ namespace Framework {
         // These methods are required but will be empty for this test system.
         virtual void Update(float dt) override;
         virtual void SendEngineMessage(Message* message) override;
+        virtual const char* GetName() const override { return "MathTest"; }
     };
 
 } // namespace Framework
\ No newline at end of file
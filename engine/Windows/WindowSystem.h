@@ -15,6 +15,7 @@ namespace Framework {
         virtual void Initialize() override;
         virtual void Update(float dt) override;
         virtual void SendEngineMessage(Message* message) override;
+        virtual const char* GetName() const override { return "Window"; }
 
         GLFWwindow* GetWindow() const { return window; }
         bool ShouldClose() const;
@@ -1,10 +1,18 @@
 #include "Precompiled.h"
 #include "Core.h"
+#include <cstdlib>
+#include <cstring>
 
 #include "DebugComponents/Log.h"
 #include "DebugComponents/Sinks.h"
 #include "DebugComponents/CrashLogger.h"
 #include "DebugComponents/PerfViewer.h"
+#include "DebugComponents/Tsc.h"
+#include "DebugComponents/HwCounters.h"
+#include "DebugComponents/Telemetry.h"
+#include "DebugComponents/Watchdog.h"
+#include "ProgramCache.h"
+#include "PackFile.h"
 
 int WINAPI WinMain(    _In_ HINSTANCE hInstance,
     _In_opt_ HINSTANCE hPrevInstance,
@@ -21,6 +29,9 @@ int WINAPI WinMain(    _In_ HINSTANCE hInstance,
 
     std::cout << "Starting Game Engine...\n";
 
+    // Build every program in shaders/programs.txt into the binary cache and exit
+    const bool precompileShaders = lpCmdLine && std::strstr(lpCmdLine, "--precompile-shaders") != nullptr;
+
     // ------------ Debug tools bootstrap ------------//
     eng::debug::LogConfig logCfg;
     logCfg.level = eng::debug::LogLevel::Info;
@@ -29,11 +40,40 @@ int WINAPI WinMain(    _In_ HINSTANCE hInstance,
     logCfg.useFile = true;
     logCfg.usePlatformOutput = true;
     logCfg.showSourceInfo = false;
+    if (const char* tags = std::getenv("STRUCTSQUAD_LOG_TAGS")) logCfg.tagLevels = tags; // e.g. "PERF=Debug"
     eng::debug::Log::init(logCfg);
+    eng::debug::TscClock::calibrate();
+    eng::debug::HwCounters::enable();   // main thread; no-op where unsupported
     eng::debug::PerfViewer::set_print_interval(1.0);
     eng::debug::CrashLogger::install_handlers();
+
+    // Live perf stream for headless soak runs (opt-in via environment).
+    eng::debug::TelemetryConfig telemetryCfg;
+    telemetryCfg.enabled = std::getenv("STRUCTSQUAD_TELEMETRY") != nullptr;
+    eng::debug::Telemetry::start(telemetryCfg);
+
+    // Hung-frame detection; STRUCTSQUAD_WATCHDOG_MS overrides the threshold, 0 disables it.
+    eng::debug::WatchdogConfig watchdogCfg;
+    if (const char* ms = std::getenv("STRUCTSQUAD_WATCHDOG_MS")) watchdogCfg.hangMs = static_cast<unsigned>(std::strtoul(ms, nullptr, 10));
+    watchdogCfg.enabled = watchdogCfg.hangMs > 0;
+    eng::debug::Watchdog::start(watchdogCfg);
     // --------- End Of Debug tools bootstrap ---------//
 
+    // Packed assets (built by the pack_data target). Without data.pak every
+    // loader reads the loose shaders/ and assets/ folders instead. Debug
+    // builds leave it unmounted: pack_data only runs when asked, so an old
+    // data.pak would hide every later edit to those folders.
+    // STRUCTSQUAD_PACK=1 / =0 overrides this either way.
+#ifdef _DEBUG
+    bool mountPack = false;
+#else
+    bool mountPack = true;
+#endif
+    if (const char* pack = std::getenv("STRUCTSQUAD_PACK")) mountPack = std::string(pack) != "0";
+    if (mountPack && Framework::PackFile::Mount("data.pak")) {
+        std::cout << "Mounted data.pak\n";
+    }
+
     // Create the core engine
     Framework::CoreEngine engine;
 
@@ -55,19 +95,27 @@ int WINAPI WinMain(    _In_ HINSTANCE hInstance,
     // Initialize all systems
     engine.Initialize();
 
-    std::cout << "Engine initialized. Starting game loop...\n";
+    if (precompileShaders) {
+        Framework::ProgramCache::Precompile("shaders");
+    }
+    else {
+        std::cout << "Engine initialized. Starting game loop...\n";
 
-    // Run the main game loop
-    engine.GameLoop();
+        // Run the main game loop
+        engine.GameLoop();
+    }
 
     std::cout << "Game loop ended. Cleaning up...\n";
 
     // Cleanup systems
     engine.DestroySystems();
+    Framework::PackFile::UnmountAll();
 
     std::cout << "Engine shutdown complete.\n";
 
     // Shutdown debug tools
+    eng::debug::Watchdog::stop();
+    eng::debug::Telemetry::stop();
     eng::debug::Log::shutdown();
 #ifdef _DEBUG
     std::cout << "Press Enter to close console...\n";
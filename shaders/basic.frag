@@ -3,6 +3,8 @@
 in vec3 vertexColor;
 out vec4 FragColor;
 
+uniform vec3 uColor = vec3(1.0);  // tint, set per draw
+
 void main() {
-    FragColor = vec4(vertexColor, 1.0);  // Use interpolated color
-}
\ No newline at end of file
+    FragColor = vec4(vertexColor * uColor, 1.0);  // Use interpolated color
+}
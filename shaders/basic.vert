@@ -3,9 +3,15 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aColor;
 
+// Shared per-frame data, see FrameData in UniformBuffer.h
+layout(std140, binding = 0) uniform FrameData {
+    mat4 uViewProj;
+    vec4 uTime;
+};
+
 out vec3 vertexColor; // passed to fragment shader
 
 void main() {
-    gl_Position = vec4(aPos, 1.0);
+    gl_Position = uViewProj * vec4(aPos, 1.0);
     vertexColor = aColor;  // Pass color along
 }
@@ -0,0 +1,28 @@
+#version 450 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aColor;
+
+// Per instance (divisor 1), see MeshInstance in Mesh.h
+layout(location = 2) in vec2 aOffset;
+layout(location = 3) in vec2 aScale;
+layout(location = 4) in float aRotation;
+layout(location = 5) in vec3 aTint;
+
+// Shared per-frame data, see FrameData in UniformBuffer.h
+layout(std140, binding = 0) uniform FrameData {
+    mat4 uViewProj;
+    vec4 uTime;
+};
+
+out vec3 vertexColor; // passed to fragment shader
+
+void main() {
+    float c = cos(aRotation);
+    float s = sin(aRotation);
+    vec2 p = aPos.xy * aScale;
+    p = vec2(c * p.x - s * p.y, s * p.x + c * p.y) + aOffset;
+
+    gl_Position = uViewProj * vec4(p, aPos.z, 1.0);
+    vertexColor = aColor * aTint;
+}
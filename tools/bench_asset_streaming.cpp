@@ -0,0 +1,217 @@
+#include "Graphics/AssetManager.h"
+#include "Graphics/RecordingAssetUploader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/*
+===============================================================================
+ bench_asset_streaming.cpp
+ ------------------------------------------------------------------------------
+ Headless check of AssetManager against the recording uploader (no GPU).
+
+ Writes N small TGA images and an OBJ quad to a temporary directory
+ and streams them through a real AssetManager (workers, stb_image,
+ ObjLoader); only the GPU side is replaced by RecordingAssetUploader.
+ Checks that
+   - no worker thread starts before the first load,
+   - loading a path twice shares one load and one GPU object,
+   - decoded assets upload highest priority first, also after a raise,
+   - Update() stops at its byte budget (but always uploads one asset),
+   - an asset is freed once its last handle goes, and not before,
+   - a load dropped before it finishes never creates a GPU object,
+   - a missing file fails, and loads once it exists and is asked for again.
+ Then times a burst of N loads streamed in at the default 4 MB budget.
+ Exit code 1 if a check fails. The load error printed for late.tga is
+ part of the failure check.
+
+ Usage
+   bench_asset_streaming [count] [size]   (default 256 images of 64 x 64)
+===============================================================================
+*/
+
+namespace {
+
+	using namespace Framework;
+	using Clock = std::chrono::steady_clock;
+
+	// Uncompressed 32-bit TGA, every pixel 'value'
+	bool write_tga(const std::string& path, int width, int height, unsigned char value) {
+		std::FILE* f = std::fopen(path.c_str(), "wb");
+		if (!f) return false;
+		const unsigned char header[18] = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+			static_cast<unsigned char>(width), static_cast<unsigned char>(width >> 8),
+			static_cast<unsigned char>(height), static_cast<unsigned char>(height >> 8), 32, 8 };
+		std::fwrite(header, 1, sizeof(header), f);
+		const std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height * 4, value);
+		std::fwrite(pixels.data(), 1, pixels.size(), f);
+		return std::fclose(f) == 0;
+	}
+
+	bool write_quad(const std::string& path) {
+		std::FILE* f = std::fopen(path.c_str(), "wb");
+		if (!f) return false;
+		std::fprintf(f, "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3//1 4//1\n");
+		return std::fclose(f) == 0;
+	}
+
+	// Names of the objects the uploader created, in creation order
+	std::vector<std::string> created_names(const RecordingAssetUploader& uploader, std::size_t from) {
+		std::vector<std::string> names;
+		for (std::size_t i = from; i < uploader.GetObjects().size(); ++i) names.push_back(uploader.GetObjects()[i].name);
+		return names;
+	}
+
+	std::size_t live_named(const RecordingAssetUploader& uploader, const std::string& name) {
+		std::size_t live = 0;
+		for (const RecordingAssetUploader::Object& o : uploader.GetObjects()) live += (o.alive && o.name == name) ? 1 : 0;
+		return live;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const int count = (argc > 1) ? std::max(8, std::atoi(argv[1])) : 256;
+	const int size = (argc > 2) ? std::clamp(std::atoi(argv[2]), 1, 1024) : 64;
+	const std::size_t imageBytes = static_cast<std::size_t>(size) * size * 4;
+
+	int failures = 0;
+	auto fail = [&](const char* what) { std::printf("CHECK FAILED: %s\n", what); ++failures; };
+
+	namespace fs = std::filesystem;
+	const fs::path dir = fs::temp_directory_path() / "bench_asset_streaming";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+	std::vector<std::string> images;
+	for (int i = 0; i < count; ++i) {
+		images.push_back((dir / ("image" + std::to_string(i) + ".tga")).string());
+		if (!write_tga(images.back(), size, size, static_cast<unsigned char>(i))) {
+			std::printf("cannot write %s\n", images.back().c_str());
+			return 1;
+		}
+	}
+	const std::string quad = (dir / "quad.obj").string();
+	const std::string late = (dir / "late.tga").string();
+	if (!write_quad(quad)) {
+		std::printf("cannot write %s\n", quad.c_str());
+		return 1;
+	}
+	ObjLoader::SetCacheDirectory((dir / "cache").string());
+
+	RecordingAssetUploader uploader;
+	{
+		AssetManager assets(uploader, 2);
+		if (assets.GetWorkerCount() != 0) fail("no workers before the first load");
+
+		// Sharing: one load, one object
+		AssetHandle a = assets.LoadTexture(images[0]);
+		AssetHandle b = assets.LoadTexture(images[0]);
+		AssetHandle mesh = assets.LoadMesh(quad);
+		if (assets.GetWorkerCount() != 2) fail("workers start with the first load");
+		assets.WaitForDecodes();
+		assets.Update();
+		if (!a.IsReady() || !b.IsReady() || !mesh.IsReady()) fail("texture and mesh ready after one Update");
+		if (live_named(uploader, images[0]) != 1) fail("a path loaded twice shares one object");
+		if (a.GetTexture().texture == 0 || a.GetTexture().texture != b.GetTexture().texture) fail("both handles see the same texture");
+		if (a.GetMesh() != nullptr || mesh.GetTexture().texture != 0) fail("no mesh from a texture handle and no texture from a mesh handle");
+
+		// Reference counting: freed at the Update() after the last handle
+		a.Reset();
+		assets.Update();
+		if (live_named(uploader, images[0]) != 1) fail("kept while a handle remains");
+		b.Reset();
+		if (live_named(uploader, images[0]) != 1) fail("freed at Update(), not on Reset()");
+		assets.Update();
+		if (live_named(uploader, images[0]) != 0) fail("freed once the last handle goes");
+
+		// Priority: everything decoded first, then one upload per Update()
+		std::size_t first = uploader.GetObjects().size();
+		std::vector<AssetHandle> handles;
+		handles.push_back(assets.LoadTexture(images[1], AssetPriority::Low));
+		handles.push_back(assets.LoadTexture(images[2], AssetPriority::Normal));
+		handles.push_back(assets.LoadTexture(images[3], AssetPriority::High));
+		handles.push_back(assets.LoadTexture(images[4], AssetPriority::Low));
+		handles.push_back(assets.LoadTexture(images[4], AssetPriority::High));   // raised while queued
+		assets.WaitForDecodes();
+		for (int i = 0; i < 4; ++i) assets.Update(0);
+		const std::vector<std::string> order = created_names(uploader, first);
+		const std::vector<std::string> expected = { images[3], images[4], images[2], images[1] };
+		if (order != expected) fail("uploads in priority order");
+		handles.clear();
+		assets.Update();
+
+		// Byte budget: uploads stop once the budget is reached
+		first = uploader.GetObjects().size();
+		for (int i = 1; i <= 4; ++i) handles.push_back(assets.LoadTexture(images[i]));
+		assets.WaitForDecodes();
+		assets.Update(imageBytes + imageBytes / 2);
+		if (assets.GetStats().uploadsThisFrame != 2 || assets.GetStats().decoded != 2) fail("two uploads for a budget of 1.5 images");
+		assets.Update(1);
+		if (assets.GetStats().uploadsThisFrame != 1) fail("one upload even when it exceeds the budget");
+		assets.Update();
+		if (uploader.GetObjects().size() - first != 4) fail("all four uploaded in the end");
+		handles.clear();
+		assets.Update();
+
+		// Cancel: a load dropped before Update() never reaches the uploader
+		first = uploader.GetObjects().size();
+		assets.LoadTexture(images[5]).Reset();
+		assets.LoadTexture(images[6], AssetPriority::Low);   // handle dropped at once
+		assets.WaitForDecodes();
+		assets.Update();
+		assets.Update();
+		if (uploader.GetObjects().size() != first) fail("dropped loads create no GPU object");
+
+		// Failure, then a retry once the file exists
+		AssetHandle missing = assets.LoadTexture(late);
+		assets.WaitForDecodes();
+		assets.Update();
+		if (missing.GetState() != AssetState::Failed || assets.GetStats().failures != 1) fail("missing file fails");
+		if (!write_tga(late, size, size, 7)) fail("write the late file");
+		AssetHandle retry = assets.LoadTexture(late);
+		assets.WaitForDecodes();
+		assets.Update();
+		if (!missing.IsReady() || !retry.IsReady()) fail("failed path loads when asked for again");
+		missing.Reset();
+		retry.Reset();
+		mesh.Reset();
+		assets.Update();
+		if (uploader.GetLiveCount() != 0) fail("nothing left alive once every handle is gone");
+
+		// Timing: a burst of loads streamed in at the default budget
+		first = uploader.GetObjects().size();
+		const auto t0 = Clock::now();
+		for (const std::string& image : images) handles.push_back(assets.LoadTexture(image));
+		const double queueMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+		int frames = 0;
+		std::size_t maxUploads = 0;
+		while (!std::all_of(handles.begin(), handles.end(), [](const AssetHandle& h) { return h.IsReady(); }) && frames < 100000) {
+			assets.Update();
+			maxUploads = std::max(maxUploads, assets.GetStats().uploadsThisFrame);
+			++frames;
+		}
+		const double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+		if (uploader.GetObjects().size() - first != images.size()) fail("burst: one object per image");
+		if (maxUploads > std::max<std::size_t>(1, ((4u << 20) + imageBytes - 1) / imageBytes)) fail("burst: no frame over budget");
+
+		std::printf("bench_asset_streaming: %d images of %d x %d (%.1f KB each), %zu workers\n", count, size, size,
+			imageBytes / 1024.0, assets.GetWorkerCount());
+		std::printf("  queue all loads     : %8.3f ms\n", queueMs);
+		std::printf("  all ready           : %8.2f ms over %d Update() calls (at most %zu uploads in one)\n",
+			totalMs, frames, maxUploads);
+		handles.clear();
+		a = assets.LoadTexture(images[0]);
+		assets.WaitForDecodes();
+		assets.Update();
+	}
+	if (uploader.GetLiveCount() != 0) fail("the manager frees what is still loaded when it goes");
+
+	fs::remove_all(dir);
+	std::printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
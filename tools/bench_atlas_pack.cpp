@@ -0,0 +1,115 @@
+#include "Graphics/AtlasPacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/*
+===============================================================================
+ bench_atlas_pack.cpp
+ ------------------------------------------------------------------------------
+ Headless check and benchmark for SkylinePacker (the atlas packer used by
+ TextureLoader).
+
+ Packs N pseudo-random sprite sizes (mostly small, a few up to 256 px) into
+ as many size x size pages as needed, in load order, the way TextureLoader
+ does at runtime: each sprite takes a cell rounded up to 8-texel blocks plus
+ one block of gutter, so its 4-level mip chain stays on texels of its own.
+ Reports pages used, mean occupancy (of cells) and time per sprite.
+ Checks that
+   - every cell lands inside its page, on a block boundary,
+   - no two sprites on a page overlap,
+   - a sprite never fails on a fresh page.
+ Exit code 1 if a check fails.
+
+ Usage
+   bench_atlas_pack [sprites] [page size]   (default 5,000 / 2048)
+===============================================================================
+*/
+
+namespace {
+
+	using namespace Framework;
+	using Clock = std::chrono::steady_clock;
+
+	std::uint32_t xorshift(std::uint32_t& s) {
+		s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+		return s;
+	}
+
+	struct Rect {
+		int page, x, y, w, h;
+	};
+
+	constexpr int kBlock = 8;   // TextureLoader::kAtlasBlock
+
+	int cell(int side) {
+		return (side + kBlock - 1) / kBlock * kBlock + kBlock;
+	}
+
+	bool overlap(const Rect& a, const Rect& b) {
+		return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const int n = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 5000;
+	const int size = (argc > 2) ? std::max(16, std::atoi(argv[2])) : 2048;
+
+	int failures = 0;
+	auto fail = [&](const char* what) { std::printf("CHECK FAILED: %s\n", what); ++failures; };
+
+	std::vector<Rect> sizes(n);
+	std::uint32_t s = 0x9E3779B9u;
+	for (Rect& r : sizes) {
+		const bool large = xorshift(s) % 20 == 0;
+		const int maxSide = std::min(large ? 256 : 64, size);
+		r.w = 4 + static_cast<int>(xorshift(s) % (maxSide - 3));
+		r.h = 4 + static_cast<int>(xorshift(s) % (maxSide - 3));
+	}
+
+	std::vector<SkylinePacker> pages;
+	std::vector<Rect> placed;
+	placed.reserve(n);
+	const auto t0 = Clock::now();
+	for (const Rect& r : sizes) {
+		const int w = cell(r.w), h = cell(r.h);
+		int x = 0, y = 0, page = 0;
+		for (; page < static_cast<int>(pages.size()); ++page) {
+			if (pages[page].Pack(w, h, x, y)) break;
+		}
+		if (page == static_cast<int>(pages.size())) {
+			pages.emplace_back(size, size);
+			if (!pages.back().Pack(w, h, x, y)) { fail("sprite fits a fresh page"); continue; }
+		}
+		placed.push_back({ page, x, y, w, h });
+	}
+	const double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+
+	bool inside = true, disjoint = true;
+	for (std::size_t i = 0; i < placed.size(); ++i) {
+		const Rect& a = placed[i];
+		if (a.x < 0 || a.y < 0 || a.x + a.w > size || a.y + a.h > size) inside = false;
+		if (a.x % kBlock != 0 || a.y % kBlock != 0) inside = false;
+		for (std::size_t j = i + 1; j < placed.size() && disjoint; ++j) {
+			if (placed[j].page == a.page && overlap(a, placed[j])) disjoint = false;
+		}
+	}
+	if (!inside) fail("cells inside their page, block aligned");
+	if (!disjoint) fail("sprites do not overlap");
+
+	double occupancy = 0.0;
+	for (std::size_t p = 0; p + 1 < pages.size(); ++p) occupancy += pages[p].GetOccupancy();
+	const std::size_t full = pages.size() > 1 ? pages.size() - 1 : 1;
+	if (pages.size() == 1) occupancy = pages[0].GetOccupancy();
+
+	std::printf("bench_atlas_pack: %d sprites into %zu page(s) of %dx%d\n", n, pages.size(), size, size);
+	std::printf("  occupancy (full pages) : %.1f %%\n", 100.0 * occupancy / full);
+	std::printf("  pack time              : %.3f us per sprite\n", us / n);
+
+	std::printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
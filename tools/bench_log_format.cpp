@@ -0,0 +1,166 @@
+#include "DebugComponents/Log.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <sstream>
+
+/*
+===============================================================================
+ bench_log_format.cpp
+ ------------------------------------------------------------------------------
+ Compares the cost of one log line through:
+   - legacy path : the previous Log::writef implementation (2 KB stack
+				   buffer -> std::ostringstream + time_now_str() with its own
+				   ostringstream and localtime per line), reproduced here.
+   - current path: Log::writef (per-thread buffer, cached seconds,
+				   string_view to sinks).
+
+ Both paths end in the same NullSink, so only formatting is measured, not
+ I/O. The global operator new is counted to show allocations per line.
+
+ Two messages are measured: a plain one (isolates the per-line overhead of
+ the Log facade) and a numeric one (adds the vsnprintf cost of %f/%ld,
+ which both paths share). The numeric one is also sent as key/value fields
+ (Log::write_kv), which formats the numbers with to_chars instead.
+
+ Usage
+   bench_log_format [lines]       (default 200,000)
+===============================================================================
+*/
+
+namespace {
+
+	std::atomic<unsigned long long> g_allocs{ 0 };
+
+	// Sink that only touches the line, so the work cannot be optimized away.
+	struct NullSink final : eng::debug::ILogSink {
+		unsigned long long bytes = 0;
+		void write(eng::debug::LogLevel, const char*, std::string_view msg) override { bytes += msg.size(); }
+	};
+
+	// ---- legacy path (as it was before the per-thread buffer) ----
+	std::string legacy_time_now_str() {
+		using namespace std::chrono;
+		auto now = system_clock::now();
+		auto t = system_clock::to_time_t(now);
+		auto ms = duration_cast<milliseconds>(now.time_since_epoch()).count() % 1000;
+		std::tm tm{};
+	#if defined(_WIN32)
+		localtime_s(&tm, &t);
+	#else
+		localtime_r(&t, &tm);
+	#endif
+		std::ostringstream oss;
+		oss << std::setfill('0')
+			<< std::setw(2) << tm.tm_hour << ":"
+			<< std::setw(2) << tm.tm_min << ":"
+			<< std::setw(2) << tm.tm_sec << "."
+			<< std::setw(3) << ms;
+		return oss.str();
+	}
+
+	std::string legacy_level(eng::debug::LogLevel l) {
+		switch (l) {
+		case eng::debug::LogLevel::Error: return "ERROR";
+		case eng::debug::LogLevel::Warn: return "WARN";
+		case eng::debug::LogLevel::Info: return "INFO";
+		default: return "DEBUG";
+		}
+	}
+
+#if defined(__GNUC__)
+	__attribute__((format(printf, 4, 5)))
+#endif
+	void legacy_writef(NullSink& sink, eng::debug::LogLevel lvl, const char* tag, const char* fmt, ...) {
+		char buf[2048];
+		va_list ap;
+		va_start(ap, fmt);
+		std::vsnprintf(buf, sizeof(buf), fmt, ap);
+		va_end(ap);
+
+		std::ostringstream oss;
+		oss << "[" << legacy_time_now_str() << "]"
+			<< "[" << legacy_level(lvl) << "]"
+			<< "[" << tag << "] "
+			<< buf;
+		const std::string line = oss.str();
+		sink.write(lvl, tag, line);
+	}
+
+	template <typename Fn>
+	void run(const char* label, long lines, Fn&& fn, double& nsOut) {
+		using clock = std::chrono::steady_clock;
+		const auto a0 = g_allocs.load();
+		const auto t0 = clock::now();
+		for (long i = 0; i < lines; ++i) fn(i);
+		const auto t1 = clock::now();
+		const auto a1 = g_allocs.load();
+		nsOut = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)lines;
+		std::printf("%-14s: %8.1f ns/line   %.2f allocs/line\n",
+			label, nsOut, (double)(a1 - a0) / (double)lines);
+	}
+
+} // namespace
+
+// Count every heap allocation in the process.
+void* operator new(std::size_t n) {
+	g_allocs.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(n ? n : 1)) return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+	using namespace eng::debug;
+	const long lines = (argc > 1) ? std::atol(argv[1]) : 200000L;
+
+	LogConfig cfg;
+	cfg.useConsole = false;
+	cfg.useFile = false;
+	Log::init(cfg);
+
+	auto owned = std::make_unique<NullSink>();
+	NullSink* sink = owned.get();
+	Log::add_sink(std::move(owned));
+
+	// Warm up the per-thread buffer and time cache.
+	Log::writef(LogLevel::Info, "BENCH", "", 0, "warmup %d", 0);
+
+	double legacyNs = 0.0, currentNs = 0.0;
+
+	std::printf("-- plain message --\n");
+	run("legacy path", lines, [&](long) {
+		legacy_writef(*sink, LogLevel::Info, "CORE", "Window created");
+	}, legacyNs);
+	run("current path", lines, [&](long) {
+		Log::writef(LogLevel::Info, "CORE", "", 0, "Window created");
+	}, currentNs);
+	std::printf("speedup       : %8.1fx\n", (currentNs > 0.0) ? legacyNs / currentNs : 0.0);
+
+	std::printf("-- numeric message --\n");
+	run("legacy path", lines, [&](long i) {
+		legacy_writef(*sink, LogLevel::Info, "PERF", "FPS(avg): %.1f, frame(avg): %.2f ms, id %ld", 60.0, 16.6, i);
+	}, legacyNs);
+	run("current path", lines, [&](long i) {
+		Log::writef(LogLevel::Info, "PERF", "", 0, "FPS(avg): %.1f, frame(avg): %.2f ms, id %ld", 60.0, 16.6, i);
+	}, currentNs);
+	std::printf("speedup       : %8.1fx   (%llu bytes formatted)\n",
+		(currentNs > 0.0) ? legacyNs / currentNs : 0.0, sink->bytes);
+
+	double kvNs = 0.0;
+	std::printf("-- numeric message as key/value fields --\n");
+	run("write_kv", lines, [&](long i) {
+		Log::write_kv(LogLevel::Info, "PERF", "", 0, "frame", { {"fps", 60.0}, {"ms", 16.6}, {"id", i} });
+	}, kvNs);
+	std::printf("vs legacy     : %8.1fx\n", (kvNs > 0.0) ? legacyNs / kvNs : 0.0);
+
+	Log::shutdown();
+	return 0;
+}
@@ -0,0 +1,134 @@
+#include "Graphics/ObjLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+/*
+===============================================================================
+ bench_obj_load.cpp
+ ------------------------------------------------------------------------------
+ Headless benchmark for ObjLoader (no GPU needed).
+
+ Writes a torus of R x S quads (v, vn and "f a//a b//b c//c d//d" lines)
+ to a temporary directory, then times
+   - a cold load: parse the OBJ and write the binary cache,
+   - warm loads: map the cache (touching every byte, as an upload would).
+ Checks that
+   - shared corners are deduplicated to exactly R*S vertices,
+   - every quad becomes two triangles,
+   - the cached data is identical to the parsed data.
+ Exit code 1 if a check fails.
+
+ Usage
+   bench_obj_load [rings] [segments]   (default 512 / 512, about 260k quads)
+===============================================================================
+*/
+
+namespace {
+
+	using namespace Framework;
+	using Clock = std::chrono::steady_clock;
+
+	double ms_since(Clock::time_point t0) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+	}
+
+	bool write_torus(const std::string& path, int rings, int segments) {
+		std::FILE* f = std::fopen(path.c_str(), "wb");
+		if (!f) return false;
+		std::fprintf(f, "# generated by bench_obj_load\no torus\n");
+		const float tau = 6.28318530718f;
+		for (int r = 0; r < rings; ++r) {
+			for (int s = 0; s < segments; ++s) {
+				const float u = tau * r / rings, v = tau * s / segments;
+				const float cx = std::cos(u), cy = std::sin(u);
+				std::fprintf(f, "v %.6f %.6f %.6f\n", (1.0f + 0.3f * std::cos(v)) * cx, (1.0f + 0.3f * std::cos(v)) * cy, 0.3f * std::sin(v));
+				std::fprintf(f, "vn %.6f %.6f %.6f\n", std::cos(v) * cx, std::cos(v) * cy, std::sin(v));
+			}
+		}
+		for (int r = 0; r < rings; ++r) {
+			for (int s = 0; s < segments; ++s) {
+				const int a = r * segments + s + 1;
+				const int b = ((r + 1) % rings) * segments + s + 1;
+				const int c = ((r + 1) % rings) * segments + (s + 1) % segments + 1;
+				const int d = r * segments + (s + 1) % segments + 1;
+				std::fprintf(f, "f %d//%d %d//%d %d//%d %d//%d\n", a, a, b, b, c, c, d, d);
+			}
+		}
+		return std::fclose(f) == 0;
+	}
+
+	// Sum every value so a mapped cache really gets paged in
+	double touch(const ObjMesh& m) {
+		double sum = 0.0;
+		for (std::uint32_t i = 0; i < m.vertexCount * 6; ++i) sum += m.vertices[i];
+		for (std::uint32_t i = 0; i < m.indexCount; ++i) sum += m.indices[i];
+		return sum;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const int rings = (argc > 1) ? std::max(3, std::atoi(argv[1])) : 512;
+	const int segments = (argc > 2) ? std::max(3, std::atoi(argv[2])) : 512;
+
+	int failures = 0;
+	auto fail = [&](const char* what) { std::printf("CHECK FAILED: %s\n", what); ++failures; };
+
+	namespace fs = std::filesystem;
+	const fs::path dir = fs::temp_directory_path() / "bench_obj_load";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+	const std::string obj = (dir / "torus.obj").string();
+	if (!write_torus(obj, rings, segments)) {
+		std::printf("cannot write %s\n", obj.c_str());
+		return 1;
+	}
+	ObjLoader::SetCacheDirectory((dir / "cache").string());
+
+	std::string error;
+	auto t0 = Clock::now();
+	ObjMesh cold;
+	if (!ObjLoader::Load(obj, cold, &error)) {
+		std::printf("load failed: %s\n", error.c_str());
+		return 1;
+	}
+	const double coldMs = ms_since(t0);
+	const double coldSum = touch(cold);
+
+	double warmMs = 1e30;
+	bool identical = true, cached = true;
+	for (int i = 0; i < 10; ++i) {
+		t0 = Clock::now();
+		ObjMesh warm;
+		if (!ObjLoader::Load(obj, warm, &error)) { fail("warm load"); break; }
+		const double sum = touch(warm);
+		warmMs = std::min(warmMs, ms_since(t0));
+
+		cached = cached && warm.fromCache;
+		identical = identical && sum == coldSum && warm.vertexCount == cold.vertexCount && warm.indexCount == cold.indexCount
+			&& std::memcmp(warm.vertices, cold.vertices, cold.vertexCount * 6 * sizeof(float)) == 0
+			&& std::memcmp(warm.indices, cold.indices, cold.indexCount * sizeof(std::uint32_t)) == 0;
+	}
+
+	if (cold.fromCache) fail("first load parses");
+	if (!cached) fail("later loads come from the cache");
+	if (cold.vertexCount != static_cast<std::uint32_t>(rings * segments)) fail("shared corners deduplicated");
+	if (cold.indexCount != static_cast<std::uint32_t>(rings * segments * 6)) fail("quads triangulated");
+	if (!identical) fail("cache matches parsed data");
+
+	std::printf("bench_obj_load: %d x %d torus, %.1f MB OBJ -> %u vertices, %u triangles\n", rings, segments,
+		fs::file_size(obj) / (1024.0 * 1024.0), cold.vertexCount, cold.indexCount / 3);
+	std::printf("  parse + write cache : %8.2f ms\n", coldMs);
+	std::printf("  load from cache     : %8.2f ms (best of 10)\n", warmMs);
+
+	fs::remove_all(dir);
+	std::printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
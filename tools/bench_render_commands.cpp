@@ -0,0 +1,162 @@
+#include "Graphics/RecordingRenderBackend.h"
+#include "Graphics/RenderCommandBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/*
+===============================================================================
+ bench_render_commands.cpp
+ ------------------------------------------------------------------------------
+ Headless check and benchmark for RenderCommandBuffer, run against
+ RecordingRenderBackend (no GPU needed).
+
+ Each frame, T threads record N/T commands each with pseudo-random
+ (layer, program, texture, depth) keys; then Execute() sorts and runs them.
+
+ Reports record time (1 thread vs T threads), Execute() time, the radix
+ passes taken, state changes, and a std::sort of the same keys for
+ reference. Checks that
+   - every command is drawn exactly once,
+   - draws come out in non-decreasing key order,
+   - commands with equal keys from one thread keep their submission order.
+ Exit code 1 if a check fails.
+
+ Usage
+   bench_render_commands [commands] [threads] [frames]   (default 100,000 / 4 / 50)
+===============================================================================
+*/
+
+namespace {
+
+	using namespace Framework;
+	using Clock = std::chrono::steady_clock;
+
+	double us_since(Clock::time_point t0) {
+		return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+	}
+
+	std::uint32_t xorshift(std::uint32_t& s) {
+		s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+		return s;
+	}
+
+	// Command 'id' is stored in 'first' so the draw order can be checked.
+	std::uint64_t key_for(std::uint32_t id) {
+		std::uint32_t s = id * 2654435761u + 1;
+		xorshift(s);
+		const auto layer = static_cast<std::uint8_t>(xorshift(s) % 3);
+		const unsigned program = 1 + xorshift(s) % 8;
+		const unsigned texture = xorshift(s) % 32;
+		const float depth = static_cast<float>(xorshift(s) % 64) / 64.0f;   // many equal keys
+		return MakeSortKey(layer, program, texture, depth);
+	}
+
+	void record(RenderCommandBuffer& buffer, std::uint32_t begin, std::uint32_t end) {
+		RenderCommandBuffer::List& list = buffer.GetList();
+		for (std::uint32_t id = begin; id < end; ++id) {
+			const std::uint64_t key = key_for(id);
+			RenderCommand cmd;
+			cmd.vao = 1 + static_cast<unsigned>(id % 4);
+			cmd.program = static_cast<unsigned>((key >> 44) & 0xFFF);
+			cmd.texture = static_cast<unsigned>((key >> 32) & 0xFFF);
+			cmd.first = id;
+			cmd.count = 6;
+			list.Draw(key, cmd);
+		}
+	}
+
+	void record_parallel(RenderCommandBuffer& buffer, std::uint32_t n, unsigned threads) {
+		std::vector<std::thread> workers;
+		for (unsigned t = 0; t < threads; ++t) {
+			const std::uint32_t begin = static_cast<std::uint32_t>(std::uint64_t(n) * t / threads);
+			const std::uint32_t end = static_cast<std::uint32_t>(std::uint64_t(n) * (t + 1) / threads);
+			workers.emplace_back(record, std::ref(buffer), begin, end);
+		}
+		for (auto& w : workers) w.join();
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const std::uint32_t n = (argc > 1) ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+	const unsigned threads = (argc > 2) ? static_cast<unsigned>(std::max(1, std::atoi(argv[2]))) : 4;
+	const int frames = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 50;
+
+	RenderCommandBuffer buffer;
+	RecordingRenderBackend rec;
+	double best1 = 1e30, bestT = 1e30, bestExec = 1e30, bestStd = 1e30;
+
+	for (int f = 0; f < frames; ++f) {
+		auto t0 = Clock::now();
+		record(buffer, 0, n);
+		best1 = std::min(best1, us_since(t0));
+		buffer.Clear();
+
+		t0 = Clock::now();
+		record_parallel(buffer, n, threads);
+		bestT = std::min(bestT, us_since(t0));
+
+		rec.Reset();
+		t0 = Clock::now();
+		buffer.Execute(rec);
+		bestExec = std::min(bestExec, us_since(t0));
+
+		std::vector<std::uint64_t> keys(n);
+		for (std::uint32_t id = 0; id < n; ++id) keys[id] = key_for(id);
+		t0 = Clock::now();
+		std::sort(keys.begin(), keys.end());
+		bestStd = std::min(bestStd, us_since(t0));
+	}
+
+	const RenderCommandStats& st = buffer.GetStats();
+	std::printf("%u commands, %u threads (best of %d frames)\n", n, threads, frames);
+	std::printf("  record, 1 thread  : %9.1f us\n", best1);
+	std::printf("  record, %u threads : %9.1f us\n", threads, bestT);
+	std::printf("  execute (sort+run): %9.1f us   %zu radix passes\n", bestExec, st.sortPasses);
+	std::printf("  std::sort of keys : %9.1f us   (reference)\n", bestStd);
+	std::printf("  state changes     : %zu program, %zu texture, %zu vertex array\n",
+		st.programChanges, st.textureChanges, st.vertexArrayChanges);
+
+	// ---- checks on the last frame ----
+	int failures = 0;
+	auto fail = [&](const char* what) { std::printf("CHECK FAILED: %s\n", what); ++failures; };
+
+	std::vector<std::uint8_t> seen(n, 0);
+	std::vector<std::uint32_t> lastIdOfThread(threads, 0);
+	std::vector<bool> threadStarted(threads, false);
+	std::uint64_t prevKey = 0, prevEqualKey = ~0ull;
+	bool ordered = true, stable = true, once = true;
+	std::size_t draws = 0;
+	for (const auto& r : rec.GetRecords()) {
+		if (r.call != RecordingRenderBackend::Call::DrawArrays) continue;
+		++draws;
+		const auto id = static_cast<std::uint32_t>(r.b);
+		if (id >= n || seen[id]++) { once = false; continue; }
+		const std::uint64_t key = key_for(id);
+		if (key < prevKey) ordered = false;
+
+		// Within a run of equal keys, ids of the same thread must increase.
+		if (key != prevEqualKey) {
+			std::fill(threadStarted.begin(), threadStarted.end(), false);
+			prevEqualKey = key;
+		}
+		unsigned owner = 0;
+		while (owner + 1 < threads && id >= std::uint64_t(n) * (owner + 1) / threads) ++owner;
+		if (threadStarted[owner] && id < lastIdOfThread[owner]) stable = false;
+		threadStarted[owner] = true;
+		lastIdOfThread[owner] = id;
+		prevKey = key;
+	}
+	if (draws != n || !once || std::count(seen.begin(), seen.end(), 1) != static_cast<std::ptrdiff_t>(n))
+		fail("every command drawn exactly once");
+	if (!ordered) fail("draws in key order");
+	if (!stable) fail("equal keys keep submission order");
+
+	std::printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+#include "DebugComponents/Trace.h"
+#include "DebugComponents/PerfViewer.h"
+#include "DebugComponents/Tsc.h"
+#include "DebugComponents/Log.h"
+#include "DebugComponents/HwCounters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+===============================================================================
+ bench_scope_timer.cpp
+ ------------------------------------------------------------------------------
+ Microbenchmark for the profiler's per-scope overhead.
+
+ What it measures (nanoseconds per iteration, best of several runs)
+   - empty loop          : loop + compiler barrier only (baseline)
+   - steady_clock pair   : two steady_clock::now() calls (old ScopeTimer cost)
+   - TscClock pair       : rdtsc + rdtscp
+   - DBG_SCOPE_SYS       : full ScopeTimer incl. PerfViewer::record_ticks
+   - DBG_SCOPE_HW        : ScopeTimer + hardware counter reads (only when
+                           HwCounters::enable() succeeds on this machine),
+                           plus the read overhead it subtracts per scope
+
+ The last line prints how many scopes fit into 1% of a 60 FPS frame, which is
+ the number we use to budget dense instrumentation.
+
+ Usage
+   bench_scope_timer [iterations]     (default 2,000,000)
+===============================================================================
+*/
+
+namespace {
+
+	using namespace eng::debug;
+
+	// Prevent the optimizer from deleting the loop bodies.
+	volatile std::uint64_t g_sink = 0;
+
+	template <typename Fn>
+	double ns_per_iter(long iters, Fn&& body) {
+		using clock = std::chrono::steady_clock;
+		double best = 1e30;
+		for (int run = 0; run < 5; ++run) {
+			const auto t0 = clock::now();
+			for (long i = 0; i < iters; ++i) body();
+			const auto t1 = clock::now();
+			const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)iters;
+			if (ns < best) best = ns;
+		}
+		return best;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const long iters = (argc > 1) ? std::atol(argv[1]) : 2000000L;
+
+	// Keep the log quiet; we only want our own table on stdout.
+	LogConfig cfg;
+	cfg.level = LogLevel::Warn;
+	cfg.useFile = false;
+	Log::init(cfg);
+	TscClock::calibrate();
+
+	const double empty = ns_per_iter(iters, [] { g_sink = g_sink + 1; });
+
+	const double chrono = ns_per_iter(iters, [] {
+		const auto a = std::chrono::steady_clock::now();
+		const auto b = std::chrono::steady_clock::now();
+		g_sink = g_sink + (std::uint64_t)(b - a).count();
+	});
+
+	const double tsc = ns_per_iter(iters, [] {
+		const auto a = TscClock::now();
+		const auto b = TscClock::now_ordered();
+		g_sink = g_sink + (b - a);
+	});
+
+	PerfViewer::begin_frame();
+	const double scope = ns_per_iter(iters, [] {
+		DBG_SCOPE_SYS("bench", Subsystem::Other);
+		g_sink = g_sink + 1;
+	});
+	PerfViewer::end_frame();
+
+	// Counter reads are syscalls, so use fewer iterations.
+	double hwScope = -1.0;
+	HwCounterValues hwOverhead;
+	if (HwCounters::enable()) {
+		hwOverhead = HwCounters::read_overhead();
+		PerfViewer::begin_frame();
+		hwScope = ns_per_iter(iters / 20 + 1, [] {
+			DBG_SCOPE_HW("bench", Subsystem::Other);
+			g_sink = g_sink + 1;
+		});
+		PerfViewer::end_frame();
+		HwCounters::disable();
+	}
+
+	std::printf("ENG_PROFILING      : %d\n", ENG_PROFILING);
+	std::printf("TSC frequency      : %.1f MHz\n", 1e-6 / TscClock::seconds_per_tick());
+	std::printf("empty loop         : %7.2f ns/iter\n", empty);
+	std::printf("steady_clock pair  : %7.2f ns/iter\n", chrono);
+	std::printf("TscClock pair      : %7.2f ns/iter\n", tsc);
+	std::printf("DBG_SCOPE_SYS      : %7.2f ns/iter\n", scope);
+	if (hwScope >= 0.0) {
+		std::printf("DBG_SCOPE_HW       : %7.2f ns/iter\n", hwScope);
+		std::printf("HW read overhead   : %llu instr, %llu cycles (subtracted per scope)\n",
+			(unsigned long long)hwOverhead[HwEvent::Instructions], (unsigned long long)hwOverhead[HwEvent::Cycles]);
+	}
+	else {
+		std::printf("DBG_SCOPE_HW       : (hardware counters unavailable)\n");
+	}
+
+	const double perScope = (scope - empty > 0.0) ? scope - empty : 0.0;
+	if (perScope > 0.0) {
+		const double budgetNs = (1.0 / 60.0) * 0.01 * 1e9;
+		std::printf("per-scope overhead : %7.2f ns -> %.0f scopes per 1%% of a 60 FPS frame\n",
+			perScope, budgetNs / perScope);
+	}
+	else {
+		std::printf("per-scope overhead : below measurement noise\n");
+	}
+
+	Log::shutdown();
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include "Graphics/RecordingRenderBackend.h"
+#include "Graphics/SpriteBatch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*
+===============================================================================
+ bench_sprite_batch.cpp
+ ------------------------------------------------------------------------------
+ Headless check and benchmark for SpriteBatch. Runs against
+ RecordingRenderBackend, so it needs no GPU and can run in CI.
+
+ Scene: N sprites cycling through 4 programs x 4 textures (worst case for
+ submission order), a few fans and lines.
+
+ Reports, per frame:
+   - per-object path : what one Mesh::Draw per object costs in GPU calls
+					   (bind VAO/program/texture, draw, unbind)
+   - batched path    : draw calls, state changes, bytes uploaded, orphans
+					   and CPU time of Begin/Submit/End
+ and checks that
+   - every submitted vertex is drawn exactly once,
+   - draw calls == number of distinct (program, texture, primitive) states,
+   - the uploaded vertices of each draw all belong to that draw's state.
+ Exit code 1 if a check fails.
+
+ Usage
+   bench_sprite_batch [sprites] [frames]     (default 10,000 sprites, 200 frames)
+===============================================================================
+*/
+
+namespace {
+
+	using namespace Framework;
+
+	constexpr unsigned kPrograms = 4;
+	constexpr unsigned kTextures = 4;
+
+	// Encode the expected state in the color so the upload can be verified.
+	BatchState sprite_state(std::size_t i) {
+		BatchState s;
+		s.program = 100 + static_cast<unsigned>(i % kPrograms);
+		s.texture = 200 + static_cast<unsigned>((i / kPrograms) % kTextures);
+		return s;
+	}
+
+	void submit_scene(SpriteBatch& batch, std::size_t sprites) {
+		for (std::size_t i = 0; i < sprites; ++i) {
+			const BatchState s = sprite_state(i);
+			batch.SubmitQuad(s, static_cast<float>(i % 100) * 0.02f - 1.0f, static_cast<float>(i / 100) * 0.02f - 1.0f,
+				0.015f, 0.015f, static_cast<float>(s.program), static_cast<float>(s.texture), 0.0f);
+		}
+		// A fan (circle) and a line, mesh style.
+		static const float fan[] = {
+			0, 0, 0, 1, 1, 1,   1, 0, 0, 1, 0, 0,   0, 1, 0, 0, 1, 0,   -1, 0, 0, 0, 0, 1,   0, -1, 0, 1, 1, 0,
+		};
+		static const float line[] = { -1, 0, 0, 1, 0, 1,   1, 0, 0, 0, 1, 1 };
+		BatchState mesh;
+		mesh.program = 100;
+		mesh.texture = 0;
+		batch.SubmitVertices(mesh, fan, 5, Topology::TriangleFan, 0.5f, 0.5f, 0.1f);
+		batch.SubmitVertices(mesh, line, 2, Topology::Lines);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const std::size_t sprites = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000;
+	const int frames = (argc > 2) ? std::atoi(argv[2]) : 200;
+
+	// ---- per-object path: one Mesh::Draw per sprite ----
+	{
+		RecordingRenderBackend rec;
+		for (std::size_t i = 0; i < sprites; ++i) {
+			const BatchState s = sprite_state(i);
+			rec.UseProgram(s.program);
+			rec.BindTexture(0, s.texture);
+			rec.BindVertexArray(1);
+			rec.DrawArrays(Primitive::Triangles, 0, 6);
+			rec.BindVertexArray(0);
+		}
+		const auto& c = rec.GetCounters();
+		std::printf("per-object path : %7zu draws  %7zu program binds  %7zu texture binds  %7zu VAO binds\n",
+			c.drawCalls, c.programBinds, c.textureBinds, c.vertexArrayBinds);
+	}
+
+	// ---- batched path ----
+	RecordingRenderBackend rec;
+	SpriteBatch batch(rec, 16 * 1024);
+	double bestUs = 1e30;
+	for (int f = 0; f < frames; ++f) {
+		rec.Reset();
+		const auto t0 = std::chrono::steady_clock::now();
+		batch.Begin();
+		submit_scene(batch, sprites);
+		batch.End();
+		const auto t1 = std::chrono::steady_clock::now();
+		const double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+		if (us < bestUs) bestUs = us;
+	}
+	const BatchStats& st = batch.GetStats();
+	const auto& c = rec.GetCounters();
+	std::printf("batched path    : %7zu draws  %7zu program binds  %7zu texture binds  %7zu VAO binds\n",
+		c.drawCalls, c.programBinds, c.textureBinds, c.vertexArrayBinds);
+	std::printf("                  %zu submissions, %zu vertices, %.1f KB uploaded, %zu orphans (last frame), capacity %zu vertices\n",
+		st.submissions, st.vertices, st.bytesUploaded / 1024.0, st.orphans, batch.GetCapacity());
+	std::printf("                  %.1f us CPU per frame (best of %d)\n", bestUs, frames);
+
+	// ---- checks on the last frame ----
+	int failures = 0;
+	auto fail = [&](const char* what) { std::printf("CHECK FAILED: %s\n", what); ++failures; };
+
+	const std::size_t expectedVerts = sprites * 6 + 9 + 2;
+	if (c.verticesDrawn != expectedVerts) fail("every submitted vertex drawn exactly once");
+
+	const std::size_t spriteStates = (sprites >= kPrograms * kTextures) ? kPrograms * kTextures : sprites;
+	const std::size_t expectedDraws = spriteStates + 2;   // + fan (triangles, tex 0) + line
+	if (c.drawCalls != expectedDraws) fail("one draw call per distinct state");
+
+	// Walk the recorded calls: each sprite vertex must carry the bound program/texture in its color.
+	unsigned program = 0, texture = 0, vbo = 0;
+	for (const auto& r : rec.GetRecords()) {
+		if (r.call == RecordingRenderBackend::Call::MapBufferRange) vbo = static_cast<unsigned>(r.a);
+	}
+	const auto* data = rec.GetBufferData(vbo);
+	for (const auto& r : rec.GetRecords()) {
+		using Call = RecordingRenderBackend::Call;
+		if (r.call == Call::UseProgram) program = static_cast<unsigned>(r.a);
+		else if (r.call == Call::BindTexture) texture = static_cast<unsigned>(r.b);
+		else if (r.call == Call::DrawArrays && data && texture != 0) {
+			for (std::size_t v = r.b; v < r.b + r.c; ++v) {
+				BatchVertex bv;
+				std::memcpy(&bv, data->data() + v * sizeof(BatchVertex), sizeof(bv));
+				if (static_cast<unsigned>(bv.r) != program || static_cast<unsigned>(bv.g) != texture) {
+					fail("uploaded vertices match the state of their draw");
+					v = r.b + r.c;
+				}
+			}
+		}
+	}
+
+	std::printf("%s\n", failures ? "FAILED" : "all checks passed");
+	return failures ? 1 : 0;
+}
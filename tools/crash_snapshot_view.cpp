@@ -0,0 +1,247 @@
+#include "DebugComponents/CrashSnapshot.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*
+===============================================================================
+ crash_snapshot_view.cpp
+ ------------------------------------------------------------------------------
+ Prints a crash snapshot (crash_YYYYMMDD_HHMMSS.snap, see CrashSnapshot.h)
+ in readable form:
+   - crash info (reason, signal/code, fault address, frame number),
+   - registers of the crashing thread,
+   - the perf history: frame time of every recorded frame as a small text
+	 chart, plus the categories that grew the most over the last frames
+	 (what the game was doing more and more of before it died),
+   - the log tail and the thread list,
+   - with --stack a hex dump of the captured stack, with --modules the
+	 module map (addresses can then be fed to crash_symbolize/addr2line).
+
+ Usage
+   crash_snapshot_view <file.snap> [--stack] [--modules] [--frames N]
+===============================================================================
+*/
+
+namespace {
+
+	using eng::debug::SnapArch;
+	using eng::debug::SnapRecord;
+
+	struct Snapshot {
+		bool hasInfo = false;
+		eng::debug::SnapInfo info{};
+		std::vector<std::string> categories;
+		eng::debug::SnapPerfHeader perf{};
+		std::vector<std::uint64_t> perfRows;
+		std::string logTail, threads, modules;
+		bool hasThread = false;
+		eng::debug::SnapThreadHeader thread{};
+		std::vector<std::uint64_t> regs;
+		std::vector<unsigned char> stack;
+	};
+
+	bool load(const std::string& path, Snapshot& s, std::string& err) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in) { err = "cannot open " + path; return false; }
+		std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		eng::debug::SnapFileHeader fh{};
+		if (data.size() < sizeof(fh)) { err = "file too small"; return false; }
+		std::memcpy(&fh, data.data(), sizeof(fh));
+		if (std::memcmp(fh.magic, eng::debug::kSnapMagic, sizeof(fh.magic)) != 0) { err = "not a crash snapshot"; return false; }
+		if (fh.version != eng::debug::kSnapVersion) { err = "unsupported version " + std::to_string(fh.version); return false; }
+
+		size_t at = sizeof(fh);
+		while (at + sizeof(eng::debug::SnapRecordHeader) <= data.size()) {
+			eng::debug::SnapRecordHeader rh{};
+			std::memcpy(&rh, data.data() + at, sizeof(rh));
+			at += sizeof(rh);
+			const size_t bytes = std::min<size_t>(rh.bytes, data.size() - at);   // tolerate a truncated tail
+			const char* p = data.data() + at;
+			at += (static_cast<size_t>(rh.bytes) + 7) & ~size_t(7);
+
+			switch (static_cast<SnapRecord>(rh.type)) {
+			case SnapRecord::Info:
+				if (bytes >= sizeof(s.info)) { std::memcpy(&s.info, p, sizeof(s.info)); s.hasInfo = true; }
+				break;
+			case SnapRecord::Categories: {
+				std::uint32_t count = 0;
+				if (bytes < sizeof(count)) break;
+				std::memcpy(&count, p, sizeof(count));
+				size_t o = sizeof(count);
+				for (std::uint32_t i = 0; i < count && o + 2 <= bytes; ++i) {
+					std::uint16_t len = 0;
+					std::memcpy(&len, p + o, sizeof(len));
+					o += sizeof(len);
+					len = static_cast<std::uint16_t>(std::min<size_t>(len, bytes - o));
+					s.categories.emplace_back(p + o, len);
+					o += len;
+				}
+				break;
+			}
+			case SnapRecord::PerfFrames: {
+				if (bytes < sizeof(s.perf)) break;
+				std::memcpy(&s.perf, p, sizeof(s.perf));
+				const size_t words = std::min<size_t>(static_cast<size_t>(s.perf.frames) * (s.perf.categories + 1),
+					(bytes - sizeof(s.perf)) / sizeof(std::uint64_t));
+				s.perfRows.resize(words);
+				std::memcpy(s.perfRows.data(), p + sizeof(s.perf), words * sizeof(std::uint64_t));
+				s.perf.frames = static_cast<std::uint32_t>(words / (s.perf.categories + 1));
+				break;
+			}
+			case SnapRecord::LogTail:    s.logTail.assign(p, bytes); break;
+			case SnapRecord::ThreadList: s.threads.assign(p, bytes); break;
+			case SnapRecord::Modules:    s.modules.assign(p, bytes); break;
+			case SnapRecord::Thread: {
+				if (bytes < sizeof(s.thread)) break;
+				std::memcpy(&s.thread, p, sizeof(s.thread));
+				const size_t regBytes = std::min<size_t>(s.thread.regCount * sizeof(std::uint64_t), bytes - sizeof(s.thread));
+				s.regs.resize(regBytes / sizeof(std::uint64_t));
+				std::memcpy(s.regs.data(), p + sizeof(s.thread), s.regs.size() * sizeof(std::uint64_t));
+				const size_t stackAt = sizeof(s.thread) + s.regs.size() * sizeof(std::uint64_t);
+				s.stack.assign(p + stackAt, p + bytes);
+				s.hasThread = true;
+				break;
+			}
+			default: break;   // newer record type
+			}
+		}
+		return true;
+	}
+
+	const char* const kX64Regs[] = { "rax", "rbx", "rcx", "rdx", "rsi", "rdi", "rbp", "rsp",
+		"r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "rip", "rflags" };
+
+	std::string reg_name(SnapArch arch, size_t i) {
+		if (arch == SnapArch::X86_64 && i < std::size(kX64Regs)) return kX64Regs[i];
+		if (arch == SnapArch::Arm64) {
+			if (i < 31) return "x" + std::to_string(i);
+			if (i == 31) return "sp";
+			if (i == 32) return "pc";
+			if (i == 33) return "pstate";
+		}
+		return "r" + std::to_string(i);
+	}
+
+	void print_info(const Snapshot& s) {
+		const auto& i = s.info;
+		char when[32] = "?";
+		const std::time_t t = static_cast<std::time_t>(i.unixTime);
+		if (const std::tm* tm = std::gmtime(&t)) std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S UTC", tm);
+		std::printf("Crash: %.*s\n", static_cast<int>(sizeof(i.reason)), i.reason);
+		std::printf("  time     %s\n", when);
+		std::printf("  pid      %llu   thread %llu\n", (unsigned long long)i.pid, (unsigned long long)i.tid);
+		std::printf("  frame    %llu\n", (unsigned long long)i.frameIndex);
+		if (i.signal) std::printf("  signal   %d   code %llu\n", i.signal, (unsigned long long)i.code);
+		else if (i.code) std::printf("  code     0x%llX\n", (unsigned long long)i.code);
+		if (i.faultAddr) std::printf("  address  0x%llx\n", (unsigned long long)i.faultAddr);
+	}
+
+	void print_registers(const Snapshot& s) {
+		if (!s.hasThread) return;
+		std::printf("\nRegisters (thread %llu):\n", (unsigned long long)s.thread.tid);
+		if (s.regs.empty()) std::printf("  (no signal context; stack taken from the handler)\n");
+		const SnapArch arch = static_cast<SnapArch>(s.thread.arch);
+		for (size_t i = 0; i < s.regs.size(); ++i) {
+			std::printf("  %-6s 0x%016llx%s", reg_name(arch, i).c_str(), (unsigned long long)s.regs[i], (i % 3 == 2) ? "\n" : "");
+		}
+		if (s.regs.size() % 3) std::printf("\n");
+	}
+
+	void print_perf(const Snapshot& s, size_t showFrames) {
+		const size_t cats = s.perf.categories;
+		const size_t n = s.perf.frames;
+		if (n == 0) { std::printf("\nPerf history: none (crash before the first frame)\n"); return; }
+		const double msPerTick = s.perf.secondsPerTick * 1000.0;
+		auto row = [&](size_t f) { return &s.perfRows[f * (cats + 1)]; };
+
+		double worst = 0.0, sum = 0.0;
+		for (size_t f = 0; f < n; ++f) {
+			const double ms = row(f)[0] * msPerTick;
+			worst = std::max(worst, ms);
+			sum += ms;
+		}
+		std::printf("\nPerf history: %zu frames, avg %.2f ms, max %.2f ms%s\n", n, sum / n, worst,
+			s.perf.lastIsPartial ? " (last frame still running at the crash)" : "");
+
+		// Newest frames as bars, scaled to the worst frame.
+		const size_t first = (n > showFrames) ? n - showFrames : 0;
+		for (size_t f = first; f < n; ++f) {
+			const double ms = row(f)[0] * msPerTick;
+			const int bar = (worst > 0.0) ? static_cast<int>(ms / worst * 50.0 + 0.5) : 0;
+			const long long idx = static_cast<long long>(s.info.frameIndex) - static_cast<long long>(n - f) + (s.perf.lastIsPartial ? 1 : 0);
+			std::printf("  %8lld %8.2f ms |%.*s\n", idx, ms, bar, "##################################################");
+		}
+
+		// Per category: average over the whole history vs. the newest quarter.
+		const size_t recent = std::max<size_t>(1, n / 4);
+		struct CatAvg { size_t cat; double all, recent; };
+		std::vector<CatAvg> avgs;
+		for (size_t c = 0; c < cats; ++c) {
+			CatAvg a{ c, 0.0, 0.0 };
+			for (size_t f = 0; f < n; ++f) a.all += row(f)[c + 1] * msPerTick;
+			for (size_t f = n - recent; f < n; ++f) a.recent += row(f)[c + 1] * msPerTick;
+			a.all /= n;
+			a.recent /= recent;
+			if (a.all > 0.0 || a.recent > 0.0) avgs.push_back(a);
+		}
+		std::sort(avgs.begin(), avgs.end(), [](const CatAvg& a, const CatAvg& b) { return a.recent - a.all > b.recent - b.all; });
+		std::printf("\n  %-16s %10s %10s   (avg ms: all frames / newest %zu)\n", "category", "all", "recent", recent);
+		for (const CatAvg& a : avgs) {
+			const std::string name = (a.cat < s.categories.size()) ? s.categories[a.cat] : "#" + std::to_string(a.cat);
+			std::printf("  %-16s %10.3f %10.3f%s\n", name.c_str(), a.all, a.recent, (a.recent - a.all > 0.05) ? "   <- growing" : "");
+		}
+	}
+
+	void print_stack(const Snapshot& s) {
+		std::printf("\nStack (%zu bytes from 0x%llx):\n", s.stack.size(), (unsigned long long)s.thread.sp);
+		for (size_t o = 0; o + 8 <= s.stack.size(); o += 8) {
+			std::uint64_t v = 0;
+			std::memcpy(&v, s.stack.data() + o, sizeof(v));
+			std::printf("  0x%016llx  0x%016llx\n", (unsigned long long)(s.thread.sp + o), (unsigned long long)v);
+		}
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	std::string path;
+	bool stack = false, modules = false;
+	size_t frames = 30;
+	for (int i = 1; i < argc; ++i) {
+		const std::string a = argv[i];
+		if (a == "--stack") stack = true;
+		else if (a == "--modules") modules = true;
+		else if (a == "--frames" && i + 1 < argc) frames = std::strtoul(argv[++i], nullptr, 10);
+		else path = a;
+	}
+	if (path.empty()) {
+		std::fprintf(stderr, "usage: crash_snapshot_view <file.snap> [--stack] [--modules] [--frames N]\n");
+		return 2;
+	}
+
+	Snapshot s;
+	std::string err;
+	if (!load(path, s, err)) {
+		std::fprintf(stderr, "crash_snapshot_view: %s\n", err.c_str());
+		return 1;
+	}
+
+	if (s.hasInfo) print_info(s);
+	print_registers(s);
+	print_perf(s, frames);
+	if (!s.logTail.empty()) std::printf("\nLog tail:\n%s", s.logTail.c_str());
+	if (!s.threads.empty()) std::printf("\nThreads (id name state):\n%s", s.threads.c_str());
+	if (stack && s.hasThread) print_stack(s);
+	if (modules && !s.modules.empty()) std::printf("\nModules:\n%s", s.modules.c_str());
+	return 0;
+}
@@ -0,0 +1,200 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define popen _popen
+#define pclose _pclose
+#endif
+
+/*
+===============================================================================
+ crash_symbolize.cpp
+ ------------------------------------------------------------------------------
+ Offline symbolizer for POSIX crash reports written by CrashLogger.
+
+ The signal handler cannot resolve symbols safely, so a report only holds
+ raw addresses ("PC: 0x..." and "  [i] 0x..." under "Stack (raw):") plus a
+ copy of /proc/self/maps ("Memory map:"). This tool:
+   1) maps every address to its module and module-relative offset,
+   2) runs addr2line once per module for all of that module's addresses,
+   3) prints the report again with "function at file:line" added to each
+	  address line (the memory map itself is left out).
+
+ Return addresses point just after the call, so 1 is subtracted before the
+ lookup (the usual trick to get the call line). The faulting PC, and the
+ stack frame equal to it, are exact and looked up as-is.
+
+ Needs the same binaries (with symbols, e.g. RelWithDebInfo) that produced
+ the report, at the paths listed in the memory map, or pass --root DIR to
+ look them up under DIR instead.
+
+ Usage
+   crash_symbolize <crash_report.txt> [--addr2line PATH] [--root DIR]
+===============================================================================
+*/
+
+namespace {
+
+	struct Mapping {
+		std::uint64_t start = 0, end = 0, offset = 0;
+		std::string path;
+	};
+
+	struct Frame {
+		size_t line = 0;            // index into the report lines
+		std::uint64_t addr = 0;
+		bool isPc = false;
+		const Mapping* map = nullptr;
+		std::uint64_t rel = 0;      // address to hand to addr2line
+		std::string symbol;         // "func at file:line"
+	};
+
+	// "  [3] 0x7f..." or "PC: 0x..." -> address, else 0.
+	std::uint64_t parse_address_line(const std::string& l, bool& isPc) {
+		isPc = l.rfind("PC: ", 0) == 0;
+		size_t pos = std::string::npos;
+		if (isPc) pos = 4;
+		else if (l.size() > 4 && l[0] == ' ' && l[1] == ' ' && l[2] == '[') {
+			const size_t close = l.find("] ");
+			if (close != std::string::npos) pos = close + 2;
+		}
+		if (pos == std::string::npos || l.compare(pos, 2, "0x") != 0) return 0;
+		return std::strtoull(l.c_str() + pos, nullptr, 16);
+	}
+
+	// "start-end perms offset dev inode   path"
+	bool parse_map_line(const std::string& l, Mapping& m) {
+		char perms[8] = {}, dev[16] = {};
+		unsigned long long start = 0, end = 0, off = 0, inode = 0;
+		int consumed = 0;
+		if (std::sscanf(l.c_str(), "%llx-%llx %7s %llx %15s %llu %n", &start, &end, perms, &off, dev, &inode, &consumed) < 6) return false;
+		if (consumed <= 0 || static_cast<size_t>(consumed) >= l.size() || l[consumed] != '/') return false;
+		m.start = start;
+		m.end = end;
+		m.offset = off;
+		m.path = l.substr(static_cast<size_t>(consumed));
+		return true;
+	}
+
+	// Fixed-address executables (ET_EXEC) take absolute addresses;
+	// position-independent ones (ET_DYN) take module-relative ones.
+	bool is_fixed_address_elf(const std::string& path) {
+		std::ifstream f(path, std::ios::binary);
+		unsigned char h[18] = {};
+		if (!f.read(reinterpret_cast<char*>(h), sizeof(h))) return false;
+		if (h[0] != 0x7F || h[1] != 'E' || h[2] != 'L' || h[3] != 'F') return false;
+		const unsigned type = (h[5] == 2) ? (h[16] << 8 | h[17]) : (h[17] << 8 | h[16]);   // EI_DATA: 2 = big endian
+		return type == 2;   // ET_EXEC
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	std::string reportPath, addr2line = "addr2line", root;
+	for (int i = 1; i < argc; ++i) {
+		const std::string a = argv[i];
+		if (a == "--addr2line" && i + 1 < argc) addr2line = argv[++i];
+		else if (a == "--root" && i + 1 < argc) root = argv[++i];
+		else reportPath = a;
+	}
+	if (reportPath.empty()) {
+		std::fprintf(stderr, "usage: crash_symbolize <crash_report.txt> [--addr2line PATH] [--root DIR]\n");
+		return 2;
+	}
+
+	std::ifstream in(reportPath);
+	if (!in) {
+		std::fprintf(stderr, "crash_symbolize: cannot open %s\n", reportPath.c_str());
+		return 1;
+	}
+
+	// Split the report into lines, remembering where the memory map starts.
+	std::vector<std::string> lines;
+	std::vector<Mapping> maps;
+	size_t mapsAt = std::string::npos;
+	for (std::string l; std::getline(in, l);) {
+		if (mapsAt == std::string::npos && l == "Memory map:") mapsAt = lines.size();
+		Mapping m;
+		if (mapsAt != std::string::npos && parse_map_line(l, m)) maps.push_back(std::move(m));
+		lines.push_back(std::move(l));
+	}
+	if (maps.empty()) {
+		std::fprintf(stderr, "crash_symbolize: no \"Memory map:\" section (Windows reports are already symbolized)\n");
+	}
+
+	// Collect addresses and group them per module.
+	std::vector<Frame> frames;
+	std::uint64_t pc = 0;
+	const size_t scanEnd = (mapsAt == std::string::npos) ? lines.size() : mapsAt;
+	for (size_t i = 0; i < scanEnd; ++i) {
+		Frame f;
+		f.addr = parse_address_line(lines[i], f.isPc);
+		if (!f.addr) continue;
+		f.line = i;
+		if (f.isPc) pc = f.addr;
+		const std::uint64_t lookup = (f.isPc || f.addr == pc) ? f.addr : f.addr - 1;
+		for (const Mapping& m : maps) {
+			if (lookup >= m.start && lookup < m.end) { f.map = &m; break; }
+		}
+		if (f.map) {
+			f.rel = is_fixed_address_elf(root + f.map->path) ? lookup : lookup - f.map->start + f.map->offset;
+		}
+		frames.push_back(f);
+	}
+
+	std::map<std::string, std::vector<Frame*>> perModule;
+	for (Frame& f : frames) {
+		if (f.map) perModule[f.map->path].push_back(&f);
+	}
+
+	// One addr2line run per module: two output lines (function, file:line)
+	// per address, in order.
+	for (auto& [path, list] : perModule) {
+		std::string cmd = addr2line + " -f -C -e \"" + root + path + "\"";
+		char hex[32];
+		for (const Frame* f : list) {
+			std::snprintf(hex, sizeof(hex), " 0x%llx", static_cast<unsigned long long>(f->rel));
+			cmd += hex;
+		}
+		std::FILE* p = popen(cmd.c_str(), "r");
+		if (!p) continue;
+		char func[1024], where[1024];
+		for (Frame* f : list) {
+			if (!std::fgets(func, sizeof(func), p) || !std::fgets(where, sizeof(where), p)) break;
+			std::string fn(func), loc(where);
+			while (!fn.empty() && (fn.back() == '\n' || fn.back() == '\r')) fn.pop_back();
+			while (!loc.empty() && (loc.back() == '\n' || loc.back() == '\r')) loc.pop_back();
+			f->symbol = fn + " at " + loc;
+		}
+		pclose(p);
+	}
+
+	// Print the report with symbols appended to the address lines.
+	size_t next = 0;
+	for (size_t i = 0; i < scanEnd; ++i) {
+		std::string out = lines[i];
+		if (next < frames.size() && frames[next].line == i) {
+			const Frame& f = frames[next++];
+			if (f.map) {
+				const size_t slash = f.map->path.find_last_of('/');
+				char rel[64];
+				std::snprintf(rel, sizeof(rel), "+0x%llx", static_cast<unsigned long long>(f.rel));
+				out += "  " + (f.symbol.empty() ? std::string("??") : f.symbol)
+					+ "  [" + f.map->path.substr(slash + 1) + rel + "]";
+			}
+			else {
+				out += "  (no module)";
+			}
+		}
+		std::printf("%s\n", out.c_str());
+	}
+	if (mapsAt != std::string::npos) {
+		std::printf("(memory map omitted: %zu mapped file ranges)\n", maps.size());
+	}
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include "DebugComponents/Sinks.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+/*
+===============================================================================
+ logring_dump.cpp
+ ------------------------------------------------------------------------------
+ Prints the contents of a memory-mapped log ring (RingFileSink) in order,
+ oldest line first. Works on the ring of a crashed/killed process as well as
+ on one that is still being written.
+
+ Usage
+   logring_dump [ring file] [--tail N] [--info]
+	 ring file   default "engine.ring" (the previous run is "engine.ring.prev")
+	 --tail N    only the last N lines
+	 --info      print the ring header to stderr first
+===============================================================================
+*/
+
+int main(int argc, char** argv) {
+	std::string path = "engine.ring";
+	std::size_t tail = 0;
+	bool info = false;
+	for (int i = 1; i < argc; ++i) {
+		const std::string a = argv[i];
+		if (a == "--tail" && i + 1 < argc) tail = std::strtoul(argv[++i], nullptr, 10);
+		else if (a == "--info") info = true;
+		else path = a;
+	}
+
+	std::string text, error;
+	eng::debug::RingLogHeader hdr{};
+	if (!eng::debug::RingFileSink::read_file(path, text, hdr, error)) {
+		std::fprintf(stderr, "logring_dump: %s\n", error.c_str());
+		return 1;
+	}
+
+	if (info) {
+		const std::time_t start = static_cast<std::time_t>(hdr.startTime);
+		std::fprintf(stderr, "ring      : %s\n", path.c_str());
+		std::fprintf(stderr, "pid       : %llu\n", (unsigned long long)hdr.pid);
+		std::fprintf(stderr, "started   : %s", std::ctime(&start));
+		std::fprintf(stderr, "capacity  : %llu bytes\n", (unsigned long long)hdr.capacity);
+		std::fprintf(stderr, "written   : %llu bytes%s\n", (unsigned long long)hdr.head,
+			hdr.head > hdr.capacity ? " (wrapped)" : "");
+	}
+
+	// Skip to the last N lines if asked.
+	std::size_t begin = 0;
+	if (tail > 0 && !text.empty()) {
+		std::size_t lines = 0;
+		for (std::size_t i = text.size() - 1; i > 0; --i) {
+			if (text[i - 1] == '\n' && ++lines == tail) { begin = i; break; }
+		}
+	}
+	std::fwrite(text.data() + begin, 1, text.size() - begin, stdout);
+	return 0;
+}
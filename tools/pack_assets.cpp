@@ -0,0 +1,143 @@
+#include "Graphics/PackFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+===============================================================================
+ pack_assets.cpp
+ ------------------------------------------------------------------------------
+ Offline packer for PackFile archives (.pak).
+
+ Collects every file under the given directories (and any files named
+ directly), stores each under its path relative to the working directory
+ ("shaders/basic.vert"), and writes one archive. Entries are LZ4
+ compressed where that saves at least 1/8, except formats that are
+ already compressed (png, jpg) or are meant to be used in place (bin).
+ The archive is then opened again and every entry compared with its
+ source file. Exit code 1 on any error or mismatch.
+
+ Usage
+   pack_assets <output.pak> <dir or file>... [--align N] [--store]
+	 --align N   entry alignment in bytes, power of two (default 16)
+	 --store     no compression at all
+   Missing inputs are skipped with a warning, so an optional folder
+   (assets/) does not break the build.
+===============================================================================
+*/
+
+namespace {
+
+	using namespace Framework;
+	namespace fs = std::filesystem;
+
+	bool read_file(const fs::path& path, std::vector<unsigned char>& data) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) return false;
+		data.resize(static_cast<std::size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		return static_cast<bool>(file);
+	}
+
+	bool worth_compressing(const fs::path& path) {
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return ext != ".png" && ext != ".jpg" && ext != ".jpeg" && ext != ".bin" && ext != ".pak";
+	}
+
+	void collect(const fs::path& input, std::vector<fs::path>& files) {
+		std::error_code ec;
+		if (fs::is_regular_file(input, ec)) {
+			files.push_back(input);
+			return;
+		}
+		if (!fs::is_directory(input, ec)) {
+			std::fprintf(stderr, "pack_assets: skipping %s (not found)\n", input.string().c_str());
+			return;
+		}
+		for (const fs::directory_entry& e : fs::recursive_directory_iterator(input, ec)) {
+			if (e.is_regular_file()) files.push_back(e.path());
+		}
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	std::string output;
+	std::vector<fs::path> inputs;
+	std::uint32_t alignment = 16;
+	bool store = false;
+	for (int i = 1; i < argc; ++i) {
+		const std::string a = argv[i];
+		if (a == "--align" && i + 1 < argc) alignment = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if (a == "--store") store = true;
+		else if (output.empty()) output = a;
+		else inputs.emplace_back(a);
+	}
+	if (output.empty() || inputs.empty() || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+		std::fprintf(stderr, "usage: pack_assets <output.pak> <dir or file>... [--align N] [--store]\n");
+		return 1;
+	}
+
+	std::vector<fs::path> files;
+	for (const fs::path& input : inputs) collect(input, files);
+	std::sort(files.begin(), files.end());
+	files.erase(std::unique(files.begin(), files.end()), files.end());
+	std::error_code ec;
+	files.erase(std::remove_if(files.begin(), files.end(),
+		[&](const fs::path& file) { return fs::equivalent(file, output, ec); }), files.end());   // a previous archive inside an input
+
+	PackWriter writer(alignment);
+	std::vector<std::string> names;
+	for (const fs::path& file : files) {
+		std::vector<unsigned char> data;
+		if (!read_file(file, data)) {
+			std::fprintf(stderr, "pack_assets: cannot read %s\n", file.string().c_str());
+			return 1;
+		}
+		const std::string name = PackFile::NormalizePath(file.lexically_normal().generic_string());
+		writer.Add(name, std::move(data), !store && worth_compressing(file));
+		names.push_back(name);
+	}
+
+	std::string error;
+	if (!writer.Write(output, &error)) {
+		std::fprintf(stderr, "pack_assets: %s\n", error.c_str());
+		return 1;
+	}
+
+	// Read everything back through the runtime reader
+	int failures = 0;
+	PackFile pack;
+	if (!pack.Open(output)) {
+		std::fprintf(stderr, "pack_assets: cannot open %s after writing it\n", output.c_str());
+		return 1;
+	}
+	std::size_t compressed = 0;
+	for (std::size_t i = 0; i < files.size(); ++i) {
+		std::vector<unsigned char> source, scratch;
+		std::span<const unsigned char> packed;
+		const PackEntry* entry = pack.Find(names[i]);
+		const bool ok = entry && read_file(files[i], source) && pack.Read(*entry, scratch, packed)
+			&& packed.size() == source.size() && std::equal(packed.begin(), packed.end(), source.begin())
+			&& entry->offset % alignment == 0;
+		if (!ok) {
+			std::fprintf(stderr, "pack_assets: %s does not read back intact\n", names[i].c_str());
+			++failures;
+		}
+		if (entry && (entry->flags & PackFlags::Lz4)) ++compressed;
+	}
+
+	std::printf("pack_assets: %s: %zu files (%zu compressed), %.1f KB -> %.1f KB stored, %.1f KB on disk\n",
+		output.c_str(), writer.GetEntryCount(), compressed, writer.GetRawBytes() / 1024.0,
+		writer.GetStoredBytes() / 1024.0, fs::file_size(output) / 1024.0);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/*
+===============================================================================
+ telemetry_client.cpp
+ ------------------------------------------------------------------------------
+ Minimal command-line viewer for the engine's Telemetry stream.
+
+ What it does
+   - Connects to 127.0.0.1:<port> (default 7777).
+   - Parses "H ..." (category names) and "F ..." (one frame) lines.
+   - Keeps the last <window> frames (default 120) and redraws a small table
+	 twice per second: frame time avg/max, FPS, RSS, dropped packets, and the
+	 average ms per category.
+   - With --raw it just echoes every line, which is handy for recording:
+		telemetry_client 7777 --raw > soak.txt
+
+ Usage
+   telemetry_client [port] [--window N] [--raw]
+===============================================================================
+*/
+
+namespace {
+
+	struct Frame {
+		unsigned long long index = 0;
+		double frameMs = 0.0;
+		double fps = 0.0;
+		unsigned long long rssKb = 0;
+		unsigned long long drops = 0;
+		std::vector<double> catMs;
+	};
+
+	bool parse_frame(const std::string& line, Frame& f) {
+		std::istringstream in(line);
+		char tag = 0;
+		in >> tag >> f.index >> f.frameMs >> f.fps >> f.rssKb >> f.drops;
+		if (!in || tag != 'F') return false;
+		f.catMs.clear();
+		double v;
+		while (in >> v) f.catMs.push_back(v);
+		return true;
+	}
+
+	void draw(const std::deque<Frame>& frames, const std::vector<std::string>& names) {
+		if (frames.empty()) return;
+
+		double sum = 0.0, worst = 0.0;
+		std::vector<double> catSum(names.size(), 0.0);
+		for (const auto& f : frames) {
+			sum += f.frameMs;
+			worst = std::max(worst, f.frameMs);
+			for (size_t i = 0; i < f.catMs.size() && i < catSum.size(); ++i) catSum[i] += f.catMs[i];
+		}
+		const double n = static_cast<double>(frames.size());
+		const Frame& last = frames.back();
+
+		// Clear screen + home cursor, then one compact block.
+		std::printf("\033[H\033[J");
+		std::printf("frame %llu   fps %.1f   rss %.1f MB   drops %llu\n",
+			last.index, last.fps, last.rssKb / 1024.0, last.drops);
+		std::printf("frame ms  avg %.3f   max %.3f   (last %zu frames)\n\n",
+			sum / n, worst, frames.size());
+		std::printf("%-16s %10s %8s\n", "category", "avg ms", "%");
+		for (size_t i = 0; i < names.size(); ++i) {
+			const double avg = catSum[i] / n;
+			if (avg <= 0.0) continue;
+			std::printf("%-16s %10.3f %7.1f%%\n", names[i].c_str(), avg, (sum > 0.0) ? catSum[i] / sum * 100.0 : 0.0);
+		}
+		std::fflush(stdout);
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned port = 7777;
+	size_t window = 120;
+	bool raw = false;
+	for (int i = 1; i < argc; ++i) {
+		const std::string a = argv[i];
+		if (a == "--raw") raw = true;
+		else if (a == "--window" && i + 1 < argc) window = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+		else port = static_cast<unsigned>(std::strtoul(argv[i], nullptr, 10));
+	}
+
+#if defined(_WIN32)
+	WSADATA wsa;
+	WSAStartup(MAKEWORD(2, 2), &wsa);
+	SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#else
+	int s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#endif
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(static_cast<unsigned short>(port));
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		std::fprintf(stderr, "telemetry_client: cannot connect to 127.0.0.1:%u\n", port);
+		return 1;
+	}
+
+	std::vector<std::string> names;
+	std::deque<Frame> frames;
+	std::string pending;
+	auto lastDraw = std::chrono::steady_clock::now();
+	char buf[16 * 1024];
+
+	for (;;) {
+		const int n = static_cast<int>(recv(s, buf, sizeof(buf), 0));
+		if (n <= 0) break;
+		pending.append(buf, static_cast<size_t>(n));
+
+		// Process complete lines only; keep the partial tail for next time.
+		size_t start = 0, nl;
+		while ((nl = pending.find('\n', start)) != std::string::npos) {
+			const std::string line = pending.substr(start, nl - start);
+			start = nl + 1;
+
+			if (raw) {
+				std::printf("%s\n", line.c_str());
+				continue;
+			}
+			if (!line.empty() && line[0] == 'H') {
+				std::istringstream in(line);
+				std::string tag;
+				int version = 0;
+				size_t count = 0;
+				in >> tag >> version >> count;
+				names.assign(count, std::string());
+				for (auto& nm : names) in >> nm;
+			}
+			else {
+				Frame f;
+				if (parse_frame(line, f)) {
+					frames.push_back(std::move(f));
+					while (frames.size() > window) frames.pop_front();
+				}
+			}
+		}
+		pending.erase(0, start);
+
+		const auto now = std::chrono::steady_clock::now();
+		if (!raw && now - lastDraw >= std::chrono::milliseconds(500)) {
+			draw(frames, names);
+			lastDraw = now;
+		}
+	}
+
+	std::printf("\ntelemetry_client: connection closed\n");
+#if defined(_WIN32)
+	closesocket(s);
+	WSACleanup();
+#else
+	close(s);
+#endif
+	return 0;
+}